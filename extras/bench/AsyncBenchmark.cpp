@@ -0,0 +1,165 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double BUS_NS_PER_PIXEL = 100.0,
+                     RENDER_NS_PER_PIXEL = 100.0;
+    constexpr std::uint16_t STRIP_ROWS = 16;
+
+    [[gnu::noinline]]
+    void spinUntil(Clock::time_point deadline) {
+        while (Clock::now() < deadline);
+    }
+
+    Clock::time_point after(std::size_t pixels, double nsPerPixel) {
+        return Clock::now() + std::chrono::nanoseconds(std::int64_t(pixels * nsPerPixel));
+    }
+
+    /**
+     * A MemoryDriver behind a simulated bus that takes BUS_NS_PER_PIXEL to
+     * move each pixel. Synchronous writes block for that long; asynchronous
+     * writes complete in poll() once the same time has elapsed, leaving the
+     * caller free to render in the meantime.
+     */
+    class SimulatedBusDriver : public MemoryDriver {
+    public:
+        using MemoryDriver::MemoryDriver;
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            Clock::time_point deadline = after(count, BUS_NS_PER_PIXEL);
+            MemoryDriver::writePixels(count, data);
+            spinUntil(deadline);
+            return this;
+        }
+
+        Driver *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                 TransferCallback callback, void *context) override {
+            wait();
+            mDeadline = after(count, BUS_NS_PER_PIXEL);
+            MemoryDriver::writePixels(count, data);
+            mCallback = callback;
+            mContext = context;
+            mPending = true;
+            return this;
+        }
+
+        bool poll() override {
+            if (mPending && Clock::now() >= mDeadline) {
+                mPending = false;
+                if (mCallback) {
+                    mCallback(this, mContext);
+                }
+            }
+            return mPending;
+        }
+
+        using MemoryDriver::writePixels;
+    private:
+        Clock::time_point mDeadline;
+        TransferCallback mCallback = nullptr;
+        void *mContext = nullptr;
+        bool mPending = false;
+    };
+
+    void render(std::uint16_t *strip, std::size_t pixels, std::uint16_t row, std::uint16_t width) {
+        Clock::time_point deadline = after(pixels, RENDER_NS_PER_PIXEL);
+        for (std::size_t i = 0; i < pixels; ++i) {
+            strip[i] = std::uint16_t((row + i / width) * 31 + i % width);
+        }
+        spinUntil(deadline);
+    }
+
+    bool verify(const std::vector<std::uint16_t> &gram, Size size) {
+        for (std::size_t i = 0; i < gram.size(); ++i) {
+            if (gram[i] != std::uint16_t((i / size.width) * 31 + i % size.width)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    std::printf("%-9s %12s %12s %12s %12s %8s\n",
+                "size", "render ms", "bus ms", "sync ms", "async ms", "overlap");
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height,
+                    stripPixels = std::size_t(size.width) * STRIP_ROWS;
+        std::vector<std::uint16_t> gram(pixels),
+                                   first(stripPixels),
+                                   second(stripPixels);
+        SimulatedBusDriver driver(size.width, size.height, gram.data());
+        driver.initialize();
+        PixelDoubleBuffer buffer(driver, first.data(), second.data(), stripPixels);
+
+        double sync = measure(reps, [&] {
+            driver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+            for (std::uint16_t row = 0; row < size.height; row += STRIP_ROWS) {
+                std::size_t count = std::size_t(size.width) * std::min<std::uint16_t>(STRIP_ROWS, size.height - row);
+                render(first.data(), count, row, size.width);
+                driver.writePixels(count, first.data());
+            }
+        });
+        bool syncOk = verify(gram, size);
+        std::fill(gram.begin(), gram.end(), 0);
+
+        double async = measure(reps, [&] {
+            driver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+            for (std::uint16_t row = 0; row < size.height; row += STRIP_ROWS) {
+                std::size_t count = std::size_t(size.width) * std::min<std::uint16_t>(STRIP_ROWS, size.height - row);
+                render(buffer.acquire(), count, row, size.width);
+                buffer.submit(count);
+            }
+            buffer.finish();
+        });
+        bool asyncOk = verify(gram, size);
+
+        double renderMs = pixels * RENDER_NS_PER_PIXEL / 1e6,
+               busMs = pixels * BUS_NS_PER_PIXEL / 1e6,
+               hidden = (sync - async) / 1e6 / std::min(renderMs, busMs);
+        char label[16];
+        std::snprintf(label, sizeof(label), "%ux%u", unsigned(size.width), unsigned(size.height));
+        std::printf("%-9s %12.3f %12.3f %12.3f %12.3f %7.1f%%%s\n",
+                    label, renderMs, busMs, sync / 1e6, async / 1e6, hidden * 100,
+                    syncOk && asyncOk ? "" : "  MISMATCH");
+    }
+    return 0;
+}
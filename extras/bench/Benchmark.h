@@ -0,0 +1,127 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Bench_Benchmark_h__
+#define __Kempozer_Screen_Bench_Benchmark_h__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Kempozer::Screen::Bench {
+
+    /**
+     * A screen size that the benchmarks are run against.
+     */
+    struct Size {
+        std::uint16_t width;
+        std::uint16_t height;
+    };
+
+    /**
+     * The screen sizes that the benchmarks are run against by default.
+     */
+    inline constexpr Size SIZES[] = {
+        {320, 240},
+        {480, 320},
+        {800, 480},
+    };
+
+    /**
+     * A single benchmark measurement. All costs are expressed per unit, where
+     * a unit is whatever the benchmark names it (usually a pixel).
+     */
+    struct Result {
+        const char *name;
+        const char *unit;
+        Size size;
+        double nsPerUnit;
+        double callsPerUnit;
+        double bytesPerUnit;
+    };
+
+    /**
+     * Parses the number of repetitions from the command line, defaulting to 5.
+     *
+     * @param argc
+     * @param argv
+     * @return
+     */
+    inline int repetitions(int argc, char **argv) {
+        int reps = argc > 1 ? std::atoi(argv[1]) : 0;
+        return reps > 0 ? reps : 5;
+    }
+
+    /**
+     * Runs body once to warm up, then reps more times, and returns the fastest
+     * run in nanoseconds.
+     *
+     * @tparam F
+     * @param reps
+     * @param body
+     * @return
+     */
+    template<typename F>
+    double measure(int reps, F &&body) {
+        using Clock = std::chrono::steady_clock;
+        body();
+        double best = 0;
+        for (int i = 0; i < reps; ++i) {
+            auto start = Clock::now();
+            body();
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            best = i == 0 ? ns : std::min(best, ns);
+        }
+        return best;
+    }
+
+    /**
+     * Prints the table header matching {@link print(const Result &)}.
+     */
+    inline void printHeader() {
+        std::printf("%-28s %-9s %-8s %12s %12s %12s\n",
+                    "benchmark", "size", "unit", "ns/unit", "calls/unit", "bytes/unit");
+    }
+
+    /**
+     * Prints a single result as a row of the table.
+     *
+     * @param result
+     */
+    inline void print(const Result &result) {
+        char size[16];
+        std::snprintf(size, sizeof(size), "%ux%u", unsigned(result.size.width), unsigned(result.size.height));
+        std::printf("%-28s %-9s %-8s %12.3f %12.3f %12.3f\n",
+                    result.name, size, result.unit,
+                    result.nsPerUnit, result.callsPerUnit, result.bytesPerUnit);
+    }
+}
+
+#endif//__Kempozer_Screen_Bench_Benchmark_h__
@@ -0,0 +1,138 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::uint16_t KEY = 0xF81F;
+
+    /**
+     * The per-pixel loops that the blit module replaces. Every destination
+     * pixel is bounds checked and computed on its own.
+     */
+    namespace Naive {
+        void rotate(const Surface &target, const ConstSurface &source, int rotation) {
+            for (std::uint16_t sy = 0; sy < source.height; ++sy) {
+                for (std::uint16_t sx = 0; sx < source.width; ++sx) {
+                    std::int32_t x, y;
+                    switch (rotation) {
+                        case 1: x = source.height - 1 - sy; y = sx; break;
+                        case 2: x = source.width - 1 - sx; y = source.height - 1 - sy; break;
+                        case 3: x = sy; y = source.width - 1 - sx; break;
+                        default: x = sx; y = sy; break;
+                    }
+                    if (x >= 0 && y >= 0 && x < target.width && y < target.height) {
+                        target.pixels[std::size_t(y) * target.stride + x] = source.pixels[std::size_t(sy) * source.stride + sx];
+                    }
+                }
+            }
+        }
+
+        void keyed(const Surface &target, const ConstSurface &source) {
+            for (std::uint16_t y = 0; y < source.height && y < target.height; ++y) {
+                for (std::uint16_t x = 0; x < source.width && x < target.width; ++x) {
+                    std::uint16_t color = source.pixels[std::size_t(y) * source.stride + x];
+                    if (color != KEY) {
+                        target.pixels[std::size_t(y) * target.stride + x] = color;
+                    }
+                }
+            }
+        }
+
+        void masked(const Surface &target, const ConstSurface &source, const std::uint8_t *mask, std::size_t maskStride) {
+            for (std::uint16_t y = 0; y < source.height && y < target.height; ++y) {
+                for (std::uint16_t x = 0; x < source.width && x < target.width; ++x) {
+                    if (mask[y * maskStride + x / 8] & (0x80 >> (x % 8))) {
+                        target.pixels[std::size_t(y) * target.stride + x] = source.pixels[std::size_t(y) * source.stride + x];
+                    }
+                }
+            }
+        }
+
+        void blended(const Surface &target, const ConstSurface &source, const std::uint8_t *alpha, std::size_t alphaStride) {
+            for (std::uint16_t y = 0; y < source.height && y < target.height; ++y) {
+                for (std::uint16_t x = 0; x < source.width && x < target.width; ++x) {
+                    std::uint16_t &out = target.pixels[std::size_t(y) * target.stride + x];
+                    out = blendAlpha8(source.pixels[std::size_t(y) * source.stride + x], out, alpha[y * alphaStride + x]);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height,
+                    maskStride = (size.width + 7) / 8;
+        std::vector<std::uint16_t> sourcePixels(pixels), targetPixels(pixels);
+        std::vector<std::uint8_t> mask(maskStride * size.height), alpha(pixels);
+        std::uint32_t seed = 12345;
+        for (std::size_t i = 0; i < pixels; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            sourcePixels[i] = (seed >> 24) < 64 ? KEY : std::uint16_t(seed >> 8);
+            alpha[i] = std::uint8_t(seed >> 16);
+        }
+        for (std::uint8_t &bits : mask) {
+            seed = seed * 1664525u + 1013904223u;
+            bits = std::uint8_t(seed >> 24);
+        }
+        ConstSurface source{sourcePixels.data(), size.width, size.height, size.width};
+        Surface target{targetPixels.data(), size.width, size.height, size.width},
+                turned{targetPixels.data(), size.height, size.width, size.height};
+
+        auto run = [&](const char *name, auto &&body) {
+            double ns = measure(reps, body);
+            print(Result{name, "pixel", size, ns / pixels, 0, 2});
+        };
+
+        run("naive copy", [&] { Naive::rotate(target, source, 0); });
+        run("blit copy", [&] { blit(target, 0, 0, source); });
+        run("naive rotate 90", [&] { Naive::rotate(turned, source, 1); });
+        run("blit rotate 90", [&] { blitRotated(turned, 0, 0, source, 1); });
+        run("naive rotate 180", [&] { Naive::rotate(target, source, 2); });
+        run("blit rotate 180", [&] { blitRotated(target, 0, 0, source, 2); });
+        run("naive rotate 270", [&] { Naive::rotate(turned, source, 3); });
+        run("blit rotate 270", [&] { blitRotated(turned, 0, 0, source, 3); });
+        run("naive color key", [&] { Naive::keyed(target, source); });
+        run("blit color key", [&] { blitKeyed(target, 0, 0, source, KEY); });
+        run("naive 1-bit mask", [&] { Naive::masked(target, source, mask.data(), maskStride); });
+        run("blit 1-bit mask", [&] { blitMasked(target, 0, 0, source, mask.data(), maskStride); });
+        run("naive 8-bit alpha", [&] { Naive::blended(target, source, alpha.data(), size.width); });
+        run("blit 8-bit alpha", [&] { blitBlended(target, 0, 0, source, alpha.data(), size.width); });
+    }
+    return 0;
+}
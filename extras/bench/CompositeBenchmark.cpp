@@ -0,0 +1,149 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The time a 32 MHz SPI bus takes to move one RGB565 pixel.
+     */
+    constexpr std::chrono::nanoseconds BUS_PER_PIXEL(500);
+
+    /**
+     * The panel sizes of the walls that are measured; they are kept small
+     * since every pixel costs real time on the simulated bus.
+     */
+    constexpr Size PANELS[] = {
+        {160, 128},
+        {320, 240},
+    };
+
+    /**
+     * A MemoryDriver behind its own simulated bus. Every transfer blocks the
+     * calling thread for as long as the bus would take to move its pixels,
+     * the way a DMA-backed driver waits for its transfer to complete, so that
+     * panels on separate buses can only go faster by being driven at the
+     * same time.
+     */
+    class SimulatedBusDriver : public MemoryDriver {
+    public:
+        using MemoryDriver::MemoryDriver;
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            Clock::time_point start = Clock::now();
+            MemoryDriver::writePixels(count, data);
+            if (!mFilling) {
+                std::this_thread::sleep_until(start + BUS_PER_PIXEL * count);
+            }
+            return this;
+        }
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override {
+            // The default fill goes through writePixels in chunks, which must
+            // not be charged a second time.
+            Clock::time_point start = Clock::now();
+            mFilling = true;
+            MemoryDriver::writeRepeatedPixel(count, color);
+            mFilling = false;
+            std::this_thread::sleep_until(start + BUS_PER_PIXEL * count);
+            return this;
+        }
+
+        using MemoryDriver::writePixels;
+    private:
+        bool mFilling = false;
+    };
+
+    /**
+     * A wall of columns by rows panels of one size, with their memory.
+     */
+    struct Wall {
+        std::vector<std::vector<std::uint16_t>> grams;
+        std::vector<std::unique_ptr<SimulatedBusDriver>> panels;
+        std::vector<Driver *> pointers;
+        std::unique_ptr<CompositeDriver> driver;
+
+        Wall(Size panel, std::uint8_t columns, std::uint8_t rows) {
+            for (std::size_t i = 0; i < std::size_t(columns) * rows; ++i) {
+                grams.emplace_back(std::size_t(panel.width) * panel.height);
+                panels.emplace_back(new SimulatedBusDriver(panel.width, panel.height, grams.back().data()));
+                pointers.push_back(panels.back().get());
+            }
+            driver.reset(new CompositeDriver(pointers.data(), columns, rows));
+        }
+    };
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : PANELS) {
+        for (std::uint8_t columns : {1, 2}) {
+            Wall wall(size, columns, 2);
+            Driver &driver = *wall.driver;
+            std::uint16_t width, height;
+            driver.resolution(width, height);
+            std::size_t pixels = std::size_t(width) * height;
+            std::vector<std::uint16_t> frame(pixels);
+            for (std::size_t i = 0; i < pixels; ++i) {
+                frame[i] = std::uint16_t(i * 2654435761u);
+            }
+            for (bool concurrent : {false, true}) {
+                wall.driver->concurrent(concurrent);
+                char name[32];
+                std::snprintf(name, sizeof(name), "%ux2 %s frame", unsigned(columns),
+                              concurrent ? "concurrent" : "serial");
+                double ns = measure(reps, [&] {
+                    driver.setAddressWindow(0, 0, width - 1, height - 1);
+                    driver.writePixels(pixels, frame.data());
+                });
+                print(Result{name, "pixel", size, ns / pixels, 0, 2});
+                std::snprintf(name, sizeof(name), "%ux2 %s fill", unsigned(columns),
+                              concurrent ? "concurrent" : "serial");
+                ns = measure(reps, [&] {
+                    driver.setAddressWindow(0, 0, width - 1, height - 1);
+                    driver.writeRepeatedPixel(pixels, 0xF800);
+                });
+                print(Result{name, "pixel", size, ns / pixels, 0, 2});
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "FramebufferDriver.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::uint8_t CELL_WIDTH = 8,
+                           CELL_HEIGHT = 16;
+    constexpr std::uint16_t CARD_WIDTH = 152,
+                            CARD_HEIGHT = 40,
+                            ICON = 24;
+    constexpr std::size_t CAPACITY = 512;
+
+    /**
+     * A synthetic printable ASCII font with pseudo-random 6x12 glyphs in
+     * 8x16 cells, standing in for a real converted font.
+     */
+    struct SyntheticFont {
+        std::vector<std::uint8_t> bitmap;
+        std::vector<Glyph> glyphs;
+        Font font;
+
+        SyntheticFont() {
+            std::uint32_t seed = 0x9E3779B9u;
+            for (std::uint16_t c = 32; c < 127; ++c) {
+                glyphs.push_back(Glyph{std::uint32_t(bitmap.size()), 6, 12, CELL_WIDTH, 1, 2});
+                for (std::size_t i = 0; i < (6 * 12 + 7) / 8; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    bitmap.push_back(std::uint8_t(seed >> 24));
+                }
+            }
+            font = Font{bitmap.data(), glyphs.data(), 32, 126, CELL_HEIGHT, 1};
+        }
+    };
+
+    /**
+     * A dashboard of cards, each with a background, an icon, a title and a
+     * value, filling the screen.
+     */
+    struct Dashboard {
+        std::vector<std::string> titles,
+                                 values;
+        std::vector<std::uint16_t> icon;
+        std::uint16_t columns,
+                      rows;
+
+        explicit Dashboard(const Size &size)
+            : icon(std::size_t(ICON) * ICON) {
+            columns = size.width / (CARD_WIDTH + 8);
+            rows = size.height / (CARD_HEIGHT + 8);
+            for (std::size_t i = 0; i < std::size_t(columns) * rows; ++i) {
+                titles.push_back("Sensor " + std::to_string(i));
+                values.push_back(std::to_string(i * 7 % 100) + ".0 C");
+            }
+            for (std::size_t i = 0; i < icon.size(); ++i) {
+                icon[i] = std::uint16_t(i * 2654435761u);
+            }
+        }
+
+        /**
+         * Updates changes values, spread over the dashboard.
+         */
+        void tick(std::size_t changes, std::size_t frame) {
+            for (std::size_t i = 0; i < changes; ++i) {
+                std::size_t card = (frame * 7 + i * 13) % values.size();
+                values[card] = std::to_string((frame + card) % 100) + "." + std::to_string(i % 10) + " C";
+            }
+        }
+
+        template<typename Target>
+        void draw(Target &target, const Font &font) {
+            for (std::uint16_t row = 0; row < rows; ++row) {
+                for (std::uint16_t column = 0; column < columns; ++column) {
+                    std::size_t card = std::size_t(row) * columns + column;
+                    std::int16_t x = std::int16_t(4 + column * (CARD_WIDTH + 8)),
+                                 y = std::int16_t(4 + row * (CARD_HEIGHT + 8));
+                    target.fillRect(Rect{std::uint16_t(x), std::uint16_t(y),
+                                         std::uint16_t(x + CARD_WIDTH - 1), std::uint16_t(y + CARD_HEIGHT - 1)},
+                                    0x2104);
+                    target.bitmap(std::int16_t(x + 8), std::int16_t(y + 8), ICON, ICON, icon.data());
+                    target.text(font, std::int16_t(x + 40), std::int16_t(y + 4), titles[card].c_str(),
+                                0xFFFF, 0x2104);
+                    target.text(font, std::int16_t(x + 40), std::int16_t(y + 20), values[card].c_str(),
+                                0x07E0, 0x2104);
+                }
+            }
+        }
+    };
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    SyntheticFont synthetic;
+    printHeader();
+    for (const Size &size : SIZES) {
+        std::vector<std::uint16_t> gram(std::size_t(size.width) * size.height),
+                                   tile(std::size_t(size.width) * 16);
+        std::vector<TiledRenderer::Primitive> primitives(CAPACITY);
+        FramebufferDriver driver(size.width, size.height, gram.data());
+        TiledRenderer renderer(driver, size.width, size.height, tile.data(), size.width, 16,
+                               primitives.data(), CAPACITY);
+        StaticDisplayList<CAPACITY> list(renderer);
+        Dashboard dashboard(size);
+        std::size_t frame = 0;
+
+        auto run = [&](const char *name, auto &&body) {
+            double ns = measure(reps, body);
+            driver.mCalls = 0;
+            driver.mFramebuffer.bytes = 0;
+            body();
+            print(Result{name, "frame", size, ns, double(driver.mCalls), double(driver.mFramebuffer.bytes)});
+        };
+
+        run("full redraw", [&] {
+            dashboard.tick(1, ++frame);
+            renderer.clear();
+            dashboard.draw(renderer, synthetic.font);
+            renderer.render();
+        });
+        for (std::size_t changes : {0, 1, 8}) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "display list %zu changed", changes);
+            run(name, [&] {
+                dashboard.tick(changes, ++frame);
+                list.begin();
+                dashboard.draw(list, synthetic.font);
+                list.present();
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    enum class Nop : std::uint8_t {
+        NOP = 0x00,
+    };
+
+    /**
+     * Times body against driver, then runs it once more with fresh counters
+     * to attribute virtual calls and bytes to each unit.
+     */
+    template<typename F>
+    Result run(const char *name, const char *unit, Size size, std::size_t units,
+               MemoryDriver &driver, int reps, F &&body) {
+        double ns = measure(reps, body);
+        driver.resetCounters();
+        body();
+        const MemoryDriver::Counters &counters = driver.counters();
+        return Result{
+            name, unit, size,
+            ns / units,
+            double(counters.virtualCalls) / units,
+            double(counters.bytesWritten + counters.bytesRead) / units,
+        };
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height;
+        std::uint16_t x2 = size.width - 1,
+                      y2 = size.height - 1;
+        std::vector<std::uint16_t> gram(pixels),
+                                   pixelData(pixels),
+                                   readback(pixels);
+        std::vector<std::uint8_t> byteData(pixels * 2);
+        for (std::size_t i = 0; i < pixels; ++i) {
+            pixelData[i] = std::uint16_t(i * 2654435761u);
+            byteData[i * 2] = std::uint8_t(pixelData[i] >> 8);
+            byteData[i * 2 + 1] = std::uint8_t(pixelData[i]);
+        }
+
+        std::uint32_t checksum = 0;
+        MemoryDriver driver(size.width, size.height, gram.data());
+        driver.initialize();
+
+        print(run("writePixel", "pixel", size, pixels, driver, reps, [&] {
+            driver.setAddressWindow(0, 0, x2, y2);
+            for (std::size_t i = 0; i < pixels; ++i) {
+                driver.writePixel(pixelData[i]);
+            }
+        }));
+        print(run("writePixels", "pixel", size, pixels, driver, reps, [&] {
+            driver.setAddressWindow(0, 0, x2, y2);
+            driver.writePixels(pixels, pixelData.data());
+        }));
+        print(run("writeRepeatedPixel", "pixel", size, pixels, driver, reps, [&] {
+            driver.setAddressWindow(0, 0, x2, y2);
+            driver.writeRepeatedPixel(pixels, 0xF800);
+        }));
+        print(run("writeArray", "pixel", size, pixels, driver, reps, [&] {
+            driver.setAddressWindow(0, 0, x2, y2);
+            driver.writeArray(byteData.size(), byteData.data());
+        }));
+        print(run("readPixels", "pixel", size, pixels, driver, reps, [&] {
+            driver.setAddressWindow(0, 0, x2, y2);
+            driver.readPixels(pixels, readback.data());
+        }));
+        print(run("readRegion", "pixel", size, pixels, driver, reps, [&] {
+            driver.readRegion(0, 0, x2, y2, readback.data());
+        }));
+        print(run("readRegion streamed", "pixel", size, pixels, driver, reps, [&] {
+            driver.readRegion(0, 0, x2, y2, readback.data(), 256,
+                              [](Driver *, void *context, const std::uint16_t *chunk, std::size_t count) {
+                                  *static_cast<std::uint32_t *>(context) += chunk[count - 1];
+                              }, &checksum);
+        }));
+        print(run("CommandBuffer writePixels", "pixel", size, pixels, driver, reps, [&] {
+            const std::uint8_t columns[] = {0, 0, std::uint8_t(x2 >> 8), std::uint8_t(x2)},
+                               rows[] = {0, 0, std::uint8_t(y2 >> 8), std::uint8_t(y2)};
+            StaticCommandBuffer<4096> buffer(driver);
+            buffer.command(MemoryDriver::Command::CASET)->writeArray(4, columns)
+                  ->command(MemoryDriver::Command::PASET)->writeArray(4, rows)
+                  ->command(MemoryDriver::Command::RAMWR)->writePixels(pixels, pixelData.data());
+        }));
+        print(run("writeCommand", "command", size, pixels, driver, reps, [&] {
+            for (std::size_t i = 0; i < pixels; ++i) {
+                driver.writeCommand(Nop::NOP);
+            }
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::uint32_t FRAMES = 60;
+
+    /**
+     * Renders frame index of an animation: a sprite bouncing over a static
+     * gradient, and a progress bar growing along the bottom.
+     */
+    void animation(Size size, std::uint32_t index, std::uint16_t *pixels) {
+        for (std::uint16_t y = 0; y < size.height; ++y) {
+            for (std::uint16_t x = 0; x < size.width; ++x) {
+                pixels[std::size_t(y) * size.width + x] = std::uint16_t((x * 31 / size.width) << 11
+                                                                        | (y * 63 / size.height) << 5 | 8);
+            }
+        }
+        std::uint16_t side = size.height / 6;
+        std::uint32_t travel = size.width - side;
+        std::uint32_t step = index * 7 % (2 * travel);
+        std::uint16_t left = std::uint16_t(step < travel ? step : 2 * travel - step),
+                      top = std::uint16_t(size.height / 3 + index % 8);
+        for (std::uint16_t y = top; y < top + side; ++y) {
+            for (std::uint16_t x = left; x < left + side; ++x) {
+                pixels[std::size_t(y) * size.width + x] = ((x - left) ^ (y - top)) & 8 ? 0xFFE0 : 0xF800;
+            }
+        }
+        std::uint16_t bar = std::uint16_t(std::uint32_t(size.width) * (index + 1) / FRAMES);
+        for (std::uint16_t y = size.height - 8; y < size.height; ++y) {
+            for (std::uint16_t x = 0; x < bar; ++x) {
+                pixels[std::size_t(y) * size.width + x] = 0x07FF;
+            }
+        }
+    }
+
+    void run(int reps, Size size) {
+        std::size_t count = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> frames(count * FRAMES), gram(count);
+        for (std::uint32_t i = 0; i < FRAMES; ++i) {
+            animation(size, i, frames.data() + i * count);
+        }
+
+        std::vector<std::uint8_t> stream(FrameStream::HEADER_SIZE);
+        FrameStream::writeHeader(stream.data(), stream.size(), size.width, size.height, FRAMES, 0);
+        for (std::uint32_t i = 0; i < FRAMES; ++i) {
+            std::size_t offset = stream.size();
+            stream.resize(offset + 4 * count + 1024);
+            std::size_t encoded = FrameStream::encodeFrame(i ? frames.data() + (i - 1) * count : nullptr,
+                                                           frames.data() + i * count, size.width, size.height,
+                                                           32, stream.data() + offset, stream.size() - offset);
+            stream.resize(offset + encoded);
+        }
+
+        MemoryDriver driver(size.width, size.height, gram.data());
+        driver.initialize();
+        auto report = [&](const char *name, double ns) {
+            print(Result{name, "frame", size, ns / FRAMES, double(driver.counters().virtualCalls) / FRAMES,
+                         double(driver.counters().bytesWritten) / FRAMES});
+            std::printf("# %s %.1f fps\n", name, FRAMES * 1e9 / ns);
+        };
+
+        auto full = [&] {
+            driver.select();
+            for (std::uint32_t i = 0; i < FRAMES; ++i) {
+                driver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+                driver.writePixels(count, frames.data() + i * count);
+            }
+            driver.deselect();
+        };
+        double ns = measure(reps, full);
+        driver.resetCounters();
+        full();
+        report("full frames", ns);
+
+        FrameStream frameStream(stream.data(), stream.size());
+        FramePlayer player(driver, frameStream);
+        auto delta = [&] {
+            player.rewind();
+            driver.select();
+            while (player.next());
+            driver.deselect();
+        };
+        ns = measure(reps, delta);
+        driver.resetCounters();
+        player.resetStatistics();
+        delta();
+        report("delta stream", ns);
+        bool equal = std::equal(gram.begin(), gram.end(), frames.end() - count);
+        std::printf("# %zu stream bytes per frame of %zu raw, %u rectangles, last frame %s\n",
+                    std::size_t(player.bytesPerFrame()), count * 2, unsigned(player.statistics().rects),
+                    equal ? "matches" : "DIFFERS");
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        run(reps, size);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Bench_FramebufferDriver_h__
+#define __Kempozer_Screen_Bench_FramebufferDriver_h__
+
+#include <cstdint>
+#include "KempozerScreen.h"
+
+namespace Kempozer::Screen::Bench {
+
+    /**
+     * The pixel-pushing core shared by the benchmark stand-ins: writes land in
+     * a framebuffer at an auto-incrementing address within the current window.
+     */
+    struct Framebuffer {
+        std::uint16_t *gram;
+        std::uint16_t stride;
+        std::uint16_t x1, y1, x2, y2, column, row;
+        std::uint64_t bytes;
+
+        [[gnu::always_inline]]
+        inline void window(std::uint16_t wx1, std::uint16_t wy1, std::uint16_t wx2, std::uint16_t wy2) {
+            x1 = column = wx1;
+            y1 = row = wy1;
+            x2 = wx2;
+            y2 = wy2;
+            bytes += 11;
+        }
+
+        [[gnu::always_inline]]
+        inline void pixel(std::uint16_t color) {
+            gram[std::size_t(row) * stride + column] = color;
+            bytes += 2;
+            if (column < x2) {
+                ++column;
+            } else {
+                column = x1;
+                row = row < y2 ? row + 1 : y1;
+            }
+        }
+    };
+
+    /**
+     * A virtual driver over a {@link Framebuffer} whose bulk methods are
+     * overridden with tight loops, as a DMA-capable driver's would be, and
+     * which counts every virtual call made to it.
+     */
+    class FramebufferDriver : public Driver {
+    public:
+        FramebufferDriver(std::uint16_t width, std::uint16_t height, std::uint16_t *gram)
+            : Driver(width, height), mFramebuffer{gram, width, 0, 0, 0, 0, 0, 0, 0} {}
+
+        bool initialize() override { ++mCalls; return true; }
+        Driver *select() override { ++mCalls; return this; }
+        Driver *deselect() override { ++mCalls; return this; }
+        Driver *assertCommand() override { ++mCalls; return this; }
+        Driver *deassertCommand() override { ++mCalls; return this; }
+
+        Driver *writePixel(std::uint16_t color) override {
+            ++mCalls;
+            mFramebuffer.pixel(color);
+            return this;
+        }
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            ++mCalls;
+            for (std::size_t i = 0; i < count; ++i) {
+                mFramebuffer.pixel(data[i]);
+            }
+            return this;
+        }
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override {
+            ++mCalls;
+            for (std::size_t i = 0; i < count; ++i) {
+                mFramebuffer.pixel(color);
+            }
+            return this;
+        }
+
+        Driver *write(std::uint8_t) override {
+            ++mCalls;
+            ++mFramebuffer.bytes;
+            return this;
+        }
+
+        std::uint16_t readPixel() override { ++mCalls; return 0; }
+        std::uint8_t read() override { ++mCalls; return 0; }
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override {
+            ++mCalls;
+            x1 = mFramebuffer.x1;
+            y1 = mFramebuffer.y1;
+            x2 = mFramebuffer.x2;
+            y2 = mFramebuffer.y2;
+            return this;
+        }
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override {
+            ++mCalls;
+            mFramebuffer.window(x1, y1, x2, y2);
+            return this;
+        }
+
+
+        using Driver::writePixels;
+
+        Framebuffer mFramebuffer;
+        std::uint64_t mCalls = 0;
+    };
+}
+
+#endif//__Kempozer_Screen_Bench_FramebufferDriver_h__
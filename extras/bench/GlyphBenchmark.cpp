@@ -0,0 +1,155 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+#include "FramebufferDriver.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::uint8_t CELL_WIDTH = 8,
+                           CELL_HEIGHT = 16;
+
+    /**
+     * A synthetic printable ASCII font with pseudo-random 6x12 glyphs in
+     * 8x16 cells, standing in for a real converted font.
+     */
+    struct SyntheticFont {
+        std::vector<std::uint8_t> bitmap;
+        std::vector<Glyph> glyphs;
+        Font font;
+
+        explicit SyntheticFont(std::uint8_t bitsPerPixel) {
+            std::uint32_t seed = 0x9E3779B9u * bitsPerPixel;
+            std::size_t glyphBytes = (6 * 12 * bitsPerPixel + 7) / 8;
+            for (std::uint16_t c = 32; c < 127; ++c) {
+                glyphs.push_back(Glyph{std::uint32_t(bitmap.size()), 6, 12, CELL_WIDTH, 1, 2});
+                for (std::size_t i = 0; i < glyphBytes; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    bitmap.push_back(std::uint8_t(seed >> 24));
+                }
+            }
+            font = Font{bitmap.data(), glyphs.data(), 32, 126, CELL_HEIGHT, bitsPerPixel};
+        }
+    };
+
+    /**
+     * Draws text the way a library without bulk transfers would: one window
+     * per glyph, then one writePixel per pixel of the cell.
+     */
+    void drawTextPerPixel(Driver &driver, const Font &font, std::int16_t x, std::int16_t y,
+                          const char *text, std::uint16_t foreground, std::uint16_t background) {
+        std::uint16_t row[256];
+        std::int16_t column = x;
+        for (; *text; ++text) {
+            if (*text == '\n') {
+                column = x;
+                y += font.height;
+                continue;
+            }
+            const Glyph *glyph = font.glyph(std::uint8_t(*text));
+            if (!glyph) {
+                continue;
+            }
+            driver.setAddressWindow(column, y, column + glyph->advance - 1, y + font.height - 1);
+            for (std::uint16_t r = 0; r < font.height; ++r) {
+                rasterizeGlyph(font, *glyph, foreground, background, r, 1, row);
+                for (std::uint16_t i = 0; i < glyph->advance; ++i) {
+                    driver.writePixel(row[i]);
+                }
+            }
+            column += glyph->advance;
+        }
+    }
+
+    /**
+     * Builds a screenful of prose, one line per text row.
+     */
+    std::string screenOfText(Size size, std::size_t &glyphs) {
+        static const char WORDS[] = "The quick brown fox jumps over the lazy dog, 0123456789 times! ";
+        std::size_t columns = size.width / CELL_WIDTH,
+                    rows = size.height / CELL_HEIGHT,
+                    next = 0;
+        std::string text;
+        for (std::size_t r = 0; r < rows; ++r) {
+            for (std::size_t c = 0; c < columns; ++c) {
+                text.push_back(WORDS[next++ % (sizeof(WORDS) - 1)]);
+            }
+            text.push_back('\n');
+        }
+        glyphs = columns * rows;
+        return text;
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (std::uint8_t bitsPerPixel : {1, 4}) {
+        SyntheticFont synthetic(bitsPerPixel);
+        const Font &font = synthetic.font;
+        for (const Size &size : SIZES) {
+            std::size_t glyphs;
+            std::string text = screenOfText(size, glyphs);
+            std::vector<std::uint16_t> gram(std::size_t(size.width) * size.height);
+            FramebufferDriver driver(size.width, size.height, gram.data());
+            Canvas canvas(driver);
+            StaticGlyphCache<128, CELL_WIDTH * CELL_HEIGHT> cache;
+
+            auto run = [&](const char *name, auto &&body) {
+                double ns = measure(reps, body);
+                driver.mCalls = 0;
+                driver.mFramebuffer.bytes = 0;
+                body();
+                print(Result{name, "glyph", size, ns / glyphs,
+                             double(driver.mCalls) / glyphs,
+                             double(driver.mFramebuffer.bytes) / glyphs});
+                std::printf("%-28s %-9s %-8s %12.0f glyphs/s\n", "", "", "", glyphs * 1e9 / ns);
+            };
+
+            run(bitsPerPixel == 1 ? "1bpp per-pixel" : "4bpp per-pixel", [&] {
+                drawTextPerPixel(driver, font, 0, 0, text.c_str(), 0xFFFF, 0x0000);
+            });
+            canvas.glyphCache(nullptr);
+            run(bitsPerPixel == 1 ? "1bpp drawText uncached" : "4bpp drawText uncached", [&] {
+                canvas.drawText(font, 0, 0, text.c_str(), 0xFFFF, 0x0000);
+            });
+            canvas.glyphCache(&cache);
+            run(bitsPerPixel == 1 ? "1bpp drawText cached" : "4bpp drawText cached", [&] {
+                canvas.drawText(font, 0, 0, text.c_str(), 0xFFFF, 0x0000);
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    enum class Command : std::uint8_t {
+        SWRESET = 0x01,
+        SLPOUT = 0x11,
+        GAMSET = 0x26,
+        DISPON = 0x29,
+        MADCTL = 0x36,
+        VSCRSADD = 0x37,
+        COLMOD = 0x3A,
+        FRMCTR1 = 0xB1,
+        DFUNCTR = 0xB6,
+        PWCTR1 = 0xC0,
+        PWCTR2 = 0xC1,
+        VMCTR1 = 0xC5,
+        VMCTR2 = 0xC7,
+        PWCTRA = 0xCB,
+        PWCTRB = 0xCF,
+        GMCTRP1 = 0xE0,
+        GMCTRN1 = 0xE1,
+        DTCTRA = 0xE8,
+        DTCTRB = 0xEA,
+        PWRSEQ = 0xED,
+        ENABLE3G = 0xF2,
+        PUMPCTR = 0xF7,
+    };
+
+    /**
+     * A typical ILI9341 power-on sequence.
+     */
+    constexpr auto INIT = initSequence(
+        initCommand(Command::SWRESET).delay(150),
+        initCommand(Command::PWCTRB, 0x00, 0xC1, 0x30),
+        initCommand(Command::PWRSEQ, 0x64, 0x03, 0x12, 0x81),
+        initCommand(Command::DTCTRA, 0x85, 0x00, 0x78),
+        initCommand(Command::PWCTRA, 0x39, 0x2C, 0x00, 0x34, 0x02),
+        initCommand(Command::PUMPCTR, 0x20),
+        initCommand(Command::DTCTRB, 0x00, 0x00),
+        initCommand(Command::PWCTR1, 0x23),
+        initCommand(Command::PWCTR2, 0x10),
+        initCommand(Command::VMCTR1, 0x3E, 0x28),
+        initCommand(Command::VMCTR2, 0x86),
+        initCommand(Command::MADCTL, 0x48),
+        initCommand(Command::VSCRSADD, 0x00),
+        initCommand(Command::COLMOD, 0x55),
+        initCommand(Command::FRMCTR1, 0x00, 0x18),
+        initCommand(Command::DFUNCTR, 0x08, 0x82, 0x27),
+        initCommand(Command::ENABLE3G, 0x00),
+        initCommand(Command::GAMSET, 0x01),
+        initCommand(Command::GMCTRP1, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+                    0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00),
+        initCommand(Command::GMCTRN1, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+                    0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F),
+        initCommand(Command::SLPOUT).delay(120),
+        initCommand(Command::DISPON).delay(20));
+
+    /**
+     * The same sequence as a hand-written chain of calls.
+     */
+    void writeChain(Driver &driver) {
+        auto send = [&](Command command, std::initializer_list<std::uint8_t> parameters) {
+            driver.writeCommand(command);
+            for (std::uint8_t parameter : parameters) {
+                driver.write(parameter);
+            }
+        };
+        driver.select();
+        send(Command::SWRESET, {});
+        driver.pause(150);
+        send(Command::PWCTRB, {0x00, 0xC1, 0x30});
+        send(Command::PWRSEQ, {0x64, 0x03, 0x12, 0x81});
+        send(Command::DTCTRA, {0x85, 0x00, 0x78});
+        send(Command::PWCTRA, {0x39, 0x2C, 0x00, 0x34, 0x02});
+        send(Command::PUMPCTR, {0x20});
+        send(Command::DTCTRB, {0x00, 0x00});
+        send(Command::PWCTR1, {0x23});
+        send(Command::PWCTR2, {0x10});
+        send(Command::VMCTR1, {0x3E, 0x28});
+        send(Command::VMCTR2, {0x86});
+        send(Command::MADCTL, {0x48});
+        send(Command::VSCRSADD, {0x00});
+        send(Command::COLMOD, {0x55});
+        send(Command::FRMCTR1, {0x00, 0x18});
+        send(Command::DFUNCTR, {0x08, 0x82, 0x27});
+        send(Command::ENABLE3G, {0x00});
+        send(Command::GAMSET, {0x01});
+        send(Command::GMCTRP1, {0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+                                0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00});
+        send(Command::GMCTRN1, {0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+                                0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F});
+        send(Command::SLPOUT, {});
+        driver.pause(120);
+        send(Command::DISPON, {});
+        driver.pause(20);
+        driver.deselect();
+    }
+
+    /**
+     * A driver for a bus with a DMA engine: arrays and submitted batches go
+     * out as one transfer each, while every other call is a separate bus
+     * access. Delays are skipped.
+     */
+    class BatchingDriver : public Driver {
+    public:
+        BatchingDriver()
+            : Driver(240, 320) {}
+
+        bool initialize() override { ++mCalls; return true; }
+        Driver *select() override { ++mCalls; return this; }
+        Driver *deselect() override { ++mCalls; return this; }
+        Driver *assertCommand() override { ++mCalls; return this; }
+        Driver *deassertCommand() override { ++mCalls; return this; }
+        Driver *writePixel(std::uint16_t) override { ++mCalls; mBytes += 2; return this; }
+        Driver *write(std::uint8_t u8) override { ++mCalls; ++mBytes; mSum += u8; return this; }
+        std::uint16_t readPixel() override { ++mCalls; return 0; }
+        std::uint8_t read() override { ++mCalls; return 0; }
+
+        Driver *writeArray(std::size_t count, const std::uint8_t *data) override {
+            ++mCalls;
+            mBytes += count;
+            for (std::size_t i = 0; i < count; ++i) {
+                mSum += data[i];
+            }
+            return this;
+        }
+
+        Driver *submit(std::size_t count, const std::uint8_t *data) override {
+            ++mCalls;
+            CommandBuffer::Record record;
+            while (std::size_t size = CommandBuffer::decode(count, data, record)) {
+                mBytes += record.length;
+                for (std::size_t i = 0; i < record.length; ++i) {
+                    mSum += record.payload[i];
+                }
+                count -= size;
+                data += size;
+            }
+            return this;
+        }
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override {
+            x1 = y1 = x2 = y2 = 0;
+            return this;
+        }
+
+        Driver *setAddressWindow(std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t) override {
+            ++mCalls;
+            return this;
+        }
+
+        Driver *pause(std::uint16_t) override {
+            return this;
+        }
+
+        std::uint64_t mCalls = 0,
+                      mBytes = 0,
+                      mSum = 0;
+    };
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    constexpr Size SIZE{240, 320};
+    std::vector<std::uint16_t> gram(std::size_t(SIZE.width) * SIZE.height);
+    MemoryDriver memory(SIZE.width, SIZE.height, gram.data());
+    BatchingDriver batching;
+    printHeader();
+
+    auto runMemory = [&](const char *name, auto &&body) {
+        double ns = measure(reps, body);
+        memory.resetCounters();
+        body();
+        print(Result{name, "sequence", SIZE, ns, double(memory.counters().virtualCalls),
+                     double(memory.counters().bytesWritten)});
+    };
+    auto runBatching = [&](const char *name, auto &&body) {
+        double ns = measure(reps, body);
+        batching.mCalls = 0;
+        batching.mBytes = 0;
+        body();
+        print(Result{name, "sequence", SIZE, ns, double(batching.mCalls), double(batching.mBytes)});
+    };
+
+    runMemory("chain memory driver", [&] { writeChain(memory); });
+    runMemory("table memory driver", [&] { memory.writeSequence(INIT); });
+    runBatching("chain batching driver", [&] { writeChain(batching); });
+    runBatching("table batching driver", [&] { batching.writeSequence(INIT); });
+    std::printf("# table %zu bytes\n", INIT.size());
+    return 0;
+}
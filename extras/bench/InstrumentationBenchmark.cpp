@@ -0,0 +1,106 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    /**
+     * Draws a dashboard-like frame: a cleared background, a grid of
+     * outlined panels and a pasted bitmap in each.
+     */
+    void drawFrame(Driver &driver, const std::vector<std::uint16_t> &icon, std::uint16_t iconSize) {
+        Canvas canvas(driver);
+        std::uint16_t width, height;
+        driver.resolution(width, height);
+        canvas.clear(0x0000);
+        for (std::uint16_t y = 0; y + 60 <= height; y += 60) {
+            for (std::uint16_t x = 0; x + 80 <= width; x += 80) {
+                canvas.fillRect(std::int16_t(x + 2), std::int16_t(y + 2), 76, 56, 0x18E3);
+                canvas.drawRect(std::int16_t(x + 2), std::int16_t(y + 2), 76, 56, 0xFFFF);
+                driver.setAddressWindow(x + 8, y + 8, x + 8 + iconSize - 1, y + 8 + iconSize - 1);
+                driver.writePixels(icon.size(), icon.data());
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    bool dumpOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        dumpOnly |= std::strcmp(argv[i], "--dump") == 0;
+    }
+    if (!dumpOnly) {
+        printHeader();
+    }
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> gram(pixels),
+                                   icon(32 * 32);
+        for (std::size_t i = 0; i < icon.size(); ++i) {
+            icon[i] = std::uint16_t(i * 2654435761u);
+        }
+        MemoryDriver panel(size.width, size.height, gram.data());
+        panel.initialize();
+        InstrumentedDriver instrumented(panel);
+
+        if (dumpOnly) {
+            instrumented.reset();
+            drawFrame(instrumented.driver(), icon, 32);
+            char dump[4096];
+            instrumented.dump(dump, sizeof(dump));
+            std::printf("# %ux%u\n%s", unsigned(size.width), unsigned(size.height), dump);
+            continue;
+        }
+        double bare = measure(reps, [&] { drawFrame(panel, icon, 32); }),
+               wrapped = measure(reps, [&] { drawFrame(instrumented.driver(), icon, 32); });
+
+        // Both rows do the same driver calls, so count them from one
+        // instrumented frame.
+        instrumented.reset();
+        drawFrame(instrumented.driver(), icon, 32);
+        double calls = 0,
+               bytes = 0;
+        for (std::size_t i = 0; i < std::size_t(Operation::Count); ++i) {
+            const OperationStatistics &statistics = instrumented.statistics(Operation(i));
+            calls += statistics.calls;
+            bytes += double(statistics.bytes);
+        }
+        print(Result{"frame", "pixel", size, bare / pixels, calls / pixels, bytes / pixels});
+        print(Result{"instrumented frame", "pixel", size, wrapped / pixels, calls / pixels, bytes / pixels});
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    /**
+     * A 1bpp panel with a packed frame buffer, such as a memory LCD. RGB565
+     * pixels are thresholded one at a time, while native pixels are copied
+     * eight to a byte.
+     */
+    class MonoDriver : public Driver {
+    public:
+        MonoDriver(std::uint16_t width, std::uint16_t height)
+            : Driver(width, height), mBuffer((std::size_t(width) * height + 7) / 8) {}
+
+        bool initialize() override { ++mCalls; return true; }
+        Driver *select() override { ++mCalls; return this; }
+        Driver *deselect() override { ++mCalls; return this; }
+        Driver *assertCommand() override { ++mCalls; return this; }
+        Driver *deassertCommand() override { ++mCalls; return this; }
+        Driver *write(std::uint8_t) override { ++mCalls; ++mBytes; return this; }
+        std::uint16_t readPixel() override { ++mCalls; return 0; }
+        std::uint8_t read() override { ++mCalls; return 0; }
+
+        Driver *writePixel(std::uint16_t color) override {
+            ++mCalls;
+            mBytes += sizeof(color);
+            PixelTraits<PixelFormat::Mono1>::store(mBuffer.data(), mCursor++ % (mBuffer.size() * 8),
+                                                   PixelTraits<PixelFormat::Mono1>::fromRgb565(color));
+            return this;
+        }
+
+        PixelFormat pixelFormat() override {
+            return PixelFormat::Mono1;
+        }
+
+        Driver *writeNativePixels(std::size_t count, const std::uint8_t *data) override {
+            ++mCalls;
+            std::size_t bytes = pixelBytes(PixelFormat::Mono1, count);
+            std::size_t offset = mCursor / 8 % mBuffer.size();
+            std::size_t size = bytes < mBuffer.size() - offset ? bytes : mBuffer.size() - offset;
+            std::copy(data, data + size, mBuffer.begin() + offset);
+            mCursor += count;
+            mBytes += bytes;
+            return this;
+        }
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override {
+            x1 = y1 = 0;
+            x2 = mWidth - 1;
+            y2 = mHeight - 1;
+            return this;
+        }
+
+        Driver *setAddressWindow(std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t) override {
+            ++mCalls;
+            mCursor = 0;
+            return this;
+        }
+
+        std::vector<std::uint8_t> mBuffer;
+        std::size_t mCursor = 0;
+        std::uint64_t mCalls = 0,
+                      mBytes = 0;
+    };
+
+    /**
+     * Fills pixels with a pseudo-random picture in Format and colors with the
+     * same picture in RGB565.
+     */
+    template<PixelFormat Format>
+    void picture(std::size_t count, typename PixelTraits<Format>::Pixel *pixels, std::uint16_t *colors) {
+        std::uint32_t state = 0x12345678;
+        for (std::size_t i = 0; i < count; ++i) {
+            state = state * 1664525u + 1013904223u;
+            pixels[i] = PixelTraits<Format>::fromRgb565(std::uint16_t(state >> 16));
+            colors[i] = PixelTraits<Format>::toRgb565(pixels[i]);
+        }
+    }
+
+    /**
+     * Sends the same picture as RGB565 and in its native Format to a
+     * {@link MemoryDriver} configured through COLMOD.
+     */
+    template<PixelFormat Format>
+    void runMemory(int reps, Size size, std::uint8_t colmod, const char *rgb565Name, const char *nativeName) {
+        std::size_t count = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> gram(count), colors(count);
+        std::unique_ptr<typename PixelTraits<Format>::Pixel[]> pixels(new typename PixelTraits<Format>::Pixel[count]);
+        picture<Format>(count, pixels.get(), colors.data());
+        MemoryDriver driver(size.width, size.height, gram.data());
+        driver.initialize();
+        driver.select();
+        driver.writeCommand(MemoryDriver::Command::COLMOD)->write(colmod);
+        driver.deselect();
+
+        auto run = [&](const char *name, auto &&send) {
+            auto body = [&] {
+                driver.select();
+                driver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+                send();
+                driver.deselect();
+            };
+            double ns = measure(reps, body);
+            driver.resetCounters();
+            body();
+            print(Result{name, "pixel", size, ns / count, double(driver.counters().virtualCalls) / count,
+                         double(driver.counters().bytesWritten) / count});
+        };
+        run(rgb565Name, [&] { driver.writePixels(count, colors.data()); });
+        run(nativeName, [&] { driver.writePixels<Format>(count, pixels.get()); });
+    }
+
+    void runMono(int reps, Size size) {
+        std::size_t count = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> colors(count);
+        std::unique_ptr<bool[]> pixels(new bool[count]);
+        picture<PixelFormat::Mono1>(count, pixels.get(), colors.data());
+        MonoDriver driver(size.width, size.height);
+
+        auto run = [&](const char *name, auto &&send) {
+            auto body = [&] {
+                driver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+                send();
+            };
+            double ns = measure(reps, body);
+            driver.mCalls = 0;
+            driver.mBytes = 0;
+            body();
+            print(Result{name, "pixel", size, ns / count, double(driver.mCalls) / count,
+                         double(driver.mBytes) / count});
+        };
+        run("rgb565 mono1", [&] { driver.writePixels(count, colors.data()); });
+        run("native mono1", [&] { driver.writePixels<PixelFormat::Mono1>(count, pixels.get()); });
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        runMemory<PixelFormat::Rgb332>(reps, size, 0x02, "rgb565 rgb332", "native rgb332");
+        runMemory<PixelFormat::Rgb565>(reps, size, 0x55, "rgb565 rgb565", "native rgb565");
+        runMemory<PixelFormat::Rgb666>(reps, size, 0x66, "rgb565 rgb666", "native rgb666");
+        runMemory<PixelFormat::Rgb888>(reps, size, 0x77, "rgb565 rgb888", "native rgb888");
+        runMono(reps, size);
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uint16_t WIDTH = 320,
+                            HEIGHT = 240;
+    constexpr double PERIOD = 1e6 / 60,
+                     BLANKING = 800,
+                     BUS_US_PER_PIXEL = 0.2;
+
+    double micros() {
+        return std::chrono::duration<double, std::micro>(Clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * A MemoryDriver on a simulated 40 MHz bus, attached to a panel that
+     * refreshes at 60 Hz and raises its TE line during blanking. Every region
+     * uploaded is checked against the scanline: a region tears when some
+     * refresh shows part of it new and part of it old.
+     */
+    class SimulatedPanel : public MemoryDriver {
+    public:
+        SimulatedPanel(std::uint16_t *gram)
+            : MemoryDriver(WIDTH, HEIGHT, gram), mWritten(HEIGHT) {
+            // The panel was started a while ago, out of phase with anything
+            // the host knows of.
+            mOrigin = micros() - PERIOD / 3;
+        }
+
+        /**
+         * Gets the start of a refresh on the scheduler's clock.
+         */
+        std::uint32_t vsync() const {
+            return std::uint32_t(std::uint64_t(mOrigin));
+        }
+
+        bool hasTearingEffect() override {
+            return true;
+        }
+
+        bool tearingEffect() override {
+            return std::fmod(micros() - mOrigin, PERIOD) < BLANKING;
+        }
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override {
+            check();
+            MemoryDriver::setAddressWindow(x1, y1, x2, y2);
+            mRegion = Rect{x1, y1, x2, y2};
+            mRow = y1;
+            mColumn = 0;
+            mStart = micros();
+            return this;
+        }
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            MemoryDriver::writePixels(count, data);
+            double done = micros() + count * BUS_US_PER_PIXEL;
+            while (micros() < done);
+            for (mColumn += count; mColumn >= mRegion.width() && mRow <= mRegion.y2; mColumn -= mRegion.width()) {
+                mWritten[mRow++] = done;
+            }
+            return this;
+        }
+
+        /**
+         * Checks the region uploaded last, if it has not been yet.
+         */
+        void check() {
+            if (mRow <= mRegion.y1) {
+                return;
+            }
+            std::uint16_t last = mRow - 1;
+            double end = mWritten[last];
+            long firstPass = long((mStart - mOrigin) / PERIOD) - 1,
+                 lastPass = long((end - mOrigin) / PERIOD) + 1;
+            for (long pass = firstPass; pass <= lastPass; ++pass) {
+                std::size_t fresh = 0;
+                for (std::uint16_t y = mRegion.y1; y <= last; ++y) {
+                    fresh += scanned(pass, y) >= mWritten[y];
+                }
+                if (fresh && fresh <= std::size_t(last - mRegion.y1)) {
+                    ++torn;
+                    break;
+                }
+            }
+            mRow = mRegion.y1;
+        }
+
+        using MemoryDriver::writePixels;
+
+        std::size_t torn = 0;
+    private:
+        double scanned(long pass, std::uint16_t line) const {
+            return mOrigin + pass * PERIOD + BLANKING + (PERIOD - BLANKING) * line / HEIGHT;
+        }
+
+        std::vector<double> mWritten;
+        double mOrigin, mStart;
+        Rect mRegion{};
+        std::size_t mColumn = 0;
+        std::uint16_t mRow = 0;
+    };
+
+    enum class Mode {
+        Immediate,
+        Timer,
+        PhasedTimer,
+        Polled,
+    };
+
+    void run(const char *name, Mode mode, std::uint16_t regionWidth, std::uint16_t regionHeight, int frames) {
+        std::vector<std::uint16_t> gram(std::size_t(WIDTH) * HEIGHT),
+                                   shadow(gram.size());
+        SimulatedPanel panel(gram.data());
+        panel.initialize();
+        DirtyRegionTracker tracker(panel, shadow.data(), WIDTH, HEIGHT);
+        PresentationScheduler scheduler(panel, 60);
+        if (mode == Mode::Timer || mode == Mode::PhasedTimer) {
+            scheduler.sync(PresentationScheduler::Sync::Timer)->blanking(std::uint32_t(BLANKING));
+        }
+        if (mode == Mode::PhasedTimer) {
+            // As if the board had read one TE edge or a frame counter.
+            scheduler.synchronize(panel.vsync());
+        }
+        std::srand(1);
+
+        double start = micros(),
+               next = start;
+        std::size_t regions = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int i = 0; i < 4; ++i) {
+                std::uint16_t x = std::rand() % (WIDTH - regionWidth + 1),
+                              y = std::rand() % (HEIGHT - regionHeight + 1);
+                tracker.fillRect(Rect{x, y, std::uint16_t(x + regionWidth - 1), std::uint16_t(y + regionHeight - 1)},
+                                 std::uint16_t(std::rand()));
+            }
+            regions += tracker.regionCount();
+            if (mode == Mode::Immediate) {
+                // Paced at the refresh rate, but blind to the panel's phase.
+                while (micros() < next);
+                next += PERIOD;
+                tracker.flush();
+            } else {
+                scheduler.present(tracker);
+            }
+            panel.check();
+        }
+        double seconds = (micros() - start) / 1e6;
+        const PresentationScheduler::Statistics &statistics = scheduler.statistics();
+        std::printf("%-24s %3ux%-4u %8.1f %8zu %8zu %8u %8u %8u %10u\n",
+                    name, unsigned(regionWidth), unsigned(regionHeight), frames / seconds, regions, panel.torn,
+                    unsigned(statistics.missed), unsigned(statistics.late), unsigned(statistics.missedFrames),
+                    unsigned(statistics.worstLateness));
+    }
+}
+
+int main(int argc, char **argv) {
+    int frames = 12 * repetitions(argc, argv);
+    std::printf("%-24s %-8s %8s %8s %8s %8s %8s %8s %10s\n",
+                "presentation", "region", "fps", "regions", "torn", "missed", "late", "frames", "worst-us");
+    for (const Size &region : {Size{64, 48}, Size{160, 120}, Size{320, 64}}) {
+        run("immediate", Mode::Immediate, region.width, region.height, frames);
+        // Without a phase the timer only paces frames: it tears about as
+        // often as immediate uploads, and missed and late cannot show it.
+        run("scheduled timer", Mode::Timer, region.width, region.height, frames);
+        run("scheduled timer phased", Mode::PhasedTimer, region.width, region.height, frames);
+        run("scheduled TE polled", Mode::Polled, region.width, region.height, frames);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::size_t SETS = 1024;
+    constexpr std::size_t MAX_RECTS = 40;
+
+    /**
+     * Makes a pseudo-random rectangle within size, at most maxSide pixels
+     * wide and tall.
+     */
+    Rect randomRect(std::uint32_t &seed, Size size, std::uint16_t maxSide) {
+        std::uint16_t values[4];
+        for (std::uint16_t &value : values) {
+            seed = seed * 1664525u + 1013904223u;
+            value = std::uint16_t(seed >> 16);
+        }
+        std::uint16_t x1 = values[0] % size.width,
+                      y1 = values[1] % size.height,
+                      x2 = std::uint16_t(std::min<std::uint32_t>(x1 + values[2] % maxSide, size.width - 1u)),
+                      y2 = std::uint16_t(std::min<std::uint32_t>(y1 + values[3] % maxSide, size.height - 1u));
+        return Rect{x1, y1, x2, y2};
+    }
+
+    /**
+     * Times adding sets of 1 to MAX_RECTS random rectangles, each up to a
+     * quarter of the screen across. Calls are the address windows sent and
+     * bytes the pixels sent, both per rectangle added.
+     */
+    void run(int reps, Size size) {
+        std::vector<Rect> rects;
+        std::vector<std::size_t> counts(SETS);
+        std::uint32_t seed = 12345;
+        for (std::size_t &count : counts) {
+            seed = seed * 1664525u + 1013904223u;
+            count = 1 + (seed >> 16) % MAX_RECTS;
+            for (std::size_t i = 0; i < count; ++i) {
+                rects.push_back(randomRect(seed, size, std::uint16_t(size.width / 4)));
+            }
+        }
+
+        RegionSet set;
+        std::size_t windows = 0,
+                    pixels = 0;
+        auto body = [&] {
+            windows = pixels = 0;
+            const Rect *rect = rects.data();
+            for (std::size_t count : counts) {
+                set.clear();
+                for (std::size_t i = 0; i < count; ++i) {
+                    set.add(*rect++);
+                }
+                windows += set.count();
+                for (std::size_t i = 0; i < set.count(); ++i) {
+                    pixels += set.region(i).area();
+                }
+            }
+        };
+        double ns = measure(reps, body);
+        print(Result{"region set add", "rect", size, ns / rects.size(), double(windows) / rects.size(),
+                     2.0 * pixels / rects.size()});
+    }
+
+    /**
+     * Adds rounds of random rectangles to a 64x48 set with random window
+     * costs, and checks that every round leaves the regions well formed and
+     * disjoint, covering every pixel that was added.
+     */
+    bool check(std::size_t rounds) {
+        constexpr Size SIZE{64, 48};
+        std::vector<std::uint8_t> added(std::size_t(SIZE.width) * SIZE.height),
+                                  covered(added.size());
+        std::uint32_t seed = 3;
+        std::size_t failures = 0,
+                    most = 0;
+        for (std::size_t round = 0; round < rounds; ++round) {
+            RegionSet set;
+            seed = seed * 1664525u + 1013904223u;
+            set.windowCost((seed >> 16) % 64);
+            std::fill(added.begin(), added.end(), 0);
+            std::fill(covered.begin(), covered.end(), 0);
+            std::size_t count = 1 + (seed >> 8) % MAX_RECTS;
+            for (std::size_t i = 0; i < count; ++i) {
+                Rect rect = randomRect(seed, SIZE, 20);
+                set.add(rect);
+                for (std::uint16_t y = rect.y1; y <= rect.y2; ++y) {
+                    std::memset(added.data() + std::size_t(y) * SIZE.width + rect.x1, 1, rect.width());
+                }
+            }
+            bool ok = set.count() <= KEMPOZER_SCREEN_MAX_DIRTY_REGIONS;
+            for (std::size_t i = 0; i < set.count(); ++i) {
+                const Rect &rect = set.region(i);
+                if (rect.x1 > rect.x2 || rect.y1 > rect.y2 || rect.x2 >= SIZE.width || rect.y2 >= SIZE.height) {
+                    ok = false;
+                    continue;
+                }
+                for (std::uint16_t y = rect.y1; y <= rect.y2; ++y) {
+                    for (std::uint16_t x = rect.x1; x <= rect.x2; ++x) {
+                        ok &= !covered[std::size_t(y) * SIZE.width + x]++;
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < added.size(); ++i) {
+                ok &= !added[i] || covered[i];
+            }
+            failures += !ok;
+            most = std::max(most, set.count());
+        }
+        std::printf("# %zu random sets, at most %zu regions, %zu overlapping or uncovered: %s\n",
+                    rounds, most, failures, failures ? "FAILED" : "ok");
+        return !failures;
+    }
+}
+
+int main(int argc, char **argv) {
+    // --check runs only the correctness check, as the RegionSetCheck test.
+    if (argc > 1 && !std::strcmp(argv[1], "--check")) {
+        return check(20000) ? 0 : 1;
+    }
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        run(reps, size);
+    }
+    return check(20000) ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <vector>
+#include "Benchmark.h"
+#include "FramebufferDriver.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    class StaticFramebufferDriver : public StaticDriver<StaticFramebufferDriver> {
+    public:
+        StaticFramebufferDriver(std::uint16_t width, std::uint16_t height, std::uint16_t *gram)
+            : StaticDriver(width, height), mFramebuffer{gram, width, 0, 0, 0, 0, 0, 0, 0} {}
+
+        bool initialize() { return true; }
+        StaticFramebufferDriver *select() { return this; }
+        StaticFramebufferDriver *deselect() { return this; }
+        StaticFramebufferDriver *assertCommand() { return this; }
+        StaticFramebufferDriver *deassertCommand() { return this; }
+
+        [[gnu::always_inline]]
+        inline StaticFramebufferDriver *writePixel(std::uint16_t color) {
+            mFramebuffer.pixel(color);
+            return this;
+        }
+
+        StaticFramebufferDriver *write(std::uint8_t) {
+            ++mFramebuffer.bytes;
+            return this;
+        }
+
+        std::uint16_t readPixel() { return 0; }
+        std::uint8_t read() { return 0; }
+
+        StaticFramebufferDriver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                                               std::uint16_t &x2, std::uint16_t &y2) {
+            x1 = mFramebuffer.x1;
+            y1 = mFramebuffer.y1;
+            x2 = mFramebuffer.x2;
+            y2 = mFramebuffer.y2;
+            return this;
+        }
+
+        StaticFramebufferDriver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                                  std::uint16_t x2, std::uint16_t y2) {
+            mFramebuffer.window(x1, y1, x2, y2);
+            return this;
+        }
+
+
+        Framebuffer mFramebuffer;
+    };
+
+    class VirtualFramebufferDriver : public Driver {
+    public:
+        VirtualFramebufferDriver(std::uint16_t width, std::uint16_t height, std::uint16_t *gram)
+            : Driver(width, height), mFramebuffer{gram, width, 0, 0, 0, 0, 0, 0, 0} {}
+
+        bool initialize() override { return true; }
+        Driver *select() override { ++mCalls; return this; }
+        Driver *deselect() override { ++mCalls; return this; }
+        Driver *assertCommand() override { ++mCalls; return this; }
+        Driver *deassertCommand() override { ++mCalls; return this; }
+
+        Driver *writePixel(std::uint16_t color) override {
+            ++mCalls;
+            mFramebuffer.pixel(color);
+            return this;
+        }
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            ++mCalls;
+            return Driver::writePixels(count, data);
+        }
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override {
+            ++mCalls;
+            return Driver::writeRepeatedPixel(count, color);
+        }
+
+        Driver *write(std::uint8_t) override {
+            ++mCalls;
+            ++mFramebuffer.bytes;
+            return this;
+        }
+
+        std::uint16_t readPixel() override { ++mCalls; return 0; }
+        std::uint8_t read() override { ++mCalls; return 0; }
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override {
+            ++mCalls;
+            x1 = mFramebuffer.x1;
+            y1 = mFramebuffer.y1;
+            x2 = mFramebuffer.x2;
+            y2 = mFramebuffer.y2;
+            return this;
+        }
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override {
+            ++mCalls;
+            mFramebuffer.window(x1, y1, x2, y2);
+            return this;
+        }
+
+
+        using Driver::writePixels;
+
+        Framebuffer mFramebuffer;
+        std::uint64_t mCalls = 0;
+    };
+
+    /**
+     * Counts the virtual calls made through the adapter.
+     */
+    class CountingAdapter : public StaticDriverAdapter<StaticFramebufferDriver> {
+    public:
+        using StaticDriverAdapter::StaticDriverAdapter;
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override {
+            ++mCalls;
+            return StaticDriverAdapter::setAddressWindow(x1, y1, x2, y2);
+        }
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            ++mCalls;
+            return StaticDriverAdapter::writePixels(count, data);
+        }
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override {
+            ++mCalls;
+            return StaticDriverAdapter::writeRepeatedPixel(count, color);
+        }
+
+        using Driver::writePixels;
+
+        std::uint64_t mCalls = 0;
+    };
+
+    template<typename F>
+    Result run(const char *name, Size size, std::size_t pixels, int reps,
+               std::uint64_t &calls, std::uint64_t &bytes, F &&body) {
+        double ns = measure(reps, body);
+        calls = 0;
+        bytes = 0;
+        body();
+        return Result{name, "pixel", size, ns / pixels, double(calls) / pixels, double(bytes) / pixels};
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height;
+        std::uint16_t x2 = size.width - 1,
+                      y2 = size.height - 1;
+        std::vector<std::uint16_t> gram(pixels),
+                                   pixelData(pixels);
+        for (std::size_t i = 0; i < pixels; ++i) {
+            pixelData[i] = std::uint16_t(i * 2654435761u);
+        }
+
+        StaticFramebufferDriver staticDriver(size.width, size.height, gram.data());
+        CountingAdapter adapter(staticDriver);
+        VirtualFramebufferDriver virtualDriver(size.width, size.height, gram.data());
+        Driver *adapted = &adapter,
+               *dynamic = &virtualDriver;
+        std::uint64_t noCalls = 0;
+
+        print(run("static fill", size, pixels, reps, noCalls, staticDriver.mFramebuffer.bytes, [&] {
+            staticDriver.setAddressWindow(0, 0, x2, y2)->writeRepeatedPixel(pixels, 0xF800);
+        }));
+        print(run("adapter fill", size, pixels, reps, adapter.mCalls, staticDriver.mFramebuffer.bytes, [&] {
+            adapted->setAddressWindow(0, 0, x2, y2)->writeRepeatedPixel(pixels, 0xF800);
+        }));
+        print(run("virtual fill", size, pixels, reps, virtualDriver.mCalls, virtualDriver.mFramebuffer.bytes, [&] {
+            dynamic->setAddressWindow(0, 0, x2, y2)->writeRepeatedPixel(pixels, 0xF800);
+        }));
+        print(run("static blit", size, pixels, reps, noCalls, staticDriver.mFramebuffer.bytes, [&] {
+            staticDriver.setAddressWindow(0, 0, x2, y2)->writePixels(pixels, pixelData.data());
+        }));
+        print(run("adapter blit", size, pixels, reps, adapter.mCalls, staticDriver.mFramebuffer.bytes, [&] {
+            adapted->setAddressWindow(0, 0, x2, y2)->writePixels(pixels, pixelData.data());
+        }));
+        print(run("virtual blit", size, pixels, reps, virtualDriver.mCalls, virtualDriver.mFramebuffer.bytes, [&] {
+            dynamic->setAddressWindow(0, 0, x2, y2)->writePixels(pixels, pixelData.data());
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "FramebufferDriver.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    /**
+     * Draws a dashboard-like frame: a cleared background, a grid of
+     * outlined panels and a pasted bitmap in each.
+     */
+    void drawFrame(Driver &driver, const std::vector<std::uint16_t> &icon, std::uint16_t iconSize) {
+        Canvas canvas(driver);
+        std::uint16_t width, height;
+        driver.resolution(width, height);
+        canvas.clear(0x0000);
+        for (std::uint16_t y = 0; y + 60 <= height; y += 60) {
+            for (std::uint16_t x = 0; x + 80 <= width; x += 80) {
+                canvas.fillRect(std::int16_t(x + 2), std::int16_t(y + 2), 76, 56, 0x18E3);
+                canvas.drawRect(std::int16_t(x + 2), std::int16_t(y + 2), 76, 56, 0xFFFF);
+                driver.setAddressWindow(x + 8, y + 8, x + 8 + iconSize - 1, y + 8 + iconSize - 1);
+                driver.writePixels(icon.size(), icon.data());
+            }
+        }
+    }
+
+    /**
+     * Saves what a trace driver recorded.
+     */
+    std::vector<std::uint8_t> save(const TraceDriver &recorder) {
+        std::vector<std::uint8_t> trace(recorder.save(nullptr, 0));
+        recorder.save(trace.data(), trace.size());
+        return trace;
+    }
+
+    /**
+     * Replays trace into target through a trace driver, to measure how busy
+     * target keeps the bus on the same workload.
+     */
+    float utilisation(const std::vector<std::uint8_t> &trace, Driver &target, std::vector<std::uint8_t> &ring) {
+        TraceDriver recorder(target, ring.data(), ring.size());
+        TraceReplayer(trace.data(), trace.size()).replay(recorder);
+        std::vector<std::uint8_t> replayed = save(recorder);
+        TraceReplayer replayer(replayed.data(), replayed.size());
+        return TraceReplayer::utilisation(replayer.summarize());
+    }
+}
+
+int main(int argc, char **argv) {
+    int reps = repetitions(argc, argv);
+    printHeader();
+    for (const Size &size : SIZES) {
+        std::size_t pixels = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> gram(pixels),
+                                   icon(32 * 32);
+        for (std::size_t i = 0; i < icon.size(); ++i) {
+            icon[i] = std::uint16_t(i * 2654435761u);
+        }
+        std::vector<std::uint8_t> ring(std::size_t(1) << 20);
+        MemoryDriver panel(size.width, size.height, gram.data());
+        FramebufferDriver framebuffer(size.width, size.height, gram.data());
+        panel.initialize();
+        TraceDriver recorder(panel, ring.data(), ring.size());
+
+        double bare = measure(reps, [&] { drawFrame(panel, icon, 32); }),
+               recorded = measure(reps, [&] {
+                   recorder.clear();
+                   drawFrame(recorder, icon, 32);
+               });
+        std::vector<std::uint8_t> trace = save(recorder);
+        TraceReplayer replayer(trace.data(), trace.size());
+        TraceReplayer::Summary summary = replayer.summarize();
+
+        double memory = measure(reps, [&] { replayer.rewind()->replay(panel); }),
+               bulk = measure(reps, [&] { replayer.rewind()->replay(framebuffer); });
+        print(Result{"frame", "pixel", size, bare / pixels, 0, 0});
+        print(Result{"recorded frame", "pixel", size, recorded / pixels, 0, 0});
+        print(Result{"replay memory driver", "pixel", size, memory / pixels, 0, 0});
+        print(Result{"replay framebuffer driver", "pixel", size, bulk / pixels, 0, 0});
+
+        // Bus utilisation of the session as recorded, and of each driver
+        // replaying it back to back.
+        float recordedUtilisation = TraceReplayer::utilisation(summary),
+              memoryUtilisation = utilisation(trace, panel, ring),
+              bulkUtilisation = utilisation(trace, framebuffer, ring);
+        std::printf("# %ux%u trace: %u events in %zu bytes, %llu bytes moved, utilisation "
+                    "recorded %.1f%% memory %.1f%% framebuffer %.1f%%\n",
+                    unsigned(size.width), unsigned(size.height), unsigned(summary.events), trace.size(),
+                    (unsigned long long)summary.bytes, 100.0 * recordedUtilisation,
+                    100.0 * memoryUtilisation, 100.0 * bulkUtilisation);
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "KempozerScreen.h"
+
+using namespace Kempozer::Screen;
+using namespace Kempozer::Screen::Bench;
+
+namespace {
+    constexpr std::uint16_t BAND = 16;
+    constexpr std::size_t BUFFERS = 4;
+
+    /**
+     * Renders rows y to y + height - 1 of a plasma, standing in for real
+     * drawing work.
+     */
+    void render(std::uint16_t width, std::uint16_t y, std::uint16_t height, std::uint32_t frame,
+                std::uint16_t *pixels) {
+        for (std::uint16_t row = 0; row < height; ++row) {
+            for (std::uint16_t x = 0; x < width; ++x) {
+                std::uint32_t v = x * 7 + (y + row) * 13 + frame;
+                for (int i = 0; i < 24; ++i) {
+                    v = v * 2654435761u ^ v >> 13;
+                }
+                *pixels++ = std::uint16_t(v);
+            }
+        }
+    }
+
+    [[gnu::always_inline]]
+    inline Rect band(std::uint16_t width, std::uint16_t y, std::uint16_t height) {
+        return Rect{0, y, std::uint16_t(width - 1), std::uint16_t(y + height - 1)};
+    }
+
+    /**
+     * Renders a frame band by band and sends each band before rendering the
+     * next.
+     */
+    void serial(MemoryDriver &driver, Size size, std::uint32_t frame, std::uint16_t *pixels) {
+        for (std::uint16_t y = 0; y < size.height; y += BAND) {
+            std::uint16_t height = size.height - y < BAND ? size.height - y : BAND;
+            render(size.width, y, height, frame, pixels);
+            Rect rect = band(size.width, y, height);
+            driver.select();
+            driver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+            driver.writePixels(rect.area(), pixels);
+            driver.deselect();
+        }
+    }
+
+    /**
+     * Renders a frame band by band into a ring of buffers, posting each
+     * band to worker and reusing a buffer once its band has been sent.
+     */
+    void pipelined(TransferWorker &worker, Size size, std::uint32_t frame, std::uint16_t *const *buffers) {
+        std::size_t tickets[BUFFERS] = {};
+        std::size_t slot = 0;
+        for (std::uint16_t y = 0; y < size.height; y += BAND) {
+            std::uint16_t height = size.height - y < BAND ? size.height - y : BAND;
+            worker.waitFor(tickets[slot]);
+            render(size.width, y, height, frame, buffers[slot]);
+            tickets[slot] = worker.post(TransferJob::pixels(band(size.width, y, height), buffers[slot]));
+            slot = (slot + 1) % BUFFERS;
+        }
+        worker.flush();
+    }
+
+    /**
+     * Compares render-then-send against rendering on this thread while a
+     * worker thread sends, and checks that both leave the same picture.
+     */
+    bool overlap(int reps, Size size) {
+        std::size_t count = std::size_t(size.width) * size.height;
+        std::vector<std::uint16_t> serialGram(count), pipelinedGram(count), scratch(count);
+        std::vector<std::uint16_t> storage(BUFFERS * std::size_t(size.width) * BAND);
+        std::uint16_t *buffers[BUFFERS];
+        for (std::size_t i = 0; i < BUFFERS; ++i) {
+            buffers[i] = storage.data() + i * std::size_t(size.width) * BAND;
+        }
+        MemoryDriver serialDriver(size.width, size.height, serialGram.data());
+        MemoryDriver pipelinedDriver(size.width, size.height, pipelinedGram.data());
+        serialDriver.initialize();
+        pipelinedDriver.initialize();
+        StaticTransferQueue<8> queue;
+        TransferWorker worker(pipelinedDriver, queue, TransferWorker::Drain::Producer);
+        std::uint32_t frame = 0;
+
+        double renderNs = measure(reps, [&] {
+            for (std::uint16_t y = 0; y < size.height; y += BAND) {
+                std::uint16_t height = size.height - y < BAND ? size.height - y : BAND;
+                render(size.width, y, height, frame, scratch.data() + std::size_t(y) * size.width);
+            }
+        });
+        double transferNs = measure(reps, [&] {
+            serialDriver.select();
+            serialDriver.setAddressWindow(0, 0, size.width - 1, size.height - 1);
+            serialDriver.writePixels(count, scratch.data());
+            serialDriver.deselect();
+        });
+        double serialNs = measure(reps, [&] { serial(serialDriver, size, ++frame, scratch.data()); });
+        worker.start();
+        double pipelinedNs = measure(reps, [&] { pipelined(worker, size, ++frame, buffers); });
+        worker.stop();
+
+        serial(serialDriver, size, ++frame, scratch.data());
+        pipelined(worker, size, frame, buffers);
+        bool equal = serialGram == pipelinedGram;
+
+        print(Result{"render only", "pixel", size, renderNs / count, 0, 0});
+        print(Result{"transfer only", "pixel", size, transferNs / count, 0, 0});
+        print(Result{"render then transfer", "pixel", size, serialNs / count, 0, 0});
+        print(Result{"render while transfer", "pixel", size, pipelinedNs / count, 0, 0});
+        double hidden = (serialNs - pipelinedNs) / (renderNs < transferNs ? renderNs : transferNs);
+        std::printf("# %ux%u overlap %.0f%% of the shorter stage hidden, picture %s\n",
+                    unsigned(size.width), unsigned(size.height), 100 * hidden, equal ? "matches" : "DIFFERS");
+        return equal;
+    }
+
+    struct Sequence {
+        std::uint32_t expected;
+        std::uint32_t errors;
+    };
+
+    struct Check {
+        Sequence *sequence;
+        std::uint32_t value;
+    };
+
+    [[gnu::always_inline]]
+    inline std::uint32_t mix(std::uint32_t v) {
+        v = (v ^ v >> 16) * 0x45D9F3Bu;
+        return v ^ v >> 16;
+    }
+
+    /**
+     * Makes the index-th job of the stress run: a fill, a block of pixels
+     * written into block, or a call that checks its place in sequence.
+     */
+    TransferJob stressJob(std::size_t index, Size size, std::uint16_t *block, std::size_t blockSize,
+                          Check *checks, Sequence *sequence, std::uint32_t &calls) {
+        std::uint32_t v = mix(std::uint32_t(index));
+        std::uint16_t x = std::uint16_t(v % (size.width - 8)),
+                      y = std::uint16_t(v / size.width % (size.height - 8));
+        switch (v >> 28 & 3) {
+            case 0:
+                return TransferJob::fill(Rect{x, y, std::uint16_t(x + (v >> 8 & 7)), std::uint16_t(y + (v >> 12 & 7))},
+                                         std::uint16_t(v));
+            case 1:
+                for (std::size_t p = 0; p < blockSize; ++p) {
+                    block[p] = std::uint16_t(mix(std::uint32_t(index * blockSize + p)));
+                }
+                return TransferJob::pixels(Rect{x, y, std::uint16_t(x + 7), std::uint16_t(y + 7)}, block);
+            default:
+                checks[index] = Check{sequence, calls++};
+                return TransferJob::call([](Driver &, void *context) {
+                    Check *check = static_cast<Check *>(context);
+                    check->sequence->errors += check->value != check->sequence->expected++;
+                }, &checks[index]);
+        }
+    }
+
+    /**
+     * Floods a small queue from this thread with a mix of fills, pixel
+     * blocks and calls, and checks that the consumer carried them out in
+     * order and drew what the same jobs draw when run one at a time on this
+     * thread. The consumer is the worker's own thread, or with external a
+     * thread of this program calling process(), standing in for another core.
+     */
+    bool stress(std::size_t jobs, bool external) {
+        constexpr Size SIZE{64, 48};
+        constexpr std::size_t BLOCKS = 32;
+        constexpr std::size_t BLOCK = 64;
+        std::vector<std::uint16_t> gram(std::size_t(SIZE.width) * SIZE.height), reference(gram.size());
+        std::vector<std::uint16_t> blocks(BLOCKS * BLOCK);
+        std::vector<Check> checks(jobs);
+
+        MemoryDriver referenceDriver(SIZE.width, SIZE.height, reference.data());
+        referenceDriver.initialize();
+        StaticTransferQueue<1> referenceQueue;
+        TransferWorker referenceWorker(referenceDriver, referenceQueue, TransferWorker::Drain::Producer);
+        Sequence referenceSequence{0, 0};
+        std::uint32_t referenceCalls = 0;
+        for (std::size_t i = 0; i < jobs; ++i) {
+            referenceWorker.post(stressJob(i, SIZE, blocks.data(), BLOCK, checks.data(), &referenceSequence,
+                                           referenceCalls));
+            referenceWorker.flush();
+        }
+
+        MemoryDriver driver(SIZE.width, SIZE.height, gram.data());
+        driver.initialize();
+        StaticTransferQueue<8> queue;
+        TransferWorker worker(driver, queue, external ? TransferWorker::Drain::External
+                                                      : TransferWorker::Drain::Producer);
+        std::size_t tickets[BLOCKS] = {};
+        Sequence sequence{0, 0};
+        std::uint32_t calls = 0;
+        std::atomic<bool> stopping{false};
+        std::thread consumer;
+        if (external) {
+            consumer = std::thread([&] {
+                while (!stopping.load(std::memory_order_acquire)) {
+                    if (!worker.process()) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        } else {
+            worker.start();
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < jobs; ++i) {
+            std::size_t slot = i % BLOCKS;
+            worker.waitFor(tickets[slot]);
+            tickets[slot] = worker.post(stressJob(i, SIZE, blocks.data() + slot * BLOCK, BLOCK, checks.data(),
+                                                  &sequence, calls));
+        }
+        worker.flush();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (external) {
+            stopping.store(true, std::memory_order_release);
+            consumer.join();
+        } else {
+            worker.stop();
+        }
+
+        TransferWorker::Statistics statistics = worker.statistics();
+        bool ok = gram == reference && sequence.errors == 0 && sequence.expected == calls
+                  && calls == referenceCalls && statistics.processed == jobs;
+        print(Result{external ? "stress external consumer" : "stress worker thread", "job", SIZE, ns / jobs,
+                     double(driver.counters().virtualCalls) / jobs, double(driver.counters().bytesWritten) / jobs});
+        std::printf("# %zu jobs in %zu batches, %zu stalls, %u calls in order: %s\n",
+                    statistics.processed, statistics.batches, statistics.stalls, unsigned(sequence.expected),
+                    ok ? "ok" : "FAILED");
+        return ok;
+    }
+}
+
+int main(int argc, char **argv) {
+    // --stress runs only the correctness checks, as the TransferStress test.
+    if (argc > 1 && !std::strcmp(argv[1], "--stress")) {
+        printHeader();
+        bool ok = stress(200000, false);
+        ok &= stress(200000, true);
+        return ok ? 0 : 1;
+    }
+    int reps = repetitions(argc, argv);
+    bool ok = true;
+    std::printf("# %u hardware threads; render and transfer only overlap with more than one\n",
+                std::thread::hardware_concurrency());
+    printHeader();
+    for (const Size &size : SIZES) {
+        ok &= overlap(reps, size);
+    }
+    ok &= stress(200000, false);
+    ok &= stress(200000, true);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Encodes a sequence of binary PPM (P6) frames of one size into the
+ * FrameStream format, each frame as the rectangles that changed since the
+ * one before it.
+ *
+ *     FrameEncoder [--fps rate] [--window-cost pixels] output.kfs frame.ppm...
+ *
+ * --fps sets the rate the stream plays at, and defaults to 0 for as fast as
+ * possible. --window-cost is the number of unchanged pixels that are
+ * cheaper to resend than to skip with a new address window, and defaults
+ * to 32.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "Kempozer/Screen/FrameStream.h"
+#include "Ppm.h"
+
+using Kempozer::Screen::FrameStream;
+using Kempozer::Screen::Tools::Image;
+using Kempozer::Screen::Tools::readPpm;
+
+namespace {
+    int usage() {
+        std::fprintf(stderr, "usage: FrameEncoder [--fps rate] [--window-cost pixels] output.kfs frame.ppm...\n");
+        return 2;
+    }
+}
+
+int main(int argc, char **argv) {
+    double fps = 0;
+    std::size_t windowCost = 32;
+    std::vector<const char *> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--fps") && i + 1 < argc) {
+            fps = std::atof(argv[++i]);
+            if (fps < 0) {
+                return usage();
+            }
+        } else if (!std::strcmp(argv[i], "--window-cost") && i + 1 < argc) {
+            windowCost = std::size_t(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() < 2) {
+        return usage();
+    }
+
+    std::vector<std::uint8_t> stream(FrameStream::HEADER_SIZE);
+    Image previous, image;
+    std::size_t changed = 0;
+    for (std::size_t i = 1; i < paths.size(); ++i) {
+        if (!readPpm(paths[i], image)) {
+            std::fprintf(stderr, "FrameEncoder: %s is not a binary PPM with 8-bit channels\n", paths[i]);
+            return 1;
+        }
+        if (i > 1 && (image.width != previous.width || image.height != previous.height)) {
+            std::fprintf(stderr, "FrameEncoder: %s is not %ux%u like the first frame\n", paths[i],
+                         unsigned(previous.width), unsigned(previous.height));
+            return 1;
+        }
+        // Grow until the frame fits. The rectangles are disjoint, so one per
+        // pixel, each a literal packet, bounds the size; failing there means
+        // the frame cannot be encoded at all.
+        std::size_t offset = stream.size(),
+                    size = 0,
+                    capacity = image.pixels.size() * 2 + 64,
+                    limit = FrameStream::FRAME_HEADER_SIZE + image.pixels.size() * (FrameStream::RECT_SIZE + 3);
+        while (!size && capacity < limit) {
+            capacity = std::min(capacity * 2, limit);
+            stream.resize(offset + capacity);
+            size = FrameStream::encodeFrame(i > 1 ? previous.pixels.data() : nullptr, image.pixels.data(),
+                                            image.width, image.height, windowCost,
+                                            stream.data() + offset, capacity);
+        }
+        if (!size) {
+            std::fprintf(stderr, "FrameEncoder: %s could not be encoded\n", paths[i]);
+            return 1;
+        }
+        stream.resize(offset + size);
+        changed += stream[offset + 4] | stream[offset + 5] << 8;
+        std::swap(previous, image);
+    }
+    std::uint32_t frames = std::uint32_t(paths.size() - 1);
+    FrameStream::writeHeader(stream.data(), stream.size(), previous.width, previous.height, frames,
+                             fps > 0 ? std::uint32_t(1e6 / fps + 0.5) : 0);
+
+    std::ofstream out(paths[0], std::ios::binary);
+    out.write(reinterpret_cast<const char *>(stream.data()), stream.size());
+    if (!out) {
+        std::fprintf(stderr, "FrameEncoder: could not write %s\n", paths[0]);
+        return 1;
+    }
+    std::printf("%u frames of %ux%u, %zu rectangles: %zu bytes (%zu raw), %.1f bytes per frame\n",
+                unsigned(frames), unsigned(previous.width), unsigned(previous.height), changed, stream.size(),
+                previous.pixels.size() * 2 * frames, double(stream.size() - FrameStream::HEADER_SIZE) / frames);
+    return 0;
+}
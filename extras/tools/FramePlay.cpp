@@ -0,0 +1,197 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Plays a stream written by FrameEncoder into an emulated display
+ * controller, reading it through a memory mapping just as a device reads
+ * it from memory-mapped flash, and reports the rate achieved and the bytes
+ * per frame.
+ *
+ *     FramePlay [--paced] [--loops count] [--output last.ppm] stream.kfs
+ *
+ * Frames are sent as fast as possible unless --paced is given, in which
+ * case they are shown at the stream's rate. --loops plays the stream that
+ * many times, and defaults to 1.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Kempozer/Screen/FramePlayer.h"
+#include "Kempozer/Screen/FrameStream.h"
+#include "Kempozer/Screen/MemoryDriver.h"
+
+using Kempozer::Screen::FramePlayer;
+using Kempozer::Screen::FrameStream;
+using Kempozer::Screen::MemoryDriver;
+
+namespace {
+    /**
+     * A read-only mapping of a whole file.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const char *path) {
+            int fd = open(path, O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0) {
+                void *data = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    mData = static_cast<const std::uint8_t *>(data);
+                    mSize = std::size_t(info.st_size);
+                }
+            }
+            close(fd);
+        }
+
+        ~MappedFile() {
+            if (mData) {
+                munmap(const_cast<std::uint8_t *>(mData), mSize);
+            }
+        }
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const std::uint8_t *data() const {
+            return mData;
+        }
+
+        std::size_t size() const {
+            return mSize;
+        }
+    private:
+        const std::uint8_t *mData = nullptr;
+        std::size_t mSize = 0;
+    };
+
+    bool writePpm(const char *path, std::uint16_t width, std::uint16_t height, const std::uint16_t *pixels) {
+        std::FILE *file = std::fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "P6\n%u %u\n255\n", unsigned(width), unsigned(height));
+        for (std::size_t i = 0; i < std::size_t(width) * height; ++i) {
+            std::uint16_t color = pixels[i];
+            std::uint8_t rgb[3] = {
+                std::uint8_t((color >> 11) * 255 / 31),
+                std::uint8_t((color >> 5 & 0x3F) * 255 / 63),
+                std::uint8_t((color & 0x1F) * 255 / 31),
+            };
+            std::fwrite(rgb, 1, sizeof(rgb), file);
+        }
+        return std::fclose(file) == 0;
+    }
+
+    int usage() {
+        std::fprintf(stderr, "usage: FramePlay [--paced] [--loops count] [--output last.ppm] stream.kfs\n");
+        return 2;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool paced = false;
+    long loops = 1;
+    const char *output = nullptr,
+               *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--paced")) {
+            paced = true;
+        } else if (!std::strcmp(argv[i], "--loops") && i + 1 < argc) {
+            loops = std::strtol(argv[++i], nullptr, 10);
+            if (loops < 1) {
+                return usage();
+            }
+        } else if (!std::strcmp(argv[i], "--output") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (!path) {
+        return usage();
+    }
+
+    MappedFile file(path);
+    if (!file.data()) {
+        std::fprintf(stderr, "FramePlay: cannot map %s\n", path);
+        return 1;
+    }
+    FrameStream stream(file.data(), file.size());
+    if (!stream.valid()) {
+        std::fprintf(stderr, "FramePlay: %s is not a version %u frame stream\n", path,
+                     unsigned(FrameStream::VERSION));
+        return 1;
+    }
+
+    std::vector<std::uint16_t> gram(std::size_t(stream.width()) * stream.height());
+    MemoryDriver driver(stream.width(), stream.height(), gram.data());
+    driver.initialize();
+    FramePlayer player(driver, stream);
+    driver.select();
+    bool complete = true;
+    for (long loop = 0; loop < loops && complete; ++loop) {
+        player.rewind();
+        for (std::uint32_t frame = 0; frame < stream.frames() && complete; ++frame) {
+            complete = paced ? player.play() : player.next();
+        }
+    }
+    driver.deselect();
+    if (!complete) {
+        std::fprintf(stderr, "FramePlay: frame %u of %s is malformed or missing\n",
+                     unsigned(stream.index()), path);
+    }
+
+    const FramePlayer::Statistics &statistics = player.statistics();
+    std::size_t raw = gram.size() * 2;
+    std::printf("%u frames of %ux%u, %u rectangles, %.1f fps (%.1f fps busy)\n",
+                unsigned(statistics.frames), unsigned(stream.width()), unsigned(stream.height()),
+                unsigned(statistics.rects), player.framesPerSecond(),
+                statistics.busy ? statistics.frames * 1e6 / double(statistics.busy) : 0.0);
+    std::printf("%.1f stream bytes per frame, %.1f bus bytes per frame, %zu bytes per full frame, %u late\n",
+                player.bytesPerFrame(),
+                statistics.frames ? double(driver.counters().bytesWritten) / statistics.frames : 0.0, raw,
+                unsigned(statistics.late));
+    if (output && !writePpm(output, stream.width(), stream.height(), driver.gram())) {
+        std::fprintf(stderr, "FramePlay: cannot write %s\n", output);
+        return 1;
+    }
+    return complete ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Encodes a binary PPM (P6) image into the CompressedImage format, as either
+ * a raw file or a C++ header that can be compiled into flash.
+ *
+ *     ImageEncoder [--format auto|rle565|palette2|palette4|palette8]
+ *                  [--name identifier] input.ppm output.h|output.ki
+ *
+ * With --format auto (the default) the smallest palette that holds every
+ * color of the image is used, falling back to plain RGB565 runs.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Kempozer/Screen/CompressedImage.h"
+#include "Ppm.h"
+
+using Kempozer::Screen::CompressedImage;
+using Kempozer::Screen::Tools::Image;
+using Kempozer::Screen::Tools::readPpm;
+
+namespace {
+    using Format = CompressedImage::Format;
+
+    unsigned bitsOf(Format format) {
+        switch (format) {
+            case Format::Palette2: return 2;
+            case Format::Palette4: return 4;
+            case Format::Palette8: return 8;
+            default: return 16;
+        }
+    }
+
+    void put16(std::vector<std::uint8_t> &out, std::uint16_t value) {
+        out.push_back(std::uint8_t(value));
+        out.push_back(std::uint8_t(value >> 8));
+    }
+
+    std::size_t runLength(const std::vector<std::uint16_t> &values, std::size_t start) {
+        std::size_t end = start + 1;
+        while (end < values.size() && end - start < CompressedImage::MAX_PACKET && values[end] == values[start]) {
+            ++end;
+        }
+        return end - start;
+    }
+
+    std::vector<std::uint8_t> encode(const Image &image, Format format,
+                                     const std::vector<std::uint16_t> &palette) {
+        std::vector<std::uint8_t> out = {'K', 'I', std::uint8_t(format), 0};
+        put16(out, image.width);
+        put16(out, image.height);
+        put16(out, std::uint16_t(palette.size()));
+        for (std::uint16_t color : palette) {
+            put16(out, color);
+        }
+
+        // Work on the values actually stored: colors or palette indices.
+        unsigned bits = bitsOf(format);
+        std::vector<std::uint16_t> values = image.pixels;
+        if (bits < 16) {
+            std::map<std::uint16_t, std::uint16_t> indices;
+            for (std::size_t i = 0; i < palette.size(); ++i) {
+                indices[palette[i]] = std::uint16_t(i);
+            }
+            for (std::uint16_t &value : values) {
+                value = indices[value];
+            }
+        }
+
+        // A run must be at least this long to beat folding it into a literal.
+        std::size_t minimumRun = bits == 16 ? 2 : 3;
+        std::size_t i = 0;
+        while (i < values.size()) {
+            std::size_t run = runLength(values, i);
+            if (run >= minimumRun) {
+                out.push_back(std::uint8_t(CompressedImage::RUN | (run - 1)));
+                if (bits == 16) {
+                    put16(out, values[i]);
+                } else {
+                    out.push_back(std::uint8_t(values[i]));
+                }
+                i += run;
+                continue;
+            }
+            std::size_t start = i;
+            while (i < values.size() && i - start < CompressedImage::MAX_PACKET
+                   && runLength(values, i) < minimumRun) {
+                ++i;
+            }
+            std::size_t count = i - start;
+            out.push_back(std::uint8_t(count - 1));
+            if (bits == 16) {
+                for (std::size_t j = start; j < i; ++j) {
+                    put16(out, values[j]);
+                }
+            } else {
+                std::size_t offset = out.size();
+                out.resize(offset + (count * bits + 7) / 8);
+                for (std::size_t j = 0; j < count; ++j) {
+                    std::size_t bit = j * bits;
+                    out[offset + (bit >> 3)] |= std::uint8_t(values[start + j] << (8 - bits - (bit & 7)));
+                }
+            }
+        }
+        return out;
+    }
+
+    bool writeHeader(const char *path, const std::string &name, const std::vector<std::uint8_t> &data) {
+        std::FILE *file = std::fopen(path, "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "// Generated by ImageEncoder.\n\n#include <cstdint>\n\n");
+        std::fprintf(file, "const std::uint8_t %s[%zu] = {", name.c_str(), data.size());
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            std::fprintf(file, "%s0x%02X,", i % 16 ? " " : "\n    ", data[i]);
+        }
+        std::fprintf(file, "\n};\n");
+        return std::fclose(file) == 0;
+    }
+
+    bool writeBinary(const char *path, const std::vector<std::uint8_t> &data) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(data.data()), data.size());
+        return bool(out);
+    }
+
+    int usage() {
+        std::fprintf(stderr, "usage: ImageEncoder [--format auto|rle565|palette2|palette4|palette8] "
+                             "[--name identifier] input.ppm output.h|output.ki\n");
+        return 2;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string formatName = "auto",
+                name = "image";
+    std::vector<const char *> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--format") && i + 1 < argc) {
+            formatName = argv[++i];
+        } else if (!std::strcmp(argv[i], "--name") && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2) {
+        return usage();
+    }
+
+    Image image;
+    if (!readPpm(paths[0], image)) {
+        std::fprintf(stderr, "ImageEncoder: %s is not a binary PPM with 8-bit channels\n", paths[0]);
+        return 1;
+    }
+
+    std::vector<std::uint16_t> palette = image.pixels;
+    std::sort(palette.begin(), palette.end());
+    palette.erase(std::unique(palette.begin(), palette.end()), palette.end());
+
+    Format format;
+    if (formatName == "auto") {
+        format = palette.size() <= 4 ? Format::Palette2
+               : palette.size() <= 16 ? Format::Palette4
+               : palette.size() <= 256 ? Format::Palette8
+               : Format::Rle565;
+    } else if (formatName == "rle565") {
+        format = Format::Rle565;
+    } else if (formatName == "palette2" || formatName == "palette4" || formatName == "palette8") {
+        format = formatName == "palette2" ? Format::Palette2
+               : formatName == "palette4" ? Format::Palette4
+               : Format::Palette8;
+        if (palette.size() > (std::size_t(1) << bitsOf(format))) {
+            std::fprintf(stderr, "ImageEncoder: %zu colors do not fit in %s\n", palette.size(), formatName.c_str());
+            return 1;
+        }
+    } else {
+        return usage();
+    }
+    if (format == Format::Rle565) {
+        palette.clear();
+    }
+
+    std::vector<std::uint8_t> data = encode(image, format, palette);
+    std::string output = paths[1];
+    bool header = output.size() > 2 && output.compare(output.size() - 2, 2, ".h") == 0;
+    if (!(header ? writeHeader(paths[1], name, data) : writeBinary(paths[1], data))) {
+        std::fprintf(stderr, "ImageEncoder: could not write %s\n", paths[1]);
+        return 1;
+    }
+    std::printf("%ux%u, %zu colors, format %u: %zu bytes (%zu raw)\n",
+                unsigned(image.width), unsigned(image.height), palette.size(), unsigned(format),
+                data.size(), image.pixels.size() * 2);
+    return 0;
+}
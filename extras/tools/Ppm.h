@@ -0,0 +1,120 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Tools_Ppm_h__
+#define __Kempozer_Screen_Tools_Ppm_h__
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Kempozer/Screen/ColorConversion.h"
+
+namespace Kempozer::Screen::Tools {
+
+    /**
+     * An image read by {@link readPpm}, converted to RGB565.
+     */
+    struct Image {
+        std::uint16_t width = 0;
+        std::uint16_t height = 0;
+        std::vector<std::uint16_t> pixels;
+    };
+
+    /**
+     * Reads the next whitespace-separated header token, skipping comments.
+     */
+    inline bool readToken(std::istream &in, std::string &token) {
+        token.clear();
+        int c;
+        while ((c = in.get()) != EOF) {
+            if (c == '#') {
+                while ((c = in.get()) != EOF && c != '\n');
+            } else if (!std::isspace(c)) {
+                token.push_back(char(c));
+                break;
+            }
+        }
+        while ((c = in.peek()) != EOF && !std::isspace(c)) {
+            token.push_back(char(in.get()));
+        }
+        return !token.empty();
+    }
+
+    /**
+     * Parses a decimal header token that must lie within 1 and maximum.
+     */
+    inline bool readNumber(const std::string &token, unsigned long maximum, unsigned long &value) {
+        if (token.empty() || !std::isdigit(static_cast<unsigned char>(token[0]))) {
+            return false;
+        }
+        char *end;
+        errno = 0;
+        value = std::strtoul(token.c_str(), &end, 10);
+        return !*end && !errno && value >= 1 && value <= maximum;
+    }
+
+    /**
+     * Reads a binary PPM (P6) with 8-bit channels into image.
+     *
+     * @param path
+     * @param image
+     * @return false if the file cannot be read, is not a P6 with a maxval of
+     *         255, or is empty or wider or taller than 65535 pixels.
+     */
+    inline bool readPpm(const char *path, Image &image) {
+        std::ifstream in(path, std::ios::binary);
+        std::string magic, widthToken, heightToken, maxvalToken;
+        unsigned long width, height, maxval;
+        if (!readToken(in, magic) || magic != "P6" || !readToken(in, widthToken)
+            || !readToken(in, heightToken) || !readToken(in, maxvalToken)
+            || !readNumber(widthToken, 0xFFFF, width) || !readNumber(heightToken, 0xFFFF, height)
+            || !readNumber(maxvalToken, 0xFFFF, maxval) || maxval != 255) {
+            return false;
+        }
+        in.get();
+        image.width = std::uint16_t(width);
+        image.height = std::uint16_t(height);
+        std::size_t count = std::size_t(image.width) * image.height;
+        std::vector<std::uint8_t> rgb(count * 3);
+        if (!in.read(reinterpret_cast<char *>(rgb.data()), rgb.size())) {
+            return false;
+        }
+        image.pixels.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            image.pixels[i] = rgb565(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+        return true;
+    }
+}
+
+#endif//__Kempozer_Screen_Tools_Ppm_h__
@@ -0,0 +1,205 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Summarizes a bus trace saved by TraceDriver and replays it into an
+ * emulated display controller, optionally writing the resulting picture.
+ *
+ *     TraceReplay [--size WIDTHxHEIGHT] [--events] [--output picture.ppm] trace.kst
+ *
+ * The summary lists, for every kind of event, how often it occurred and the
+ * time spent in it, followed by the data moved and the bus utilisation of
+ * the recorded session. --events also lists every event. --size is the
+ * native resolution of the recorded panel and defaults to 320x240.
+ */
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "Kempozer/Screen/MemoryDriver.h"
+#include "Kempozer/Screen/TraceReplayer.h"
+
+using Kempozer::Screen::MemoryDriver;
+using Kempozer::Screen::TraceEvent;
+using Kempozer::Screen::TraceRecord;
+using Kempozer::Screen::TraceReplayer;
+
+namespace {
+    bool readFile(const char *path, std::vector<std::uint8_t> &data) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    bool writePpm(const char *path, std::uint16_t width, std::uint16_t height, const std::uint16_t *pixels) {
+        std::FILE *file = std::fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "P6\n%u %u\n255\n", unsigned(width), unsigned(height));
+        for (std::size_t i = 0; i < std::size_t(width) * height; ++i) {
+            std::uint16_t color = pixels[i];
+            std::uint8_t rgb[3] = {
+                std::uint8_t((color >> 11) * 255 / 31),
+                std::uint8_t((color >> 5 & 0x3F) * 255 / 63),
+                std::uint8_t((color & 0x1F) * 255 / 31),
+            };
+            std::fwrite(rgb, 1, sizeof(rgb), file);
+        }
+        return std::fclose(file) == 0;
+    }
+
+    void printEvent(const TraceRecord &record) {
+        std::printf("%12" PRIu64 " %8" PRIu32 " %-22s", record.start, record.duration, TraceReplayer::name(record.event));
+        switch (record.event) {
+            case TraceEvent::AddressWindow:
+                std::printf(" %u,%u %u,%u", record.arguments[0], record.arguments[1],
+                            record.arguments[2], record.arguments[3]);
+                break;
+            case TraceEvent::ScrollArea:
+                std::printf(" %u %u %u", record.arguments[0], record.arguments[1], record.arguments[2]);
+                break;
+            case TraceEvent::Scroll:
+                std::printf(" %u", record.arguments[0]);
+                break;
+            case TraceEvent::PartialArea:
+                std::printf(" %u %u", record.arguments[0], record.arguments[1]);
+                break;
+            case TraceEvent::WriteArray:
+            case TraceEvent::WriteArray16:
+            case TraceEvent::Submit:
+            case TraceEvent::WritePixels:
+            case TraceEvent::ReadArray:
+            case TraceEvent::ReadArray16:
+            case TraceEvent::ReadPixels:
+                std::printf(" x%" PRIu32, record.count);
+                break;
+            case TraceEvent::Pause:
+                std::printf(" %" PRIu64 " ms", record.value);
+                break;
+            case TraceEvent::WriteRepeatedPixel:
+                std::printf(" x%" PRIu32 " 0x%04" PRIX64, record.count, record.value);
+                break;
+            case TraceEvent::Select:
+            case TraceEvent::Deselect:
+            case TraceEvent::AssertCommand:
+            case TraceEvent::DeassertCommand:
+            case TraceEvent::Wait:
+                break;
+            default:
+                std::printf(" 0x%" PRIX64, record.value);
+                break;
+        }
+        std::printf("\n");
+    }
+
+    int usage() {
+        std::fprintf(stderr, "usage: TraceReplay [--size WIDTHxHEIGHT] [--events] [--output picture.ppm] trace.kst\n");
+        return 2;
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned width = 320,
+             height = 240;
+    bool events = false;
+    const char *output = nullptr,
+               *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%ux%u", &width, &height) != 2 || !width || !height
+                || width > 0xFFFF || height > 0xFFFF) {
+                return usage();
+            }
+        } else if (!std::strcmp(argv[i], "--events")) {
+            events = true;
+        } else if (!std::strcmp(argv[i], "--output") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (!path) {
+        return usage();
+    }
+
+    std::vector<std::uint8_t> trace;
+    if (!readFile(path, trace)) {
+        std::fprintf(stderr, "TraceReplay: cannot read %s\n", path);
+        return 1;
+    }
+    TraceReplayer replayer(trace.data(), trace.size());
+    if (!replayer.valid()) {
+        std::fprintf(stderr, "TraceReplay: %s is not a version %u trace\n", path,
+                     unsigned(Kempozer::Screen::TraceDriver::VERSION));
+        return 1;
+    }
+
+    const char *unit = replayer.nanoseconds() ? "ns" : "us";
+    if (events) {
+        std::printf("# start[%s] duration[%s] event arguments\n", unit, unit);
+        TraceRecord record;
+        while (replayer.next(record)) {
+            printEvent(record);
+        }
+        replayer.rewind();
+    }
+
+    TraceReplayer::Summary summary = replayer.summarize();
+    std::printf("# %" PRIu32 " events retained of %" PRIu32 " recorded, %" PRIu32 " dropped\n",
+                summary.events, replayer.recorded(), replayer.dropped());
+    std::printf("# event calls ticks[%s]\n", unit);
+    for (std::size_t i = 0; i < std::size_t(TraceEvent::Count); ++i) {
+        if (summary.calls[i]) {
+            std::printf("%-22s %10" PRIu32 " %14" PRIu64 "\n", TraceReplayer::name(TraceEvent(i)),
+                        summary.calls[i], summary.ticks[i]);
+        }
+    }
+    std::printf("span %" PRIu64 " %s, busy %" PRIu64 " %s, %" PRIu64 " bytes, utilisation %.1f%%\n",
+                summary.span, unit, summary.busy, unit, summary.bytes,
+                100.0 * TraceReplayer::utilisation(summary));
+
+    std::vector<std::uint16_t> gram(std::size_t(width) * height);
+    MemoryDriver driver(std::uint16_t(width), std::uint16_t(height), gram.data());
+    driver.initialize();
+    replayer.replay(driver);
+    if (output && !writePpm(output, std::uint16_t(width), std::uint16_t(height), driver.gram())) {
+        std::fprintf(stderr, "TraceReplay: cannot write %s\n", output);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,397 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/Blit.h"
+#include "KempozerScreenConfig.h"
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#define KEMPOZER_SCREEN_SSE2 (1)
+#include <emmintrin.h>
+#endif
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && defined(__ARM_NEON)
+#define KEMPOZER_SCREEN_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        /**
+         * The part of a width by height image placed at (x, y) that lands on
+         * a target: offset within the image, position on the target, and
+         * size.
+         */
+        struct Clip {
+            std::uint16_t imageX, imageY;
+            std::uint16_t targetX, targetY;
+            std::uint16_t width, height;
+        };
+
+        bool clip(const Surface &target, std::int32_t x, std::int32_t y,
+                  std::uint16_t width, std::uint16_t height, Clip &clip) {
+            std::int32_t x1 = x < 0 ? 0 : x,
+                         y1 = y < 0 ? 0 : y,
+                         x2 = x + std::int32_t(width),
+                         y2 = y + std::int32_t(height);
+            x2 = x2 > target.width ? target.width : x2;
+            y2 = y2 > target.height ? target.height : y2;
+            if (x1 >= x2 || y1 >= y2) {
+                return false;
+            }
+            clip.imageX = std::uint16_t(x1 - x);
+            clip.imageY = std::uint16_t(y1 - y);
+            clip.targetX = std::uint16_t(x1);
+            clip.targetY = std::uint16_t(y1);
+            clip.width = std::uint16_t(x2 - x1);
+            clip.height = std::uint16_t(y2 - y1);
+            return true;
+        }
+
+        [[gnu::always_inline]]
+        inline const std::uint16_t *sourceRow(const ConstSurface &source, const Clip &clip, std::uint16_t row) {
+            return source.pixels + std::size_t(clip.imageY + row) * source.stride + clip.imageX;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t *targetRow(const Surface &target, const Clip &clip, std::uint16_t row) {
+            return target.pixels + std::size_t(clip.targetY + row) * target.stride + clip.targetX;
+        }
+
+#if KEMPOZER_SCREEN_SSE2
+        [[gnu::always_inline]]
+        inline __m128i load8(const std::uint16_t *p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        [[gnu::always_inline]]
+        inline void store8(std::uint16_t *p, __m128i v) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+        }
+
+        [[gnu::always_inline]]
+        inline __m128i reverse8(__m128i v) {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B);
+            return _mm_shuffle_epi32(v, 0x4E);
+        }
+
+        /**
+         * Transposes an 8x8 block of 16-bit values held one row per vector.
+         */
+        [[gnu::always_inline]]
+        inline void transpose8x8(__m128i r[8]) {
+            __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]), a1 = _mm_unpackhi_epi16(r[0], r[1]),
+                    a2 = _mm_unpacklo_epi16(r[2], r[3]), a3 = _mm_unpackhi_epi16(r[2], r[3]),
+                    a4 = _mm_unpacklo_epi16(r[4], r[5]), a5 = _mm_unpackhi_epi16(r[4], r[5]),
+                    a6 = _mm_unpacklo_epi16(r[6], r[7]), a7 = _mm_unpackhi_epi16(r[6], r[7]);
+            __m128i b0 = _mm_unpacklo_epi32(a0, a2), b1 = _mm_unpackhi_epi32(a0, a2),
+                    b2 = _mm_unpacklo_epi32(a1, a3), b3 = _mm_unpackhi_epi32(a1, a3),
+                    b4 = _mm_unpacklo_epi32(a4, a6), b5 = _mm_unpackhi_epi32(a4, a6),
+                    b6 = _mm_unpacklo_epi32(a5, a7), b7 = _mm_unpackhi_epi32(a5, a7);
+            r[0] = _mm_unpacklo_epi64(b0, b4);
+            r[1] = _mm_unpackhi_epi64(b0, b4);
+            r[2] = _mm_unpacklo_epi64(b1, b5);
+            r[3] = _mm_unpackhi_epi64(b1, b5);
+            r[4] = _mm_unpacklo_epi64(b2, b6);
+            r[5] = _mm_unpackhi_epi64(b2, b6);
+            r[6] = _mm_unpacklo_epi64(b3, b7);
+            r[7] = _mm_unpackhi_epi64(b3, b7);
+        }
+#endif
+
+#if KEMPOZER_SCREEN_NEON
+        [[gnu::always_inline]]
+        inline uint16x8_t reverse8(uint16x8_t v) {
+            v = vrev64q_u16(v);
+            return vcombine_u16(vget_high_u16(v), vget_low_u16(v));
+        }
+#endif
+
+        /**
+         * Reverses count pixels of in into out.
+         */
+        void reverseRow(std::uint16_t *out, const std::uint16_t *in, std::size_t count) {
+            std::size_t i = 0;
+#if KEMPOZER_SCREEN_SSE2
+            for (; i + 8 <= count; i += 8) {
+                store8(out + i, reverse8(load8(in - i - 7)));
+            }
+#elif KEMPOZER_SCREEN_NEON
+            for (; i + 8 <= count; i += 8) {
+                vst1q_u16(out + i, reverse8(vld1q_u16(in - i - 7)));
+            }
+#endif
+            for (; i < count; ++i) {
+                out[i] = *(in - i);
+            }
+        }
+
+        /**
+         * Fills a width by height block of out, whose rows are outStride
+         * apart, with a quarter turn of the source: pixel (i, j) of the block
+         * comes from in[i * stepX + j * stepY], where exactly one of the steps
+         * is 1 or -1.
+         */
+        void transposeBlock(std::uint16_t *out, std::size_t outStride, const std::uint16_t *in,
+                            std::ptrdiff_t stepX, std::ptrdiff_t stepY,
+                            std::uint16_t width, std::uint16_t height) {
+            std::uint16_t j = 0;
+#if KEMPOZER_SCREEN_SSE2
+            // Eight source rows at a time become eight target rows. With a
+            // step of -1 along the target column, each source load runs
+            // backwards, so the transposed rows come out in reverse.
+            bool reversed = stepY < 0;
+            for (; j + 8 <= height; j += 8) {
+                std::uint16_t i = 0;
+                for (; i + 8 <= width; i += 8) {
+                    const std::uint16_t *block = in + std::ptrdiff_t(i) * stepX + std::ptrdiff_t(j) * stepY;
+                    __m128i rows[8];
+                    for (int k = 0; k < 8; ++k) {
+                        rows[k] = load8(block + k * stepX - (reversed ? 7 : 0));
+                    }
+                    transpose8x8(rows);
+                    for (int k = 0; k < 8; ++k) {
+                        store8(out + std::size_t(j + (reversed ? 7 - k : k)) * outStride + i, rows[k]);
+                    }
+                }
+                for (std::uint16_t r = j; r < j + 8; ++r) {
+                    for (std::uint16_t c = i; c < width; ++c) {
+                        out[std::size_t(r) * outStride + c] = in[std::ptrdiff_t(c) * stepX + std::ptrdiff_t(r) * stepY];
+                    }
+                }
+            }
+#endif
+            for (; j < height; ++j) {
+                for (std::uint16_t i = 0; i < width; ++i) {
+                    out[std::size_t(j) * outStride + i] = in[std::ptrdiff_t(i) * stepX + std::ptrdiff_t(j) * stepY];
+                }
+            }
+        }
+    }
+
+    void blit(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source) {
+        Clip area;
+        if (!clip(target, x, y, source.width, source.height, area)) {
+            return;
+        }
+        for (std::uint16_t row = 0; row < area.height; ++row) {
+            std::memcpy(targetRow(target, area, row), sourceRow(source, area, row),
+                        std::size_t(area.width) * sizeof(std::uint16_t));
+        }
+    }
+
+    void blitRotated(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                     int rotation) {
+        rotation &= 3;
+        if (!rotation) {
+            return blit(target, x, y, source);
+        }
+        bool swapped = rotation & 1;
+        Clip area;
+        if (!clip(target, x, y, swapped ? source.height : source.width,
+                  swapped ? source.width : source.height, area)) {
+            return;
+        }
+        // Walk from the source pixel that lands on the rotated image's
+        // top-left corner; stepX and stepY move one pixel right and down in
+        // the rotated image.
+        std::ptrdiff_t stride = std::ptrdiff_t(source.stride),
+                       lastRow = std::ptrdiff_t(source.height - 1) * stride,
+                       lastColumn = source.width - 1,
+                       origin, stepX, stepY;
+        switch (rotation) {
+            case 1:
+                origin = lastRow;
+                stepX = -stride;
+                stepY = 1;
+                break;
+            case 2:
+                origin = lastRow + lastColumn;
+                stepX = -1;
+                stepY = -stride;
+                break;
+            default:
+                origin = lastColumn;
+                stepX = stride;
+                stepY = -1;
+                break;
+        }
+        const std::uint16_t *in = source.pixels + origin
+                                + std::ptrdiff_t(area.imageX) * stepX + std::ptrdiff_t(area.imageY) * stepY;
+        std::uint16_t *out = targetRow(target, area, 0);
+        if (rotation == 2) {
+            for (std::uint16_t row = 0; row < area.height; ++row) {
+                reverseRow(out + std::size_t(row) * target.stride, in + std::ptrdiff_t(row) * stepY, area.width);
+            }
+            return;
+        }
+        constexpr std::uint16_t BLOCK = KEMPOZER_SCREEN_BLIT_BLOCK;
+        for (std::uint16_t by = 0; by < area.height; by += BLOCK) {
+            std::uint16_t height = area.height - by < BLOCK ? area.height - by : BLOCK;
+            for (std::uint16_t bx = 0; bx < area.width; bx += BLOCK) {
+                std::uint16_t width = area.width - bx < BLOCK ? area.width - bx : BLOCK;
+                transposeBlock(out + std::size_t(by) * target.stride + bx, target.stride,
+                               in + std::ptrdiff_t(bx) * stepX + std::ptrdiff_t(by) * stepY,
+                               stepX, stepY, width, height);
+            }
+        }
+    }
+
+    void blitKeyed(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                   std::uint16_t key) {
+        Clip area;
+        if (!clip(target, x, y, source.width, source.height, area)) {
+            return;
+        }
+        for (std::uint16_t row = 0; row < area.height; ++row) {
+            const std::uint16_t *in = sourceRow(source, area, row);
+            std::uint16_t *out = targetRow(target, area, row);
+            std::size_t i = 0;
+#if KEMPOZER_SCREEN_SSE2
+            __m128i keys = _mm_set1_epi16(std::int16_t(key));
+            for (; i + 8 <= area.width; i += 8) {
+                __m128i pixels = load8(in + i),
+                        transparent = _mm_cmpeq_epi16(pixels, keys);
+                store8(out + i, _mm_or_si128(_mm_and_si128(transparent, load8(out + i)),
+                                             _mm_andnot_si128(transparent, pixels)));
+            }
+#elif KEMPOZER_SCREEN_NEON
+            uint16x8_t keys = vdupq_n_u16(key);
+            for (; i + 8 <= area.width; i += 8) {
+                uint16x8_t pixels = vld1q_u16(in + i);
+                vst1q_u16(out + i, vbslq_u16(vceqq_u16(pixels, keys), vld1q_u16(out + i), pixels));
+            }
+#endif
+            for (; i < area.width; ++i) {
+                if (in[i] != key) {
+                    out[i] = in[i];
+                }
+            }
+        }
+    }
+
+    void blitMasked(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                    const std::uint8_t *mask, std::size_t maskStride) {
+        Clip area;
+        if (!clip(target, x, y, source.width, source.height, area)) {
+            return;
+        }
+        for (std::uint16_t row = 0; row < area.height; ++row) {
+            const std::uint16_t *in = sourceRow(source, area, row);
+            const std::uint8_t *bits = mask + std::size_t(area.imageY + row) * maskStride;
+            std::uint16_t *out = targetRow(target, area, row);
+            std::size_t i = 0;
+#if KEMPOZER_SCREEN_SSE2 || KEMPOZER_SCREEN_NEON
+            for (; i + 8 <= area.width; i += 8) {
+                // Gather the 8 mask bits of these pixels, which may straddle
+                // two bytes when the image is clipped on the left.
+                std::size_t bit = area.imageX + i;
+                unsigned shift = bit & 7;
+                std::uint8_t byte = bits[bit >> 3];
+                if (shift) {
+                    byte = std::uint8_t((byte << shift) | (bits[(bit >> 3) + 1] >> (8 - shift)));
+                }
+#if KEMPOZER_SCREEN_SSE2
+                const __m128i select = _mm_setr_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+                __m128i opaque = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(byte), select), select);
+                store8(out + i, _mm_or_si128(_mm_and_si128(opaque, load8(in + i)),
+                                             _mm_andnot_si128(opaque, load8(out + i))));
+#else
+                static const std::uint16_t SELECT[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+                uint16x8_t opaque = vtstq_u16(vdupq_n_u16(byte), vld1q_u16(SELECT));
+                vst1q_u16(out + i, vbslq_u16(opaque, vld1q_u16(in + i), vld1q_u16(out + i)));
+#endif
+            }
+#endif
+            for (; i < area.width; ++i) {
+                std::size_t bit = area.imageX + i;
+                if (bits[bit >> 3] & (0x80 >> (bit & 7))) {
+                    out[i] = in[i];
+                }
+            }
+        }
+    }
+
+    void blitBlended(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                     const std::uint8_t *alpha, std::size_t alphaStride) {
+        Clip area;
+        if (!clip(target, x, y, source.width, source.height, area)) {
+            return;
+        }
+        for (std::uint16_t row = 0; row < area.height; ++row) {
+            const std::uint16_t *in = sourceRow(source, area, row);
+            const std::uint8_t *opacity = alpha + std::size_t(area.imageY + row) * alphaStride + area.imageX;
+            std::uint16_t *out = targetRow(target, area, row);
+            std::size_t i = 0;
+#if KEMPOZER_SCREEN_SSE2
+            const __m128i six = _mm_set1_epi16(0x3F),
+                          five = _mm_set1_epi16(0x1F),
+                          full = _mm_set1_epi16(256);
+            for (; i + 8 <= area.width; i += 8) {
+                __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(opacity + i)),
+                                              _mm_setzero_si128());
+                a = _mm_add_epi16(a, _mm_srli_epi16(a, 7));
+                __m128i inverse = _mm_sub_epi16(full, a),
+                        fg = load8(in + i),
+                        bg = load8(out + i),
+                        r = _mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(fg, 11), a),
+                                          _mm_mullo_epi16(_mm_srli_epi16(bg, 11), inverse)),
+                        g = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(fg, 5), six), a),
+                                          _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(bg, 5), six), inverse)),
+                        b = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(fg, five), a),
+                                          _mm_mullo_epi16(_mm_and_si128(bg, five), inverse));
+                r = _mm_slli_epi16(_mm_srli_epi16(r, 8), 11);
+                g = _mm_slli_epi16(_mm_srli_epi16(g, 8), 5);
+                b = _mm_srli_epi16(b, 8);
+                store8(out + i, _mm_or_si128(_mm_or_si128(r, g), b));
+            }
+#elif KEMPOZER_SCREEN_NEON
+            const uint16x8_t six = vdupq_n_u16(0x3F),
+                             five = vdupq_n_u16(0x1F),
+                             full = vdupq_n_u16(256);
+            for (; i + 8 <= area.width; i += 8) {
+                uint16x8_t a = vmovl_u8(vld1_u8(opacity + i));
+                a = vaddq_u16(a, vshrq_n_u16(a, 7));
+                uint16x8_t inverse = vsubq_u16(full, a),
+                           fg = vld1q_u16(in + i),
+                           bg = vld1q_u16(out + i),
+                           r = vmlaq_u16(vmulq_u16(vshrq_n_u16(fg, 11), a), vshrq_n_u16(bg, 11), inverse),
+                           g = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(fg, 5), six), a),
+                                         vandq_u16(vshrq_n_u16(bg, 5), six), inverse),
+                           b = vmlaq_u16(vmulq_u16(vandq_u16(fg, five), a), vandq_u16(bg, five), inverse);
+                uint16x8_t blended = vshlq_n_u16(vshrq_n_u16(r, 8), 11);
+                blended = vorrq_u16(blended, vshlq_n_u16(vshrq_n_u16(g, 8), 5));
+                vst1q_u16(out + i, vorrq_u16(blended, vshrq_n_u16(b, 8)));
+            }
+#endif
+            for (; i < area.width; ++i) {
+                out[i] = blendAlpha8(in[i], out[i], opacity[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Blit_h__
+#define __Kempozer_Screen_Blit_h__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Kempozer::Screen {
+
+    /**
+     * A read-only RGB565 image in memory. stride is the distance, in pixels,
+     * between the starts of consecutive rows.
+     */
+    struct ConstSurface {
+        const std::uint16_t *pixels;
+        std::uint16_t width;
+        std::uint16_t height;
+        std::size_t stride;
+    };
+
+    /**
+     * A writable RGB565 image in memory, such as a frame or tile buffer that
+     * is later sent with {@link Driver::writePixels}.
+     */
+    struct Surface {
+        std::uint16_t *pixels;
+        std::uint16_t width;
+        std::uint16_t height;
+        std::size_t stride;
+
+        [[gnu::always_inline]]
+        inline operator ConstSurface() const {
+            return ConstSurface{pixels, width, height, stride};
+        }
+    };
+
+    /**
+     * Copies source into target with its top-left corner at (x, y), clipped
+     * to target. source and target must not overlap.
+     *
+     * @param target
+     * @param x
+     * @param y
+     * @param source
+     */
+    void blit(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source);
+
+    /**
+     * Copies source into target rotated clockwise by rotation quarter turns,
+     * with the top-left corner of the rotated image at (x, y), clipped to
+     * target. This is the same rotation {@link Driver::transform} applies, so
+     * a frame drawn in logical coordinates can be rotated into native order.
+     *
+     * Quarter turns walk the source in blocks of KEMPOZER_SCREEN_BLIT_BLOCK
+     * square pixels so that both images stay in cache. source and target must
+     * not overlap.
+     *
+     * @param target
+     * @param x
+     * @param y
+     * @param source
+     * @param rotation
+     */
+    void blitRotated(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                     int rotation);
+
+    /**
+     * Copies the pixels of source that are not key into target with its
+     * top-left corner at (x, y), clipped to target.
+     *
+     * @param target
+     * @param x
+     * @param y
+     * @param source
+     * @param key
+     */
+    void blitKeyed(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                   std::uint16_t key);
+
+    /**
+     * Copies the pixels of source whose bit is set in mask into target with
+     * its top-left corner at (x, y), clipped to target. mask holds one bit
+     * per source pixel, most significant bit first, with rows maskStride
+     * bytes apart.
+     *
+     * @param target
+     * @param x
+     * @param y
+     * @param source
+     * @param mask
+     * @param maskStride
+     */
+    [[gnu::nonnull]]
+    void blitMasked(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                    const std::uint8_t *mask, std::size_t maskStride);
+
+    /**
+     * Blends source over target with its top-left corner at (x, y), clipped
+     * to target. alpha holds one 8-bit opacity per source pixel, with rows
+     * alphaStride bytes apart; 0 keeps target and 255 takes source.
+     *
+     * @param target
+     * @param x
+     * @param y
+     * @param source
+     * @param alpha
+     * @param alphaStride
+     */
+    [[gnu::nonnull]]
+    void blitBlended(const Surface &target, std::int32_t x, std::int32_t y, const ConstSurface &source,
+                     const std::uint8_t *alpha, std::size_t alphaStride);
+
+    /**
+     * Blends one RGB565 pixel over another with an 8-bit opacity, exactly as
+     * {@link blitBlended} does.
+     *
+     * @param foreground
+     * @param background
+     * @param alpha
+     * @return
+     */
+    [[gnu::always_inline]]
+    inline std::uint16_t blendAlpha8(std::uint16_t foreground, std::uint16_t background, std::uint8_t alpha) {
+        std::uint32_t a = alpha + (alpha >> 7),
+                      r = ((foreground >> 11) * a + (background >> 11) * (256 - a)) >> 8,
+                      g = (((foreground >> 5) & 0x3F) * a + ((background >> 5) & 0x3F) * (256 - a)) >> 8,
+                      b = ((foreground & 0x1F) * a + (background & 0x1F) * (256 - a)) >> 8;
+        return std::uint16_t((r << 11) | (g << 5) | b);
+    }
+}
+
+#endif//__Kempozer_Screen_Blit_h__
@@ -0,0 +1,181 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/Canvas.h"
+
+namespace Kempozer::Screen {
+    Canvas::Canvas(Driver &driver)
+        : mDriver(driver) {
+        mGlyphCache = nullptr;
+    }
+
+    Canvas *Canvas::clear(std::uint16_t color) {
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        Rect rect{0, 0, std::uint16_t(width - 1), std::uint16_t(height - 1)};
+        mDriver.transform(rect);
+        mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+        mDriver.writeRepeatedPixel(std::size_t(width) * height, color);
+        return this;
+    }
+
+    Canvas *Canvas::fillRect(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height,
+                             std::uint16_t color) {
+        Rect rect;
+        if (clip(x, y, width, height, rect)) {
+            mDriver.transform(rect);
+            mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+            mDriver.writeRepeatedPixel(rect.area(), color);
+        }
+        return this;
+    }
+
+    Canvas *Canvas::drawSpan(std::int16_t x, std::int16_t y, std::int16_t width, const std::uint16_t *pixels) {
+        Rect rect;
+        if (clip(x, y, width, 1, rect)) {
+            span(rect, pixels + (rect.x1 - x));
+        }
+        return this;
+    }
+
+    Canvas *Canvas::drawRect(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height,
+                             std::uint16_t color) {
+        if (width <= 0 || height <= 0) {
+            return this;
+        }
+        hline(x, y, width, color);
+        if (height > 1) {
+            hline(x, y + height - 1, width, color);
+        }
+        if (height > 2) {
+            vline(x, y + 1, height - 2, color);
+            if (width > 1) {
+                vline(x + width - 1, y + 1, height - 2, color);
+            }
+        }
+        return this;
+    }
+
+    Canvas *Canvas::drawText(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                             std::uint16_t foreground, std::uint16_t background) {
+        std::int16_t column = x;
+        for (; *text; ++text) {
+            std::uint8_t character = std::uint8_t(*text);
+            if (character == '\n') {
+                column = x;
+                y += font.height;
+                continue;
+            }
+            const Glyph *glyph = font.glyph(character);
+            if (!glyph) {
+                continue;
+            }
+            Rect rect;
+            if (clip(column, y, glyph->advance, font.height, rect)) {
+                std::uint16_t skipLeft = std::uint16_t(rect.x1 - column),
+                              skipTop = std::uint16_t(rect.y1 - y);
+                const std::uint16_t *cell = mGlyphCache
+                                          ? mGlyphCache->lookup(font, *glyph, foreground, background)
+                                          : nullptr;
+                if (!mDriver.hardwareRotation()) {
+                    std::uint16_t row[256];
+                    Rect line = rect;
+                    for (std::uint16_t r = 0; r < rect.height(); ++r) {
+                        const std::uint16_t *source = row;
+                        if (cell) {
+                            source = cell + std::size_t(skipTop + r) * glyph->advance;
+                        } else {
+                            rasterizeGlyph(font, *glyph, foreground, background, skipTop + r, 1, row);
+                        }
+                        line.y1 = line.y2 = rect.y1 + r;
+                        span(line, source + skipLeft);
+                    }
+                } else if (cell && rect.width() == glyph->advance) {
+                    mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+                    mDriver.writePixels(rect.area(), cell + std::size_t(skipTop) * glyph->advance);
+                } else {
+                    mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+                    // Uncached or clipped cells are sent a row at a time.
+                    std::uint16_t row[256];
+                    for (std::uint16_t r = 0; r < rect.height(); ++r) {
+                        const std::uint16_t *source = row;
+                        if (cell) {
+                            source = cell + std::size_t(skipTop + r) * glyph->advance;
+                        } else {
+                            rasterizeGlyph(font, *glyph, foreground, background, skipTop + r, 1, row);
+                        }
+                        mDriver.writePixels(rect.width(), source + skipLeft);
+                    }
+                }
+            }
+            column += glyph->advance;
+        }
+        return this;
+    }
+
+    void Canvas::span(const Rect &rect, const std::uint16_t *pixels) {
+        Rect window = rect;
+        mDriver.transform(window);
+        mDriver.setAddressWindow(window.x1, window.y1, window.x2, window.y2);
+        std::size_t count = rect.width();
+        if (mDriver.hardwareRotation() || mDriver.rotation() < 2) {
+            mDriver.writePixels(count, pixels);
+            return;
+        }
+        // At 180 and 270 degrees the native window runs right to left.
+        std::uint16_t reversed[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        while (count) {
+            std::size_t chunk = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            for (std::size_t i = 0; i < chunk; ++i) {
+                reversed[i] = pixels[count - 1 - i];
+            }
+            mDriver.writePixels(chunk, reversed);
+            count -= chunk;
+        }
+    }
+
+    bool Canvas::clip(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height, Rect &rect) {
+        if (width <= 0 || height <= 0) {
+            return false;
+        }
+        std::uint16_t screenWidth, screenHeight;
+        mDriver.resolution(screenWidth, screenHeight);
+        std::int32_t x1 = x,
+                     y1 = y,
+                     x2 = std::int32_t(x) + width - 1,
+                     y2 = std::int32_t(y) + height - 1;
+        if (x2 < 0 || y2 < 0 || x1 >= screenWidth || y1 >= screenHeight) {
+            return false;
+        }
+        rect.x1 = std::uint16_t(x1 < 0 ? 0 : x1);
+        rect.y1 = std::uint16_t(y1 < 0 ? 0 : y1);
+        rect.x2 = std::uint16_t(x2 >= screenWidth ? screenWidth - 1 : x2);
+        rect.y2 = std::uint16_t(y2 >= screenHeight ? screenHeight - 1 : y2);
+        return true;
+    }
+}
@@ -0,0 +1,195 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Canvas_h__
+#define __Kempozer_Screen_Canvas_h__
+
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Font.h"
+#include "Kempozer/Screen/GlyphCache.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Solid-color drawing primitives over a {@link Driver}. Every span is
+     * clipped to the screen and drawn with exactly one
+     * {@link Driver::setAddressWindow} and one
+     * {@link Driver::writeRepeatedPixel}, never pixel by pixel.
+     *
+     * Coordinates are signed so that shapes may hang off any edge of the
+     * screen. They are logical coordinates: if the driver cannot apply its
+     * rotation itself, the canvas maps every span through
+     * {@link Driver::transform(Rect &)} so that drawing still costs one
+     * window per span.
+     */
+    class Canvas {
+    public:
+        /**
+         * Creates a canvas drawing to driver, which must outlive it.
+         *
+         * @param driver
+         */
+        explicit Canvas(Driver &driver);
+
+        /**
+         * Gets the driver this canvas draws to.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline Driver &driver() {
+            return mDriver;
+        }
+
+        /**
+         * Fills the whole screen with color.
+         *
+         * @param color
+         */
+        Canvas *clear(std::uint16_t color);
+
+        /**
+         * Fills a width by height rectangle with its top-left corner at (x, y).
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param height
+         * @param color
+         */
+        Canvas *fillRect(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height,
+                         std::uint16_t color);
+
+        /**
+         * Draws a horizontal line of width pixels starting at (x, y).
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param color
+         */
+        [[gnu::always_inline]]
+        inline Canvas *hline(std::int16_t x, std::int16_t y, std::int16_t width, std::uint16_t color) {
+            return fillRect(x, y, width, 1, color);
+        }
+
+        /**
+         * Draws a vertical line of height pixels starting at (x, y).
+         *
+         * @param x
+         * @param y
+         * @param height
+         * @param color
+         */
+        [[gnu::always_inline]]
+        inline Canvas *vline(std::int16_t x, std::int16_t y, std::int16_t height, std::uint16_t color) {
+            return fillRect(x, y, 1, height, color);
+        }
+
+        /**
+         * Draws the one pixel wide outline of a width by height rectangle
+         * with its top-left corner at (x, y).
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param height
+         * @param color
+         */
+        Canvas *drawRect(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height,
+                         std::uint16_t color);
+
+        /**
+         * Draws a horizontal run of width pixels starting at (x, y) with one
+         * {@link Driver::setAddressWindow}.
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param pixels
+         */
+        [[gnu::nonnull]]
+        Canvas *drawSpan(std::int16_t x, std::int16_t y, std::int16_t width, const std::uint16_t *pixels);
+
+        /**
+         * Sets the cache that {@link drawText} takes rasterized glyphs from,
+         * or nullptr to rasterize every glyph as it is drawn. The cache must
+         * outlive this canvas or be unset first.
+         *
+         * @param cache
+         */
+        [[gnu::always_inline]]
+        inline Canvas *glyphCache(GlyphCache *cache) {
+            mGlyphCache = cache;
+            return this;
+        }
+
+        /**
+         * Draws text with the top-left corner of its first line at (x, y),
+         * in foreground over background. Each glyph is drawn as its whole
+         * cell with one {@link Driver::setAddressWindow} and, when the cell is
+         * entirely on screen and in the glyph cache, one
+         * {@link Driver::writePixels}. If the rotation is applied in
+         * software, each row of the cell is drawn as a span instead. A
+         * newline starts a new line below x; characters the font lacks are
+         * skipped.
+         *
+         * @param font
+         * @param x
+         * @param y
+         * @param text
+         * @param foreground
+         * @param background
+         */
+        [[gnu::nonnull]]
+        Canvas *drawText(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                         std::uint16_t foreground, std::uint16_t background);
+    protected:
+        /**
+         * Clips a width by height rectangle with its top-left corner at (x, y)
+         * to the screen.
+         *
+         * @return Whether any of the rectangle is on screen.
+         */
+        bool clip(std::int16_t x, std::int16_t y, std::int16_t width, std::int16_t height, Rect &rect);
+
+        /**
+         * Sends a clipped, one pixel tall span in logical left to right
+         * order, reversing it if the rotation is applied in software and
+         * runs the span against the native axis.
+         */
+        void span(const Rect &rect, const std::uint16_t *pixels);
+
+        Driver &mDriver;
+        GlyphCache *mGlyphCache;
+    };
+}
+
+#endif//__Kempozer_Screen_Canvas_h__
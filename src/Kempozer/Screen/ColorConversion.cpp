@@ -0,0 +1,414 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/ColorConversion.h"
+#include "KempozerScreenConfig.h"
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && defined(__AVX2__)
+#define KEMPOZER_SCREEN_AVX2 (1)
+#include <immintrin.h>
+#endif
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && defined(__SSSE3__)
+#define KEMPOZER_SCREEN_SSSE3 (1)
+#include <tmmintrin.h>
+#endif
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#define KEMPOZER_SCREEN_SSE2 (1)
+#include <emmintrin.h>
+#endif
+
+#if KEMPOZER_SCREEN_ENABLE_SIMD && defined(__ARM_NEON)
+#define KEMPOZER_SCREEN_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        /**
+         * The 4x4 Bayer threshold matrix.
+         */
+        constexpr std::uint8_t BAYER[4][4] = {
+            { 0,  8,  2, 10},
+            {12,  4, 14,  6},
+            { 3, 11,  1,  9},
+            {15,  7, 13,  5},
+        };
+
+        [[gnu::always_inline]]
+        inline std::uint16_t argbToRgb565(std::uint32_t argb) {
+            return std::uint16_t(((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F));
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint8_t saturatingAdd(std::uint32_t channel, std::uint8_t offset) {
+            channel = (channel & 0xFF) + offset;
+            return std::uint8_t(channel > 0xFF ? 0xFF : channel);
+        }
+
+        /**
+         * Gets the dither offset of each channel of a pixel, laid out like an
+         * ARGB8888 pixel. The 5-bit channels lose 3 bits and the 6-bit green
+         * channel loses 2, so the thresholds are scaled to match.
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t ditherOffsets(std::uint16_t x, std::uint16_t y) {
+            std::uint32_t threshold = BAYER[y & 3][x & 3];
+            return ((threshold >> 1) << 16) | ((threshold >> 2) << 8) | (threshold >> 1);
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t ditheredRgb565(std::uint32_t argb, std::uint32_t offsets) {
+            return rgb565(saturatingAdd(argb >> 16, std::uint8_t(offsets >> 16)),
+                          saturatingAdd(argb >> 8, std::uint8_t(offsets >> 8)),
+                          saturatingAdd(argb, std::uint8_t(offsets)));
+        }
+
+#if KEMPOZER_SCREEN_SSE2
+        /**
+         * Converts 4 ARGB8888 pixels into the low 16 bits of each 32-bit lane,
+         * sign-extended so that a signed saturating pack preserves them.
+         */
+        [[gnu::always_inline]]
+        inline __m128i argbToRgb565x4(__m128i argb) {
+            __m128i r = _mm_and_si128(_mm_srli_epi32(argb, 8), _mm_set1_epi32(0xF800)),
+                    g = _mm_and_si128(_mm_srli_epi32(argb, 5), _mm_set1_epi32(0x07E0)),
+                    b = _mm_and_si128(_mm_srli_epi32(argb, 3), _mm_set1_epi32(0x001F)),
+                    rgb = _mm_or_si128(_mm_or_si128(r, g), b);
+            return _mm_srai_epi32(_mm_slli_epi32(rgb, 16), 16);
+        }
+
+        /**
+         * Spreads the first 4 RGB888 pixels of a load into 32-bit lanes, red in
+         * the low byte, using byte shifts and unpacks only.
+         */
+        [[gnu::always_inline]]
+        inline __m128i spreadRgb888x4(__m128i rgb) {
+            __m128i first = _mm_unpacklo_epi32(rgb, _mm_srli_si128(rgb, 3)),
+                    second = _mm_unpacklo_epi32(_mm_srli_si128(rgb, 6), _mm_srli_si128(rgb, 9));
+            return _mm_unpacklo_epi64(first, second);
+        }
+
+        /**
+         * Converts 4 pixels from {@link spreadRgb888x4} like {@link argbToRgb565x4}.
+         */
+        [[gnu::always_inline]]
+        inline __m128i rgbxToRgb565x4(__m128i rgbx) {
+            __m128i r = _mm_and_si128(_mm_slli_epi32(rgbx, 8), _mm_set1_epi32(0xF800)),
+                    g = _mm_and_si128(_mm_srli_epi32(rgbx, 5), _mm_set1_epi32(0x07E0)),
+                    b = _mm_and_si128(_mm_srli_epi32(rgbx, 19), _mm_set1_epi32(0x001F)),
+                    rgb = _mm_or_si128(_mm_or_si128(r, g), b);
+            return _mm_srai_epi32(_mm_slli_epi32(rgb, 16), 16);
+        }
+
+        /**
+         * Expands 8 RGB565 pixels into two vectors of 4 pixels each in 32-bit
+         * lanes, red in the low byte, replicating the top bits into the bottom
+         * ones like the scalar path.
+         */
+        [[gnu::always_inline]]
+        inline void rgb565ToRgbx8(__m128i pixels, __m128i &low, __m128i &high) {
+            __m128i r = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(pixels, 8), _mm_set1_epi16(0xF8)),
+                                     _mm_srli_epi16(pixels, 13)),
+                    g = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(pixels, 3), _mm_set1_epi16(0xFC)),
+                                     _mm_and_si128(_mm_srli_epi16(pixels, 9), _mm_set1_epi16(0x03))),
+                    b = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(pixels, 3), _mm_set1_epi16(0xF8)),
+                                     _mm_and_si128(_mm_srli_epi16(pixels, 2), _mm_set1_epi16(0x07))),
+                    rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+            low = _mm_unpacklo_epi16(rg, b);
+            high = _mm_unpackhi_epi16(rg, b);
+        }
+
+        /**
+         * Packs 4 pixels in 32-bit lanes into 12 bytes of RGB888 at the bottom
+         * of the vector; the top 4 bytes are zero.
+         */
+        [[gnu::always_inline]]
+        inline __m128i packRgbx4(__m128i rgbx) {
+            const __m128i even = _mm_set_epi32(0, -1, 0, -1);
+            __m128i pairs = _mm_or_si128(_mm_and_si128(rgbx, even),
+                                         _mm_srli_epi64(_mm_andnot_si128(even, rgbx), 8));
+            return _mm_or_si128(_mm_move_epi64(pairs), _mm_srli_si128(_mm_unpackhi_epi64(_mm_setzero_si128(), pairs), 2));
+        }
+#endif
+
+#if KEMPOZER_SCREEN_AVX2
+        [[gnu::always_inline]]
+        inline __m256i argbToRgb565x8(__m256i argb) {
+            __m256i r = _mm256_and_si256(_mm256_srli_epi32(argb, 8), _mm256_set1_epi32(0xF800)),
+                    g = _mm256_and_si256(_mm256_srli_epi32(argb, 5), _mm256_set1_epi32(0x07E0)),
+                    b = _mm256_and_si256(_mm256_srli_epi32(argb, 3), _mm256_set1_epi32(0x001F)),
+                    rgb = _mm256_or_si256(_mm256_or_si256(r, g), b);
+            return _mm256_srai_epi32(_mm256_slli_epi32(rgb, 16), 16);
+        }
+
+        /**
+         * Packs two vectors from {@link argbToRgb565x8} into 16 pixels in order.
+         */
+        [[gnu::always_inline]]
+        inline __m256i pack16(__m256i low, __m256i high) {
+            return _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+        }
+
+        /**
+         * Spreads the first 8 RGB888 pixels of a load into ARGB8888 lanes:
+         * the first 12 bytes go to the low half, the next 12 to the high half,
+         * and each half is shuffled like the SSSE3 path.
+         */
+        [[gnu::always_inline]]
+        inline __m256i spreadRgb888x8(__m256i rgb) {
+            const __m256i halves = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6),
+                          spread = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                                    2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+            return _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(rgb, halves), spread);
+        }
+
+        /**
+         * Does {@link rgb565ToRgbx8} on each half of 16 pixels.
+         */
+        [[gnu::always_inline]]
+        inline void rgb565ToRgbx16(__m256i pixels, __m256i &low, __m256i &high) {
+            __m256i r = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(pixels, 8), _mm256_set1_epi16(0xF8)),
+                                        _mm256_srli_epi16(pixels, 13)),
+                    g = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(pixels, 3), _mm256_set1_epi16(0xFC)),
+                                        _mm256_and_si256(_mm256_srli_epi16(pixels, 9), _mm256_set1_epi16(0x03))),
+                    b = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(pixels, 3), _mm256_set1_epi16(0xF8)),
+                                        _mm256_and_si256(_mm256_srli_epi16(pixels, 2), _mm256_set1_epi16(0x07))),
+                    rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+            low = _mm256_unpacklo_epi16(rg, b);
+            high = _mm256_unpackhi_epi16(rg, b);
+        }
+
+        /**
+         * Does {@link packRgbx4} on each half of 8 pixels.
+         */
+        [[gnu::always_inline]]
+        inline __m256i packRgbx8(__m256i rgbx) {
+            const __m256i even = _mm256_set_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+            __m256i pairs = _mm256_or_si256(_mm256_and_si256(rgbx, even),
+                                            _mm256_srli_epi64(_mm256_andnot_si256(even, rgbx), 8));
+            return _mm256_or_si256(_mm256_unpacklo_epi64(pairs, _mm256_setzero_si256()),
+                                   _mm256_srli_si256(_mm256_unpackhi_epi64(_mm256_setzero_si256(), pairs), 2));
+        }
+#endif
+
+#if KEMPOZER_SCREEN_NEON
+        [[gnu::always_inline]]
+        inline uint16x8_t rgbToRgb565x8(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+            uint16x8_t rgb = vshll_n_u8(r, 8);
+            rgb = vsriq_n_u16(rgb, vshll_n_u8(g, 8), 5);
+            return vsriq_n_u16(rgb, vshll_n_u8(b, 8), 11);
+        }
+#endif
+    }
+
+    void rgb888ToRgb565(std::size_t count, const std::uint8_t *rgb, std::uint16_t *out) {
+        std::size_t i = 0;
+#if KEMPOZER_SCREEN_AVX2
+        // Each 32 byte load covers 8 pixels and reads 8 bytes past them.
+        for (; (i + 16) * 3 + 8 <= count * 3; i += 16) {
+            __m256i low = spreadRgb888x8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(rgb + i * 3))),
+                    high = spreadRgb888x8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(rgb + i * 3 + 24)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                pack16(argbToRgb565x8(low), argbToRgb565x8(high)));
+        }
+#endif
+#if KEMPOZER_SCREEN_NEON
+        for (; i + 8 <= count; i += 8) {
+            uint8x8x3_t pixels = vld3_u8(rgb + i * 3);
+            vst1q_u16(out + i, rgbToRgb565x8(pixels.val[0], pixels.val[1], pixels.val[2]));
+        }
+#elif KEMPOZER_SCREEN_SSSE3 && KEMPOZER_SCREEN_SSE2
+        // Each 16 byte load covers 5 pixels, of which the first 4 are spread
+        // into ARGB8888 lanes. The last load of a block reads 4 bytes past the
+        // pixels it converts, so stop while that is still inside the input.
+        const __m128i spread = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+        for (; (i + 8) * 3 + 4 <= count * 3; i += 8) {
+            __m128i low = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + i * 3)), spread),
+                    high = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + i * 3 + 12)), spread);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                             _mm_packs_epi32(argbToRgb565x4(low), argbToRgb565x4(high)));
+        }
+#elif KEMPOZER_SCREEN_SSE2
+        // Without SSSE3 there is no byte shuffle, so the pixels are spread
+        // with byte shifts and unpacks instead; the loads are the same.
+        for (; (i + 8) * 3 + 4 <= count * 3; i += 8) {
+            __m128i low = spreadRgb888x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + i * 3))),
+                    high = spreadRgb888x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + i * 3 + 12)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                             _mm_packs_epi32(rgbxToRgb565x4(low), rgbxToRgb565x4(high)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = rgb565(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+    }
+
+    void argb8888ToRgb565(std::size_t count, const std::uint32_t *argb, std::uint16_t *out) {
+        std::size_t i = 0;
+#if KEMPOZER_SCREEN_AVX2
+        for (; i + 16 <= count; i += 16) {
+            __m256i low = argbToRgb565x8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + i))),
+                    high = argbToRgb565x8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + i + 8)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), pack16(low, high));
+        }
+#endif
+#if KEMPOZER_SCREEN_SSE2
+        for (; i + 8 <= count; i += 8) {
+            __m128i low = argbToRgb565x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(argb + i))),
+                    high = argbToRgb565x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(argb + i + 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(low, high));
+        }
+#elif KEMPOZER_SCREEN_NEON
+        for (; i + 8 <= count; i += 8) {
+            uint8x8x4_t pixels = vld4_u8(reinterpret_cast<const std::uint8_t *>(argb + i));
+            vst1q_u16(out + i, rgbToRgb565x8(pixels.val[2], pixels.val[1], pixels.val[0]));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = argbToRgb565(argb[i]);
+        }
+    }
+
+    void argb8888ToRgb565Dithered(std::size_t count, const std::uint32_t *argb, std::uint16_t *out,
+                                  std::uint16_t x, std::uint16_t y) {
+        std::size_t i = 0;
+        // The dither pattern repeats every 4 pixels, so one vector of offsets
+        // serves every block of 4 (or 8) pixels in the run.
+#if KEMPOZER_SCREEN_SSE2
+        __m128i offsets = _mm_setr_epi32(int(ditherOffsets(x, y)), int(ditherOffsets(x + 1, y)),
+                                         int(ditherOffsets(x + 2, y)), int(ditherOffsets(x + 3, y)));
+#if KEMPOZER_SCREEN_AVX2
+        __m256i wide = _mm256_broadcastsi128_si256(offsets);
+        for (; i + 16 <= count; i += 16) {
+            __m256i low = _mm256_adds_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + i)), wide),
+                    high = _mm256_adds_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + i + 8)), wide);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                pack16(argbToRgb565x8(low), argbToRgb565x8(high)));
+        }
+#endif
+        for (; i + 8 <= count; i += 8) {
+            __m128i low = _mm_adds_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(argb + i)), offsets),
+                    high = _mm_adds_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(argb + i + 4)), offsets);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                             _mm_packs_epi32(argbToRgb565x4(low), argbToRgb565x4(high)));
+        }
+#elif KEMPOZER_SCREEN_NEON
+        const std::uint32_t pattern[] = {
+            ditherOffsets(x, y), ditherOffsets(x + 1, y), ditherOffsets(x + 2, y), ditherOffsets(x + 3, y),
+            ditherOffsets(x, y), ditherOffsets(x + 1, y), ditherOffsets(x + 2, y), ditherOffsets(x + 3, y),
+        };
+        uint8x8x4_t offsets = vld4_u8(reinterpret_cast<const std::uint8_t *>(pattern));
+        for (; i + 8 <= count; i += 8) {
+            uint8x8x4_t pixels = vld4_u8(reinterpret_cast<const std::uint8_t *>(argb + i));
+            vst1q_u16(out + i, rgbToRgb565x8(vqadd_u8(pixels.val[2], offsets.val[2]),
+                                             vqadd_u8(pixels.val[1], offsets.val[1]),
+                                             vqadd_u8(pixels.val[0], offsets.val[0])));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = ditheredRgb565(argb[i], ditherOffsets(std::uint16_t(x + i), y));
+        }
+    }
+
+    void rgb565ToRgb888(std::size_t count, const std::uint16_t *in, std::uint8_t *rgb) {
+        std::size_t i = 0;
+        // The x86 paths store 16 bytes for every 12 they produce, so they stop
+        // while the 4 bytes past the last store still belong to the output;
+        // the next store or the scalar tail overwrites them.
+#if KEMPOZER_SCREEN_AVX2
+        for (; (i + 16) * 3 + 4 <= count * 3; i += 16) {
+            // The unpacks work within each half, so first holds pixels 0-3
+            // and 8-11 and second holds 4-7 and 12-15.
+            __m256i first, second;
+            rgb565ToRgbx16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)), first, second);
+            first = packRgbx8(first);
+            second = packRgbx8(second);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3), _mm256_castsi256_si128(first));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3 + 12), _mm256_castsi256_si128(second));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3 + 24), _mm256_extracti128_si256(first, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3 + 36), _mm256_extracti128_si256(second, 1));
+        }
+#endif
+#if KEMPOZER_SCREEN_SSE2
+        for (; (i + 8) * 3 + 4 <= count * 3; i += 8) {
+            __m128i low, high;
+            rgb565ToRgbx8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), low, high);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3), packRgbx4(low));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + i * 3 + 12), packRgbx4(high));
+        }
+#elif KEMPOZER_SCREEN_NEON
+        for (; i + 8 <= count; i += 8) {
+            uint16x8_t pixels = vld1q_u16(in + i);
+            uint8x8_t r = vand_u8(vshrn_n_u16(pixels, 8), vdup_n_u8(0xF8)),
+                      g = vand_u8(vshrn_n_u16(pixels, 3), vdup_n_u8(0xFC)),
+                      b = vmovn_u16(vshlq_n_u16(pixels, 3));
+            uint8x8x3_t out;
+            out.val[0] = vorr_u8(r, vshr_n_u8(r, 5));
+            out.val[1] = vorr_u8(g, vshr_n_u8(g, 6));
+            out.val[2] = vorr_u8(b, vshr_n_u8(b, 5));
+            vst3_u8(rgb + i * 3, out);
+        }
+#endif
+        for (; i < count; ++i) {
+            std::uint16_t pixel = in[i];
+            std::uint8_t r = std::uint8_t(pixel >> 8) & 0xF8,
+                         g = std::uint8_t(pixel >> 3) & 0xFC,
+                         b = std::uint8_t(pixel << 3);
+            rgb[i * 3] = r | (r >> 5);
+            rgb[i * 3 + 1] = g | (g >> 6);
+            rgb[i * 3 + 2] = b | (b >> 5);
+        }
+    }
+
+    void swapBytes16(std::size_t count, const std::uint16_t *in, std::uint16_t *out) {
+        std::size_t i = 0;
+#if KEMPOZER_SCREEN_AVX2
+        for (; i + 16 <= count; i += 16) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                _mm256_or_si256(_mm256_slli_epi16(pixels, 8), _mm256_srli_epi16(pixels, 8)));
+        }
+#endif
+#if KEMPOZER_SCREEN_SSE2
+        for (; i + 8 <= count; i += 8) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                             _mm_or_si128(_mm_slli_epi16(pixels, 8), _mm_srli_epi16(pixels, 8)));
+        }
+#elif KEMPOZER_SCREEN_NEON
+        for (; i + 8 <= count; i += 8) {
+            vst1q_u16(out + i, vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(vld1q_u16(in + i)))));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = std::uint16_t((in[i] << 8) | (in[i] >> 8));
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_ColorConversion_h__
+#define __Kempozer_Screen_ColorConversion_h__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Kempozer::Screen {
+
+    /**
+     * Packs an 8-bit per channel color into RGB565.
+     *
+     * @param r
+     * @param g
+     * @param b
+     * @return
+     */
+    [[gnu::always_inline]]
+    inline constexpr std::uint16_t rgb565(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+        return std::uint16_t(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+
+    /**
+     * Converts count packed RGB888 pixels (R, G, B byte order) to RGB565.
+     *
+     * @param count
+     * @param rgb
+     * @param out
+     */
+    [[gnu::nonnull]]
+    void rgb888ToRgb565(std::size_t count, const std::uint8_t *rgb, std::uint16_t *out);
+
+    /**
+     * Converts count ARGB8888 pixels (0xAARRGGBB) to RGB565. Alpha is ignored.
+     *
+     * @param count
+     * @param argb
+     * @param out
+     */
+    [[gnu::nonnull]]
+    void argb8888ToRgb565(std::size_t count, const std::uint32_t *argb, std::uint16_t *out);
+
+    /**
+     * Converts count ARGB8888 pixels (0xAARRGGBB) to RGB565 with 4x4 ordered
+     * dithering, which hides the banding of smooth gradients. The pixels are
+     * a horizontal run starting at screen coordinate (x, y), which selects
+     * the dither pattern.
+     *
+     * @param count
+     * @param argb
+     * @param out
+     * @param x
+     * @param y
+     */
+    [[gnu::nonnull]]
+    void argb8888ToRgb565Dithered(std::size_t count, const std::uint32_t *argb, std::uint16_t *out,
+                                  std::uint16_t x, std::uint16_t y);
+
+    /**
+     * Converts count RGB565 pixels to packed RGB888 (R, G, B byte order),
+     * replicating the high bits of each channel into the low bits so that
+     * full intensity maps to 0xFF.
+     *
+     * @param count
+     * @param in
+     * @param rgb
+     */
+    [[gnu::nonnull]]
+    void rgb565ToRgb888(std::size_t count, const std::uint16_t *in, std::uint8_t *rgb);
+
+    /**
+     * Swaps the bytes of count 16-bit values, for panels that expect pixels
+     * in the opposite byte order. in and out may be the same buffer.
+     *
+     * @param count
+     * @param in
+     * @param out
+     */
+    [[gnu::nonnull]]
+    void swapBytes16(std::size_t count, const std::uint16_t *in, std::uint16_t *out);
+}
+
+#endif//__Kempozer_Screen_ColorConversion_h__
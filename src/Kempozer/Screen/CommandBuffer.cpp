@@ -0,0 +1,188 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/CommandBuffer.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        constexpr std::size_t NO_RECORD = ~std::size_t(0);
+
+        [[gnu::always_inline]]
+        inline std::size_t align(std::size_t size) {
+            return (size + CommandBuffer::ALIGNMENT - 1) & ~(CommandBuffer::ALIGNMENT - 1);
+        }
+
+        [[gnu::always_inline]]
+        inline std::size_t lengthOf(const std::uint8_t *header) {
+            return std::size_t(header[2]) | (std::size_t(header[3]) << 8);
+        }
+
+        [[gnu::always_inline]]
+        inline void setLength(std::uint8_t *header, std::size_t length) {
+            header[2] = std::uint8_t(length);
+            header[3] = std::uint8_t(length >> 8);
+        }
+    }
+
+    std::size_t CommandBuffer::decode(std::size_t count, const std::uint8_t *data, Record &record) {
+        if (count < HEADER_SIZE) {
+            return 0;
+        }
+        std::size_t length = lengthOf(data),
+                    size = HEADER_SIZE + length;
+        if (size > count) {
+            return 0;
+        }
+        record.type = RecordType(data[0]);
+        record.length = length;
+        record.payload = data + HEADER_SIZE;
+        size = align(size);
+        return size < count ? size : count;
+    }
+
+    CommandBuffer::CommandBuffer(Driver &driver, std::uint8_t *storage, std::size_t capacity)
+        : mDriver(driver) {
+        mStorage = storage;
+        mCapacity = capacity < MIN_CAPACITY ? 0 : capacity & ~(ALIGNMENT - 1);
+        mUsed = 0;
+        mLast = NO_RECORD;
+    }
+
+    CommandBuffer::~CommandBuffer() {
+        flush();
+    }
+
+    CommandBuffer *CommandBuffer::writePixels(std::size_t count, const std::uint16_t *data) {
+        if (!mCapacity) {
+            mDriver.writePixels(count, data);
+            return this;
+        }
+        std::size_t remaining = count * sizeof(std::uint16_t);
+        const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(data);
+        while (remaining) {
+            std::size_t chunk = remaining;
+            std::uint8_t *target = reserve(RecordType::Pixels, chunk);
+            std::memcpy(target, bytes, chunk);
+            bytes += chunk;
+            remaining -= chunk;
+        }
+        return this;
+    }
+
+    CommandBuffer *CommandBuffer::writeRepeatedPixel(std::size_t count, std::uint16_t color) {
+        if (!mCapacity) {
+            mDriver.writeRepeatedPixel(count, color);
+            return this;
+        }
+        std::size_t remaining = count * sizeof(std::uint16_t);
+        while (remaining) {
+            std::size_t chunk = remaining;
+            std::uint16_t *target = reinterpret_cast<std::uint16_t *>(reserve(RecordType::Pixels, chunk));
+            for (std::size_t i = 0; i < chunk / sizeof(std::uint16_t); ++i) {
+                target[i] = color;
+            }
+            remaining -= chunk;
+        }
+        return this;
+    }
+
+    CommandBuffer *CommandBuffer::flush() {
+        if (mUsed) {
+            mDriver.submit(mUsed, mStorage);
+            mUsed = 0;
+            mLast = NO_RECORD;
+        }
+        return this;
+    }
+
+    CommandBuffer *CommandBuffer::append(RecordType type, std::size_t count, const std::uint8_t *data) {
+        if (!mCapacity) {
+            if (type == RecordType::Command) {
+                mDriver.assertCommand();
+                mDriver.writeArray(count, data);
+                mDriver.deassertCommand();
+            } else {
+                mDriver.writeArray(count, data);
+            }
+            return this;
+        }
+        while (count) {
+            std::size_t chunk = count;
+            std::uint8_t *target = reserve(type, chunk);
+            std::memcpy(target, data, chunk);
+            data += chunk;
+            count -= chunk;
+        }
+        return this;
+    }
+
+    std::uint8_t *CommandBuffer::reserve(RecordType type, std::size_t &count) {
+        // Pixel records only ever grow by whole pixels, and commands are never
+        // split or merged.
+        std::size_t granularity = type == RecordType::Pixels ? sizeof(std::uint16_t) : 1;
+        if (type != RecordType::Command && mLast != NO_RECORD && RecordType(mStorage[mLast]) == type) {
+            std::uint8_t *header = mStorage + mLast;
+            std::size_t length = lengthOf(header),
+                        start = mLast + HEADER_SIZE + length,
+                        available = mCapacity - start;
+            if (available > MAX_LENGTH - length) {
+                available = MAX_LENGTH - length;
+            }
+            available -= available % granularity;
+            if (available) {
+                if (count > available) {
+                    count = available;
+                }
+                setLength(header, length + count);
+                mUsed = align(start + count);
+                return mStorage + start;
+            }
+        }
+
+        std::size_t minimum = type == RecordType::Command ? count : granularity;
+        if (mCapacity - mUsed < HEADER_SIZE + minimum) {
+            flush();
+        }
+        std::size_t available = mCapacity - mUsed - HEADER_SIZE;
+        if (available > MAX_LENGTH) {
+            available = MAX_LENGTH;
+        }
+        available -= available % granularity;
+        if (count > available) {
+            count = available;
+        }
+        std::uint8_t *header = mStorage + mUsed;
+        header[0] = std::uint8_t(type);
+        header[1] = 0;
+        setLength(header, count);
+        mLast = mUsed;
+        mUsed = align(mUsed + HEADER_SIZE + count);
+        return header + HEADER_SIZE;
+    }
+}
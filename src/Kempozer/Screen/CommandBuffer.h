@@ -0,0 +1,256 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_CommandBuffer_h__
+#define __Kempozer_Screen_CommandBuffer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "KempozerScreenConcepts.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Records commands, parameters and pixels bound for a {@link Driver} into a
+     * fixed-capacity buffer and hands the whole batch to
+     * {@link Driver::submit(std::size_t, const std::uint8_t *)} in one call, so
+     * that drivers can send it as a single bus transaction.
+     *
+     * The buffer is a sequence of records, each made of a 4 byte header (the
+     * {@link RecordType}, a reserved byte, and the little-endian payload length)
+     * followed by the payload, padded to a multiple of 4 bytes. Consecutive
+     * data records, and consecutive pixel records, are coalesced into one.
+     * Pixel payloads hold native std::uint16_t values, so the storage must be
+     * aligned to at least 4 bytes.
+     *
+     * When a record does not fit, the buffer is flushed to the driver first,
+     * so payloads larger than the capacity are split transparently. Any
+     * remaining records are flushed when the buffer is destroyed.
+     *
+     * Storage smaller than {@link MIN_CAPACITY} cannot hold the widest command
+     * with room to spare, so such a buffer records nothing and passes every
+     * call straight through to the driver instead.
+     */
+    class CommandBuffer {
+    public:
+        /**
+         * The kind of a record.
+         */
+        enum class RecordType : std::uint8_t {
+            Command = 1,
+            Data = 2,
+            Pixels = 3,
+        };
+
+        /**
+         * A decoded record.
+         */
+        struct Record {
+            RecordType type;
+            std::size_t length;
+            const std::uint8_t *payload;
+        };
+
+        static constexpr std::size_t HEADER_SIZE = 4;
+        static constexpr std::size_t ALIGNMENT = 4;
+        static constexpr std::size_t MAX_LENGTH = 0xFFFF;
+        static constexpr std::size_t MIN_CAPACITY = 4 * HEADER_SIZE;
+
+        /**
+         * Decodes the record at the start of data.
+         *
+         * @param count
+         * @param data
+         * @param record
+         * @return The number of bytes occupied by the record, or 0 if data does
+         *         not start with a complete record.
+         */
+        static std::size_t decode(std::size_t count, const std::uint8_t *data, Record &record);
+
+        /**
+         * Creates a buffer that records into storage and flushes to driver.
+         * Both must outlive this buffer. With less than {@link MIN_CAPACITY}
+         * bytes of storage, the buffer passes everything straight through.
+         *
+         * @param driver
+         * @param storage
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        CommandBuffer(Driver &driver, std::uint8_t *storage, std::size_t capacity);
+
+        CommandBuffer(const CommandBuffer &) = delete;
+
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        ~CommandBuffer();
+
+        /**
+         * Records a command. This command must be convertible to an
+         * {@link std::uint8_t}, {@link std::uint16_t}, {@link std::uint32_t},
+         * or {@link std::uint64_t}, and is encoded the same way
+         * {@link Driver::writeCommand(EnumT)} would send it.
+         *
+         * @tparam EnumT
+         * @param command
+         */
+        template<commandtype EnumT>
+        inline CommandBuffer *command(EnumT command) {
+            std::uint64_t value = std::uint64_t(command);
+            std::uint8_t bytes[sizeof(EnumT)];
+            bool bigEndian = mDriver.byteOrder() == ByteOrder::BigEndian;
+            for (std::size_t i = 0; i < sizeof(EnumT); ++i) {
+                bytes[bigEndian ? sizeof(EnumT) - 1 - i : i] = std::uint8_t(value >> (i * 8));
+            }
+            return append(RecordType::Command, sizeof(EnumT), bytes);
+        }
+
+        /**
+         * Records an 8-bit value.
+         *
+         * @param u8
+         */
+        inline CommandBuffer *write(std::uint8_t u8) {
+            return append(RecordType::Data, 1, &u8);
+        }
+
+        /**
+         * Records a 16-bit value in the driver's byte order, like
+         * {@link Driver::write16(std::uint16_t)}.
+         *
+         * @param u16
+         */
+        inline CommandBuffer *write16(std::uint16_t u16) {
+            std::uint8_t bytes[] = {std::uint8_t(u16), std::uint8_t(u16 >> 8)};
+            if (mDriver.byteOrder() == ByteOrder::BigEndian) {
+                bytes[0] = std::uint8_t(u16 >> 8);
+                bytes[1] = std::uint8_t(u16);
+            }
+            return append(RecordType::Data, 2, bytes);
+        }
+
+        /**
+         * Records count 8-bit values.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        inline CommandBuffer *writeArray(std::size_t count, const std::uint8_t *data) {
+            return append(RecordType::Data, count, data);
+        }
+
+        /**
+         * Records a single pixel.
+         *
+         * @param color
+         */
+        inline CommandBuffer *writePixel(std::uint16_t color) {
+            return writePixels(1, &color);
+        }
+
+        /**
+         * Records count pixels.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        CommandBuffer *writePixels(std::size_t count, const std::uint16_t *data);
+
+        /**
+         * Records the same color of pixel count times.
+         *
+         * @param count
+         * @param color
+         */
+        CommandBuffer *writeRepeatedPixel(std::size_t count, std::uint16_t color);
+
+        /**
+         * Submits all recorded records to the driver and empties the buffer.
+         */
+        CommandBuffer *flush();
+
+        /**
+         * Gets the number of bytes currently recorded.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t size() const {
+            return mUsed;
+        }
+
+        /**
+         * Gets the number of bytes this buffer can hold, which is 0 when it
+         * passes everything straight through to the driver.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t capacity() const {
+            return mCapacity;
+        }
+    private:
+        [[gnu::nonnull]]
+        CommandBuffer *append(RecordType type, std::size_t count, const std::uint8_t *data);
+
+        std::uint8_t *reserve(RecordType type, std::size_t &count);
+
+        Driver &mDriver;
+        std::uint8_t *mStorage;
+        std::size_t mCapacity,
+                    mUsed,
+                    mLast;
+    };
+
+    /**
+     * A {@link CommandBuffer} that owns its storage, for use on the stack.
+     *
+     * @tparam N
+     */
+    template<std::size_t N>
+    class StaticCommandBuffer : public CommandBuffer {
+    public:
+        static_assert(N >= CommandBuffer::MIN_CAPACITY, "StaticCommandBuffer is too small");
+
+        explicit StaticCommandBuffer(Driver &driver)
+            : CommandBuffer(driver, mBuffer, N) {}
+
+        ~StaticCommandBuffer() {
+            flush();
+        }
+    private:
+        alignas(CommandBuffer::ALIGNMENT) std::uint8_t mBuffer[N];
+    };
+}
+
+#endif//__Kempozer_Screen_CommandBuffer_h__
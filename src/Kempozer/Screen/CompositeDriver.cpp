@@ -0,0 +1,376 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/CompositeDriver.h"
+
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace Kempozer::Screen {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+    /**
+     * One thread per panel, woken together for each fanned out transfer.
+     */
+    struct CompositeDriver::Workers {
+        struct Run {
+            std::size_t offset;
+            std::size_t length;
+        };
+
+        std::mutex mutex;
+        std::condition_variable started, finished;
+        std::vector<std::thread> threads;
+        std::vector<std::vector<Run>> runs;
+        std::vector<std::size_t> totals;
+        std::function<void(std::size_t)> job;
+        std::size_t generation = 0,
+                    pending = 0;
+        bool stopping = false;
+
+        explicit Workers(std::size_t panels)
+            : runs(panels), totals(panels) {
+            for (std::size_t i = 0; i < panels; ++i) {
+                threads.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        ~Workers() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            started.notify_all();
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+        }
+
+        void work(std::size_t panel) {
+            std::size_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    started.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) {
+                        return;
+                    }
+                    seen = generation;
+                }
+                job(panel);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) {
+                    finished.notify_one();
+                }
+            }
+        }
+
+        void run(std::function<void(std::size_t)> work) {
+            std::unique_lock<std::mutex> lock(mutex);
+            job = std::move(work);
+            pending = threads.size();
+            ++generation;
+            started.notify_all();
+            finished.wait(lock, [&] { return pending == 0; });
+        }
+    };
+#else
+    struct CompositeDriver::Workers {};
+#endif
+
+    CompositeDriver::CompositeDriver(Driver *const *panels, std::uint8_t columns, std::uint8_t rows)
+        : Driver(0, 0) {
+        mPanels = panels;
+        mColumns = columns;
+        mRows = rows;
+        mPanels[0]->resolution(mPanelWidth, mPanelHeight);
+        resize(std::uint16_t(mPanelWidth * columns), std::uint16_t(mPanelHeight * rows));
+        mX1 = 0;
+        mY1 = 0;
+        mX2 = mWidth - 1;
+        mY2 = mHeight - 1;
+        mColumn = 0;
+        mRow = 0;
+        mConcurrent = true;
+        mWorkers = nullptr;
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (std::size_t(columns) * rows > 1) {
+            mWorkers = new Workers(std::size_t(columns) * rows);
+        }
+#endif
+    }
+
+    CompositeDriver::~CompositeDriver() {
+        delete mWorkers;
+    }
+
+    CompositeDriver *CompositeDriver::concurrent(bool enabled) {
+        mConcurrent = enabled;
+        return this;
+    }
+
+    bool CompositeDriver::initialize() {
+        bool initialized = true;
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            initialized = mPanels[i]->initialize() && initialized;
+        }
+        return initialized;
+    }
+
+    Driver *CompositeDriver::select() {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->select();
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::deselect() {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->deselect();
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::assertCommand() {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->assertCommand();
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::deassertCommand() {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->deassertCommand();
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::writePixel(std::uint16_t color) {
+        walk(1, [&](std::size_t panel, std::size_t, std::size_t) {
+            mPanels[panel]->writePixel(color);
+        });
+        return this;
+    }
+
+    Driver *CompositeDriver::writePixels(std::size_t count, const std::uint16_t *data) {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (mWorkers && mConcurrent && count >= KEMPOZER_SCREEN_COMPOSITE_PARALLEL_PIXELS) {
+            for (auto &runs : mWorkers->runs) {
+                runs.clear();
+            }
+            walk(count, [&](std::size_t panel, std::size_t offset, std::size_t length) {
+                mWorkers->runs[panel].push_back(Workers::Run{offset, length});
+            });
+            fanOut([&](std::size_t panel) {
+                for (const Workers::Run &run : mWorkers->runs[panel]) {
+                    mPanels[panel]->writePixels(run.length, data + run.offset);
+                }
+            });
+            return this;
+        }
+#endif
+        if (!mConcurrent) {
+            walk(count, [&](std::size_t panel, std::size_t offset, std::size_t length) {
+                mPanels[panel]->writePixels(length, data + offset);
+            });
+            return this;
+        }
+        // Each panel only waits for its own previous run, so the transfers
+        // of neighbouring panels overlap.
+        walk(count, [&](std::size_t panel, std::size_t offset, std::size_t length) {
+            mPanels[panel]->wait()->writePixelsAsync(length, data + offset);
+        });
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->wait();
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::writeRepeatedPixel(std::size_t count, const std::uint16_t color) {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (mWorkers && mConcurrent && count >= KEMPOZER_SCREEN_COMPOSITE_PARALLEL_PIXELS) {
+            // A single color may be sent in any split, so each panel gets one
+            // call for all of its pixels.
+            for (std::size_t &total : mWorkers->totals) {
+                total = 0;
+            }
+            walk(count, [&](std::size_t panel, std::size_t, std::size_t length) {
+                mWorkers->totals[panel] += length;
+            });
+            fanOut([&](std::size_t panel) {
+                if (mWorkers->totals[panel]) {
+                    mPanels[panel]->writeRepeatedPixel(mWorkers->totals[panel], color);
+                }
+            });
+            return this;
+        }
+#endif
+        // Consecutive runs on the same panel are joined, since a single color
+        // may be sent in any split.
+        std::size_t pending = 0, last = 0;
+        walk(count, [&](std::size_t panel, std::size_t, std::size_t length) {
+            if (pending && panel != last) {
+                mPanels[last]->writeRepeatedPixel(pending, color);
+                pending = 0;
+            }
+            last = panel;
+            pending += length;
+        });
+        if (pending) {
+            mPanels[last]->writeRepeatedPixel(pending, color);
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::write(std::uint8_t u8) {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->write(u8);
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::writeArray(std::size_t count, const std::uint8_t *data) {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->writeArray(count, data);
+        }
+        return this;
+    }
+
+    std::uint16_t CompositeDriver::readPixel() {
+        std::uint16_t color = 0;
+        walk(1, [&](std::size_t panel, std::size_t, std::size_t) {
+            color = mPanels[panel]->readPixel();
+        });
+        return color;
+    }
+
+    void CompositeDriver::readPixels(std::size_t count, std::uint16_t *data) {
+        walk(count, [&](std::size_t panel, std::size_t offset, std::size_t length) {
+            mPanels[panel]->readPixels(length, data + offset);
+        });
+    }
+
+    std::uint8_t CompositeDriver::read() {
+        return mPanels[0]->read();
+    }
+
+    Driver *CompositeDriver::addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                                           std::uint16_t &x2, std::uint16_t &y2) {
+        x1 = mX1;
+        y1 = mY1;
+        x2 = mX2;
+        y2 = mY2;
+        return this;
+    }
+
+    Driver *CompositeDriver::setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                              std::uint16_t x2, std::uint16_t y2) {
+        mX2 = x2 < mWidth ? x2 : mWidth - 1;
+        mY2 = y2 < mHeight ? y2 : mHeight - 1;
+        mX1 = x1 < mX2 ? x1 : mX2;
+        mY1 = y1 < mY2 ? y1 : mY2;
+        mColumn = mX1;
+        mRow = mY1;
+        for (std::uint8_t row = mY1 / mPanelHeight; row <= mY2 / mPanelHeight; ++row) {
+            std::uint16_t top = row * mPanelHeight,
+                          panelY1 = mY1 > top ? mY1 - top : 0,
+                          panelY2 = mY2 - top < mPanelHeight ? mY2 - top : mPanelHeight - 1;
+            for (std::uint8_t column = mX1 / mPanelWidth; column <= mX2 / mPanelWidth; ++column) {
+                std::uint16_t left = column * mPanelWidth,
+                              panelX1 = mX1 > left ? mX1 - left : 0,
+                              panelX2 = mX2 - left < mPanelWidth ? mX2 - left : mPanelWidth - 1;
+                panel(column, row)->setAddressWindow(panelX1, panelY1, panelX2, panelY2);
+            }
+        }
+        return this;
+    }
+
+    Driver *CompositeDriver::tearingEffectOutput(bool enabled) {
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            mPanels[i]->tearingEffectOutput(enabled);
+        }
+        return this;
+    }
+
+    bool CompositeDriver::hasTearingEffect() {
+        return mPanels[0]->hasTearingEffect();
+    }
+
+    bool CompositeDriver::tearingEffect() {
+        return mPanels[0]->tearingEffect();
+    }
+
+    Driver *CompositeDriver::pause(std::uint16_t milliseconds) {
+        mPanels[0]->pause(milliseconds);
+        return this;
+    }
+
+    template<typename F>
+    void CompositeDriver::walk(std::size_t count, F &&visit) {
+        std::size_t offset = 0;
+        while (count) {
+            std::size_t run = std::size_t(mX2 - mColumn) + 1;
+            run = run < count ? run : count;
+            std::size_t panelRow = mRow / mPanelHeight;
+            std::uint32_t x = mColumn,
+                          end = mColumn + std::uint32_t(run);
+            while (x < end) {
+                std::uint32_t panelColumn = x / mPanelWidth,
+                              boundary = (panelColumn + 1) * mPanelWidth,
+                              stop = boundary < end ? boundary : end;
+                visit(panelRow * mColumns + panelColumn, offset, std::size_t(stop - x));
+                offset += stop - x;
+                x = stop;
+            }
+            count -= run;
+            if (end > mX2) {
+                mColumn = mX1;
+                mRow = mRow < mY2 ? mRow + 1 : mY1;
+            } else {
+                mColumn = std::uint16_t(end);
+            }
+        }
+    }
+
+    template<typename F>
+    void CompositeDriver::fanOut(F &&job) {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (mWorkers) {
+            mWorkers->run(std::ref(job));
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < std::size_t(mColumns) * mRows; ++i) {
+            job(i);
+        }
+    }
+}
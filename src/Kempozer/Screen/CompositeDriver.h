@@ -0,0 +1,178 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_CompositeDriver_h__
+#define __Kempozer_Screen_CompositeDriver_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A driver that presents a grid of identical panels, each with its own
+     * {@link Driver}, as one display whose resolution is the sum of theirs.
+     *
+     * Address windows are intersected with every panel and set on the panels
+     * they touch, and pixel streams are cut at panel boundaries so that each
+     * panel receives exactly its part of the window in order. Commands and
+     * raw writes are broadcast to every panel; reads come from the panel
+     * under the current position.
+     *
+     * Large transfers are submitted to the panels concurrently: with
+     * KEMPOZER_SCREEN_ENABLE_THREADS, by one worker thread per panel; without
+     * it, by interleaving {@link Driver::writePixelsAsync} across the panels
+     * so that their DMA engines run side by side.
+     */
+    class CompositeDriver : public Driver {
+    public:
+        /**
+         * Combines columns * rows panels, given row by row from the top-left
+         * one. The panel array and the panels must outlive this driver, and
+         * every panel must have the resolution of the first.
+         *
+         * @param panels
+         * @param columns
+         * @param rows
+         */
+        [[gnu::nonnull]]
+        CompositeDriver(Driver *const *panels, std::uint8_t columns, std::uint8_t rows);
+
+        ~CompositeDriver();
+
+        CompositeDriver(const CompositeDriver &) = delete;
+
+        CompositeDriver &operator=(const CompositeDriver &) = delete;
+
+        /**
+         * Enables or disables concurrent submission. It is enabled by default.
+         *
+         * @param enabled
+         */
+        CompositeDriver *concurrent(bool enabled);
+
+        /**
+         * Gets the panel in the given column and row of the grid.
+         *
+         * @param column
+         * @param row
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline Driver *panel(std::uint8_t column, std::uint8_t row) const {
+            return mPanels[std::size_t(row) * mColumns + column];
+        }
+
+        bool initialize() override;
+
+        Driver *select() override;
+
+        Driver *deselect() override;
+
+        Driver *assertCommand() override;
+
+        Driver *deassertCommand() override;
+
+        Driver *writePixel(std::uint16_t color) override;
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override;
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override;
+
+        Driver *write(std::uint8_t u8) override;
+
+        Driver *writeArray(std::size_t count, const std::uint8_t *data) override;
+
+        std::uint16_t readPixel() override;
+
+        void readPixels(std::size_t count, std::uint16_t *data) override;
+
+        std::uint8_t read() override;
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override;
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override;
+
+        Driver *tearingEffectOutput(bool enabled) override;
+
+        /**
+         * Gets whether or not the first panel reports its TE line. Panels
+         * that share a clock refresh together, so the first one stands in for
+         * all of them.
+         *
+         * @return
+         */
+        bool hasTearingEffect() override;
+
+        bool tearingEffect() override;
+
+        /**
+         * Waits on the first panel only, since the panels are brought up
+         * together.
+         *
+         * @param milliseconds
+         */
+        Driver *pause(std::uint16_t milliseconds) override;
+
+        using Driver::writePixels;
+        using Driver::writeArray;
+        using Driver::readPixels;
+        using Driver::addressWindow;
+    private:
+        struct Workers;
+
+        /**
+         * Walks the next count pixels of the window, calling visit with the
+         * panel index, the offset into the stream and the length of each run
+         * that lands on a single panel, then advances the position.
+         */
+        template<typename F>
+        void walk(std::size_t count, F &&visit);
+
+        /**
+         * Runs job for every panel, on the worker threads when available.
+         * job(panel) must only touch that panel.
+         */
+        template<typename F>
+        void fanOut(F &&job);
+
+        Driver *const *mPanels;
+        Workers *mWorkers;
+        std::uint16_t mPanelWidth, mPanelHeight;
+        std::uint16_t mX1, mY1, mX2, mY2;
+        std::uint16_t mColumn, mRow;
+        std::uint8_t mColumns, mRows;
+        bool mConcurrent;
+    };
+}
+
+#endif//__Kempozer_Screen_CompositeDriver_h__
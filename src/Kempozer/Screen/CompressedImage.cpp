@@ -0,0 +1,182 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/CompressedImage.h"
+#include "KempozerScreenConfig.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        [[gnu::always_inline]]
+        inline std::uint16_t load16(const std::uint8_t *data) {
+            return std::uint16_t(data[0] | (data[1] << 8));
+        }
+
+        /**
+         * Coalesces consecutive runs of one color into a single
+         * writeRepeatedPixel, since each packet holds at most 128 pixels.
+         */
+        class RunWriter {
+        public:
+            explicit RunWriter(Driver &driver)
+                : mDriver(driver), mCount(0), mColor(0) {}
+
+            [[gnu::always_inline]]
+            inline void run(std::size_t count, std::uint16_t color) {
+                if (mCount && color != mColor) {
+                    flush();
+                }
+                mColor = color;
+                mCount += count;
+            }
+
+            [[gnu::always_inline]]
+            inline void flush() {
+                if (mCount) {
+                    mDriver.writeRepeatedPixel(mCount, mColor);
+                    mCount = 0;
+                }
+            }
+        private:
+            Driver &mDriver;
+            std::size_t mCount;
+            std::uint16_t mColor;
+        };
+    }
+
+    CompressedImage::CompressedImage(const std::uint8_t *data, std::size_t size) {
+        mPalette = nullptr;
+        mPixels = nullptr;
+        mEnd = data + size;
+        mWidth = 0;
+        mHeight = 0;
+        mPaletteSize = 0;
+        mFormat = Format::Rle565;
+        if (size < HEADER_SIZE || data[0] != 'K' || data[1] != 'I' || data[2] > std::uint8_t(Format::Palette8)) {
+            return;
+        }
+        Format format = Format(data[2]);
+        std::uint16_t paletteSize = load16(data + 8);
+        std::size_t limit = format == Format::Palette2 ? 4
+                          : format == Format::Palette4 ? 16
+                          : format == Format::Palette8 ? 256
+                          : 0;
+        if (paletteSize > limit || (limit && !paletteSize)
+            || size < HEADER_SIZE + std::size_t(paletteSize) * 2) {
+            return;
+        }
+        mFormat = format;
+        mWidth = load16(data + 4);
+        mHeight = load16(data + 6);
+        mPaletteSize = paletteSize;
+        mPalette = data + HEADER_SIZE;
+        mPixels = mPalette + std::size_t(paletteSize) * 2;
+    }
+
+    bool CompressedImage::draw(Driver &driver, std::uint16_t x, std::uint16_t y) const {
+        if (!valid()) {
+            return false;
+        }
+        std::size_t remaining = std::size_t(mWidth) * mHeight;
+        if (!remaining) {
+            return true;
+        }
+        driver.setAddressWindow(x, y, x + mWidth - 1, y + mHeight - 1);
+
+        unsigned bits = mFormat == Format::Palette2 ? 2
+                      : mFormat == Format::Palette4 ? 4
+                      : mFormat == Format::Palette8 ? 8
+                      : 16;
+        std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        RunWriter runs(driver);
+        const std::uint8_t *in = mPixels;
+        while (remaining) {
+            if (in >= mEnd) {
+                break;
+            }
+            std::uint8_t control = *in++;
+            std::size_t count = (control & ~RUN) + 1;
+            if (count > remaining) {
+                break;
+            }
+            if (control & RUN) {
+                std::uint16_t color;
+                if (bits == 16) {
+                    if (mEnd - in < 2) {
+                        break;
+                    }
+                    color = load16(in);
+                    in += 2;
+                } else {
+                    if (in >= mEnd || *in >= mPaletteSize) {
+                        break;
+                    }
+                    color = load16(mPalette + std::size_t(*in++) * 2);
+                }
+                runs.run(count, color);
+            } else {
+                std::size_t bytes = (count * bits + 7) / 8;
+                if (std::size_t(mEnd - in) < bytes) {
+                    break;
+                }
+                runs.flush();
+                // Decode into the chunk until it fills, then send it.
+                std::size_t filled = 0;
+                bool malformed = false;
+                for (std::size_t i = 0; i < count; ++i) {
+                    std::uint16_t color;
+                    if (bits == 16) {
+                        color = load16(in + i * 2);
+                    } else {
+                        std::size_t bit = i * bits;
+                        std::uint8_t index = (in[bit >> 3] >> (8 - bits - (bit & 7))) & ((1u << bits) - 1);
+                        if (index >= mPaletteSize) {
+                            malformed = true;
+                            break;
+                        }
+                        color = load16(mPalette + std::size_t(index) * 2);
+                    }
+                    chunk[filled++] = color;
+                    if (filled == KEMPOZER_SCREEN_CONVERSION_CHUNK) {
+                        driver.writePixels(filled, chunk);
+                        filled = 0;
+                    }
+                }
+                if (filled) {
+                    driver.writePixels(filled, chunk);
+                }
+                if (malformed) {
+                    return false;
+                }
+                in += bytes;
+            }
+            remaining -= count;
+        }
+        runs.flush();
+        return remaining == 0;
+    }
+}
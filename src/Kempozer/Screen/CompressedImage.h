@@ -0,0 +1,141 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_CompressedImage_h__
+#define __Kempozer_Screen_CompressedImage_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A run-length encoded image, optionally palettized, that is decoded
+     * straight to a {@link Driver} without ever holding the whole bitmap.
+     *
+     * All multi-byte fields are little-endian. The image starts with a
+     * {@link HEADER_SIZE} byte header:
+     *
+     *     offset 0  'K', 'I'       magic
+     *     offset 2  format         see {@link Format}
+     *     offset 3  0              reserved
+     *     offset 4  width          std::uint16_t
+     *     offset 6  height         std::uint16_t
+     *     offset 8  palette size   std::uint16_t, 0 for Format::Rle565
+     *
+     * followed by the palette as RGB565 std::uint16_t values, then packets
+     * until width * height pixels have been produced. Each packet starts with
+     * a control byte c holding a count n = (c & 0x7F) + 1:
+     *
+     *  - c & 0x80 set: a run of n pixels of one value, which follows as an
+     *    RGB565 value or a single palette index byte.
+     *  - c & 0x80 clear: n literal pixels, which follow as RGB565 values or
+     *    as palette indices packed most significant bits first at 2, 4 or 8
+     *    bits each, padded to a whole byte.
+     *
+     * Runs are sent with {@link Driver::writeRepeatedPixel} (consecutive runs
+     * of the same color as one call) and literals with
+     * {@link Driver::writePixels} in chunks of
+     * KEMPOZER_SCREEN_CONVERSION_CHUNK pixels. Images are produced by the
+     * ImageEncoder tool in extras/tools.
+     */
+    class CompressedImage {
+    public:
+        /**
+         * How the pixels of an image are stored.
+         */
+        enum class Format : std::uint8_t {
+            Rle565 = 0,
+            Palette2 = 1,
+            Palette4 = 2,
+            Palette8 = 3,
+        };
+
+        static constexpr std::size_t HEADER_SIZE = 10;
+        static constexpr std::uint8_t RUN = 0x80;
+        static constexpr std::size_t MAX_PACKET = 128;
+
+        /**
+         * Wraps an encoded image of size bytes, which must outlive this
+         * object. Use {@link valid()} to check that the header made sense.
+         *
+         * @param data
+         * @param size
+         */
+        [[gnu::nonnull]]
+        CompressedImage(const std::uint8_t *data, std::size_t size);
+
+        /**
+         * Gets whether the header of this image is well formed.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool valid() const {
+            return mPixels != nullptr;
+        }
+
+        [[gnu::always_inline]]
+        inline Format format() const {
+            return mFormat;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t width() const {
+            return mWidth;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t height() const {
+            return mHeight;
+        }
+
+        /**
+         * Decodes this image to the driver with its top-left corner at (x, y).
+         * The image must lie entirely on screen.
+         *
+         * @param driver
+         * @param x
+         * @param y
+         * @return Whether the whole image decoded; false if it is malformed,
+         *         in which case the pixels up to the error have been sent.
+         */
+        bool draw(Driver &driver, std::uint16_t x, std::uint16_t y) const;
+    private:
+        const std::uint8_t *mPalette;
+        const std::uint8_t *mPixels;
+        const std::uint8_t *mEnd;
+        std::uint16_t mWidth,
+                      mHeight,
+                      mPaletteSize;
+        Format mFormat;
+    };
+}
+
+#endif//__Kempozer_Screen_CompressedImage_h__
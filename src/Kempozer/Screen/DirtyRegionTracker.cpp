@@ -0,0 +1,118 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/DirtyRegionTracker.h"
+
+namespace Kempozer::Screen {
+    DirtyRegionTracker::DirtyRegionTracker(Driver &driver, std::uint16_t *shadow,
+                                           std::uint16_t width, std::uint16_t height)
+        : mDriver(driver) {
+        mShadow = shadow;
+        mWidth = width;
+        mHeight = height;
+        mDamaged = 0;
+        mStatistics = Statistics{};
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::damage(Rect rect) {
+        if (rect.clip(mWidth, mHeight)) {
+            mDamaged += rect.area();
+            mRegions.add(rect);
+        }
+        return this;
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::damageAll() {
+        return damage(Rect{0, 0, std::uint16_t(mWidth - 1), std::uint16_t(mHeight - 1)});
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::writePixel(std::uint16_t x, std::uint16_t y, std::uint16_t color) {
+        if (x < mWidth && y < mHeight) {
+            mShadow[std::size_t(y) * mWidth + x] = color;
+            damage(Rect{x, y, x, y});
+        }
+        return this;
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::fillRect(Rect rect, std::uint16_t color) {
+        if (!rect.clip(mWidth, mHeight)) {
+            return this;
+        }
+        for (std::uint16_t y = rect.y1; y <= rect.y2; ++y) {
+            std::uint16_t *row = mShadow + std::size_t(y) * mWidth;
+            for (std::uint16_t x = rect.x1; x <= rect.x2; ++x) {
+                row[x] = color;
+            }
+        }
+        return damage(rect);
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::writePixels(Rect rect, const std::uint16_t *data) {
+        std::uint16_t stride = rect.width();
+        if (!rect.clip(mWidth, mHeight)) {
+            return this;
+        }
+        for (std::uint16_t y = rect.y1; y <= rect.y2; ++y) {
+            std::memcpy(mShadow + std::size_t(y) * mWidth + rect.x1,
+                        data + std::size_t(y - rect.y1) * stride,
+                        rect.width() * sizeof(std::uint16_t));
+        }
+        return damage(rect);
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::flush() {
+        mStatistics.damaged = mDamaged;
+        mStatistics.sent = 0;
+        mStatistics.windows = mRegions.count();
+        for (std::size_t i = 0; i < mRegions.count(); ++i) {
+            const Rect &rect = mRegions.region(i);
+            mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+            if (rect.width() == mWidth) {
+                // Full-width regions are contiguous in the shadow.
+                mDriver.writePixels(rect.area(), mShadow + std::size_t(rect.y1) * mWidth);
+            } else {
+                for (std::uint16_t y = rect.y1; y <= rect.y2; ++y) {
+                    mDriver.writePixels(rect.width(), mShadow + std::size_t(y) * mWidth + rect.x1);
+                }
+            }
+            mStatistics.sent += rect.area();
+        }
+        std::size_t screen = std::size_t(mWidth) * mHeight;
+        mStatistics.saved = mStatistics.sent < screen ? screen - mStatistics.sent : 0;
+        mRegions.clear();
+        mDamaged = 0;
+        return this;
+    }
+
+    DirtyRegionTracker *DirtyRegionTracker::clear() {
+        mRegions.clear();
+        mDamaged = 0;
+        return this;
+    }
+}
@@ -0,0 +1,220 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_DirtyRegionTracker_h__
+#define __Kempozer_Screen_DirtyRegionTracker_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/RegionSet.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A shadow framebuffer in front of a {@link Driver} that remembers which
+     * rectangles have been drawn to, and only sends those on {@link flush()}.
+     *
+     * Damaged rectangles are kept in a {@link RegionSet}, which merges them
+     * whenever sending their bounding box costs no more than sending them
+     * separately, where each extra address window is charged
+     * {@link windowCost()} pixels.
+     */
+    class DirtyRegionTracker {
+    public:
+        /**
+         * Pixel counts for a single call to {@link flush()}.
+         */
+        struct Statistics {
+            std::size_t damaged;
+            std::size_t sent;
+            std::size_t saved;
+            std::size_t windows;
+        };
+
+        /**
+         * Creates a tracker over a width by height shadow framebuffer. The
+         * driver and shadow must outlive this tracker.
+         *
+         * @param driver
+         * @param shadow
+         * @param width
+         * @param height
+         */
+        [[gnu::nonnull]]
+        DirtyRegionTracker(Driver &driver, std::uint16_t *shadow,
+                           std::uint16_t width, std::uint16_t height);
+
+        /**
+         * Gets the shadow framebuffer, in row-major order. Callers that draw
+         * into it directly must report what they drew through
+         * {@link damage(const Rect &)}.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t *shadow() {
+            return mShadow;
+        }
+
+        /**
+         * Gets the width of the shadow framebuffer, which is also its stride.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t width() const {
+            return mWidth;
+        }
+
+        /**
+         * Gets the height of the shadow framebuffer.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t height() const {
+            return mHeight;
+        }
+
+        /**
+         * Marks a rectangle of the shadow framebuffer as changed.
+         *
+         * @param rect
+         */
+        DirtyRegionTracker *damage(Rect rect);
+
+        /**
+         * Marks the whole screen as changed.
+         */
+        DirtyRegionTracker *damageAll();
+
+        /**
+         * Draws a single pixel.
+         *
+         * @param x
+         * @param y
+         * @param color
+         */
+        DirtyRegionTracker *writePixel(std::uint16_t x, std::uint16_t y, std::uint16_t color);
+
+        /**
+         * Fills a rectangle with a single color.
+         *
+         * @param rect
+         * @param color
+         */
+        DirtyRegionTracker *fillRect(Rect rect, std::uint16_t color);
+
+        /**
+         * Copies a rect.width() by rect.height() bitmap into a rectangle.
+         *
+         * @param rect
+         * @param data
+         */
+        [[gnu::nonnull]]
+        DirtyRegionTracker *writePixels(Rect rect, const std::uint16_t *data);
+
+        /**
+         * Sends every damaged region to the driver and forgets them.
+         */
+        DirtyRegionTracker *flush();
+
+        /**
+         * Forgets every damaged region without sending it, for callers that
+         * send the regions themselves.
+         */
+        DirtyRegionTracker *clear();
+
+        /**
+         * Gets the number of regions waiting to be flushed.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t regionCount() const {
+            return mRegions.count();
+        }
+
+        /**
+         * Gets a region waiting to be flushed.
+         *
+         * @param index
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Rect &region(std::size_t index) const {
+            return mRegions.region(index);
+        }
+
+        /**
+         * Gets the cost of setting up an address window, in pixels.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t windowCost() const {
+            return mRegions.windowCost();
+        }
+
+        /**
+         * Sets the cost of setting up an address window, in pixels. A window
+         * setup that sends 11 bytes costs roughly 6 pixels worth of bus time,
+         * plus whatever the driver spends toggling lines and calling.
+         *
+         * @param cost
+         */
+        [[gnu::always_inline]]
+        inline DirtyRegionTracker *windowCost(std::size_t cost) {
+            mRegions.windowCost(cost);
+            return this;
+        }
+
+        /**
+         * Gets the statistics of the last flush.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Statistics &statistics() const {
+            return mStatistics;
+        }
+    private:
+        Driver &mDriver;
+        std::uint16_t *mShadow;
+        std::uint16_t mWidth,
+                      mHeight;
+        std::size_t mDamaged;
+        Statistics mStatistics;
+        RegionSet mRegions;
+    };
+}
+
+#endif//__Kempozer_Screen_DirtyRegionTracker_h__
@@ -0,0 +1,189 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/DisplayList.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        constexpr std::uint32_t FNV_OFFSET = 2166136261u,
+                                FNV_PRIME = 16777619u;
+
+        /**
+         * Folds size bytes into an FNV-1a hash.
+         */
+        std::uint32_t mix(std::uint32_t hash, const void *data, std::size_t size) {
+            const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * FNV_PRIME;
+            }
+            return hash;
+        }
+
+        /**
+         * Folds count pixels into the hash a pixel at a time, which is weaker
+         * than bytewise FNV-1a but half the work on bitmaps.
+         */
+        std::uint32_t mixPixels(std::uint32_t hash, const std::uint16_t *pixels, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                hash = (hash ^ pixels[i]) * FNV_PRIME;
+            }
+            return hash;
+        }
+
+        template<typename T>
+        [[gnu::always_inline]]
+        inline std::uint32_t mix(std::uint32_t hash, const T &value) {
+            return mix(hash, &value, sizeof(T));
+        }
+
+        [[gnu::always_inline]]
+        inline bool same(const DisplayList::Entry &a, const DisplayList::Entry &b) {
+            return a.hash == b.hash && a.bounds.x1 == b.bounds.x1 && a.bounds.y1 == b.bounds.y1 &&
+                   a.bounds.x2 == b.bounds.x2 && a.bounds.y2 == b.bounds.y2;
+        }
+    }
+
+    DisplayList::DisplayList(TiledRenderer &renderer, Entry *entries, Entry *previous, std::size_t capacity)
+        : mRenderer(renderer) {
+        mEntries = entries;
+        mPrevious = previous;
+        mCapacity = capacity;
+        mCount = 0;
+        mPreviousCount = 0;
+        mStatistics = Statistics{};
+        mInvalid = true;
+    }
+
+    DisplayList *DisplayList::begin() {
+        mRenderer.clear();
+        mCount = 0;
+        return this;
+    }
+
+    bool DisplayList::fillRect(Rect rect, std::uint16_t color) {
+        if (mCount == mCapacity) {
+            return false;
+        }
+        std::size_t primitives = mRenderer.size();
+        std::uint32_t hash = mix(mix(FNV_OFFSET, TiledRenderer::PrimitiveType::FillRect), color);
+        return record(mRenderer.fillRect(rect, color), primitives, hash);
+    }
+
+    bool DisplayList::bitmap(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                             const std::uint16_t *pixels) {
+        if (mCount == mCapacity) {
+            return false;
+        }
+        std::size_t primitives = mRenderer.size();
+        // The position is covered by the bounds, but a bitmap clipped at the
+        // edge of the screen also depends on where it starts.
+        std::uint32_t hash = mix(mix(mix(FNV_OFFSET, TiledRenderer::PrimitiveType::Bitmap), x), y);
+        hash = mixPixels(mix(mix(hash, width), height), pixels, std::size_t(width) * height);
+        return record(mRenderer.bitmap(x, y, width, height, pixels), primitives, hash);
+    }
+
+    bool DisplayList::text(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                           std::uint16_t foreground, std::uint16_t background) {
+        if (mCount == mCapacity) {
+            return false;
+        }
+        std::size_t primitives = mRenderer.size();
+        const Font *address = &font;
+        std::uint32_t hash = mix(mix(mix(FNV_OFFSET, TiledRenderer::PrimitiveType::Text), x), y);
+        hash = mix(mix(mix(hash, address), foreground), background);
+        hash = mix(hash, text, std::strlen(text));
+        return record(mRenderer.text(font, x, y, text, foreground, background), primitives, hash);
+    }
+
+    DisplayList *DisplayList::invalidate() {
+        mInvalid = true;
+        return this;
+    }
+
+    DisplayList *DisplayList::present() {
+        mStatistics = Statistics{};
+        mStatistics.commands = mCount;
+        mDamage.clear();
+        if (mInvalid) {
+            mDamage.add(Rect{0, 0, std::uint16_t(mRenderer.width() - 1), std::uint16_t(mRenderer.height() - 1)});
+        } else {
+            // Walk both frames in order. An entry found further on in the
+            // previous frame means the ones skipped over are gone; an entry
+            // not found at all is new or changed.
+            std::size_t cursor = 0;
+            for (std::size_t i = 0; i < mCount; ++i) {
+                std::size_t j = cursor;
+                while (j < mPreviousCount && !same(mEntries[i], mPrevious[j])) {
+                    ++j;
+                }
+                if (j == mPreviousCount) {
+                    mDamage.add(mEntries[i].bounds);
+                    ++mStatistics.changed;
+                    continue;
+                }
+                for (; cursor < j; ++cursor) {
+                    mDamage.add(mPrevious[cursor].bounds);
+                    ++mStatistics.removed;
+                }
+                cursor = j + 1;
+            }
+            for (; cursor < mPreviousCount; ++cursor) {
+                mDamage.add(mPrevious[cursor].bounds);
+                ++mStatistics.removed;
+            }
+        }
+
+        mStatistics.regions = mDamage.count();
+        for (std::size_t i = 0; i < mDamage.count(); ++i) {
+            mRenderer.render(mDamage.region(i));
+            mStatistics.sent += mDamage.region(i).area();
+        }
+
+        Entry *entries = mPrevious;
+        mPrevious = mEntries;
+        mEntries = entries;
+        mPreviousCount = mCount;
+        mCount = 0;
+        mInvalid = false;
+        return this;
+    }
+
+    bool DisplayList::record(bool recorded, std::size_t primitives, std::uint32_t hash) {
+        if (!recorded) {
+            return false;
+        }
+        if (mRenderer.size() == primitives) {
+            // Entirely off screen, so it can neither change nor be damaged.
+            return true;
+        }
+        const Rect &bounds = mRenderer.primitive(primitives).bounds;
+        mEntries[mCount++] = Entry{mix(hash, bounds), bounds};
+        return true;
+    }
+}
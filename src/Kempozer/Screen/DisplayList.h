@@ -0,0 +1,204 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_DisplayList_h__
+#define __Kempozer_Screen_DisplayList_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Font.h"
+#include "Kempozer/Screen/RegionSet.h"
+#include "Kempozer/Screen/TiledRenderer.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A retained display list for user interfaces that issue the same draw
+     * calls every frame.
+     *
+     * Each frame is recorded between {@link begin()} and {@link present()}
+     * into a {@link TiledRenderer}. Every command is also reduced to an
+     * {@link Entry}: a hash of its kind, parameters and content, and the
+     * rectangle it covers. present() matches the entries against those of the
+     * previous frame in order; the bounds of commands that are new, changed,
+     * moved or gone become damage, and only the damaged parts of the screen
+     * are rasterized and sent. Commands that overlap damage are replayed
+     * inside it so that stacking is preserved, but nothing outside it is
+     * touched.
+     *
+     * Bitmap contents are hashed, so bitmaps that are modified in place are
+     * picked up without being re-recorded under a new address.
+     */
+    class DisplayList {
+    public:
+        /**
+         * A recorded command, as far as diffing is concerned.
+         */
+        struct Entry {
+            std::uint32_t hash;
+            Rect bounds;
+        };
+
+        /**
+         * Counts for a single call to {@link present()}. sent is in pixels.
+         */
+        struct Statistics {
+            std::size_t commands;
+            std::size_t changed;
+            std::size_t removed;
+            std::size_t regions;
+            std::size_t sent;
+        };
+
+        /**
+         * Creates a display list drawing through renderer, whose primitive
+         * capacity should be at least capacity. entries and previous must each
+         * hold capacity entries. All three must outlive this display list.
+         *
+         * The whole screen is damaged by the first frame.
+         *
+         * @param renderer
+         * @param entries
+         * @param previous
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        DisplayList(TiledRenderer &renderer, Entry *entries, Entry *previous, std::size_t capacity);
+
+        /**
+         * Starts recording a frame.
+         */
+        DisplayList *begin();
+
+        /**
+         * Records a filled rectangle.
+         *
+         * @param rect
+         * @param color
+         * @return Whether the command was recorded.
+         */
+        bool fillRect(Rect rect, std::uint16_t color);
+
+        /**
+         * Records a width by height RGB565 bitmap with its top-left corner at
+         * (x, y).
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param height
+         * @param pixels
+         * @return Whether the command was recorded.
+         */
+        [[gnu::nonnull]]
+        bool bitmap(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                    const std::uint16_t *pixels);
+
+        /**
+         * Records a line of text, see {@link TiledRenderer::text}.
+         *
+         * @param font
+         * @param x
+         * @param y
+         * @param text
+         * @param foreground
+         * @param background
+         * @return Whether the command was recorded.
+         */
+        [[gnu::nonnull]]
+        bool text(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                  std::uint16_t foreground, std::uint16_t background);
+
+        /**
+         * Damages the whole screen on the next {@link present()}, such as
+         * after the screen was drawn to behind this list's back.
+         */
+        DisplayList *invalidate();
+
+        /**
+         * Diffs the recorded frame against the previous one, and rasterizes
+         * and sends whatever changed.
+         */
+        DisplayList *present();
+
+        /**
+         * Gets the damage found by the last {@link present()}.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const RegionSet &damage() const {
+            return mDamage;
+        }
+
+        /**
+         * Gets the statistics of the last {@link present()}.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Statistics &statistics() const {
+            return mStatistics;
+        }
+    private:
+        bool record(bool recorded, std::size_t primitives, std::uint32_t hash);
+
+        TiledRenderer &mRenderer;
+        Entry *mEntries,
+              *mPrevious;
+        std::size_t mCapacity,
+                    mCount,
+                    mPreviousCount;
+        Statistics mStatistics;
+        RegionSet mDamage;
+        bool mInvalid;
+    };
+
+    /**
+     * A {@link DisplayList} that owns the entries of Capacity commands.
+     *
+     * @tparam Capacity
+     */
+    template<std::size_t Capacity>
+    class StaticDisplayList : public DisplayList {
+    public:
+        /**
+         * Creates a display list drawing through renderer.
+         *
+         * @param renderer
+         */
+        explicit StaticDisplayList(TiledRenderer &renderer)
+            : DisplayList(renderer, mStorage[0], mStorage[1], Capacity) {
+        }
+    private:
+        Entry mStorage[2][Capacity];
+    };
+}
+
+#endif//__Kempozer_Screen_DisplayList_h__
@@ -26,18 +26,64 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 #include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/ColorConversion.h"
+#include "Kempozer/Screen/CommandBuffer.h"
+#include "Kempozer/Screen/InitSequence.h"
+#include "KempozerScreenConfig.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
 
 namespace Kempozer::Screen {
-    Driver *Driver::resolution(std::uint16_t& width, std::uint16_t& height) {
-        if (rotated()) {
-            width = mHeight;
-            height = mWidth;
-        } else {
-            width = mWidth;
-            height = mHeight;
+    namespace {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        constexpr ByteOrder HOST_BYTE_ORDER = ByteOrder::BigEndian;
+#else
+        constexpr ByteOrder HOST_BYTE_ORDER = ByteOrder::LittleEndian;
+#endif
+
+        /**
+         * Gets whether or not an init sequence segment holds a command of more
+         * than one byte, which is affected by byte order.
+         */
+        bool hasWideCommand(const InitSegment &segment) {
+            CommandBuffer::Record record;
+            std::size_t offset = 0;
+            while (std::size_t size = CommandBuffer::decode(segment.length - offset, segment.records + offset, record)) {
+                if (record.type == CommandBuffer::RecordType::Command && record.length > 1) {
+                    return true;
+                }
+                offset += size;
+            }
+            return false;
         }
+    }
+
+    Driver *Driver::rotate(int rotation) {
+        mRotation = std::uint8_t(rotation & 3);
+        mHardwareRotation = applyRotation(mRotation) || !mRotation;
+        return resize(mWidth, mHeight);
+    }
+
+    Driver *Driver::resize(std::uint16_t width, std::uint16_t height) {
+        mWidth = width;
+        mHeight = height;
+        mLogicalWidth = rotated() ? height : width;
+        mLogicalHeight = rotated() ? width : height;
         return this;
     }
+
+    Driver *Driver::mirror(std::uint16_t width, std::uint16_t height, ByteOrder byteOrder, int rotation,
+                           bool hardwareRotation) {
+        mByteOrder = byteOrder;
+        mRotation = std::uint8_t(rotation);
+        mHardwareRotation = hardwareRotation;
+        return resize(width, height);
+    }
     
     Driver *Driver::writePixels(std::size_t count, const std::uint16_t *data) {
         for (size_t i = 0; i < count; ++i) {
@@ -47,23 +93,111 @@ namespace Kempozer::Screen {
     }
 
     Driver *Driver::writeRepeatedPixel(std::size_t count, const std::uint16_t color) {
-        for (size_t i = 0; i < count; ++i) {
-            writePixel(color);
+        std::uint16_t chunk[KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK];
+        std::size_t size = count < KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK ? count : KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK;
+        for (std::size_t i = 0; i < size; ++i) {
+            chunk[i] = color;
+        }
+        while (count > size) {
+            writePixels(size, chunk);
+            count -= size;
+        }
+        return writePixels(count, chunk);
+    }
+
+    Driver *Driver::writePixels(std::size_t count, const std::uint32_t *argb) {
+        std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        while (count) {
+            std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            argb8888ToRgb565(size, argb, chunk);
+            writePixels(size, chunk);
+            argb += size;
+            count -= size;
+        }
+        return this;
+    }
+
+    Driver *Driver::writeRgb888Pixels(std::size_t count, const std::uint8_t *rgb) {
+        if (pixelFormat() == PixelFormat::Rgb888) {
+            return writeNativePixels(count, rgb);
+        }
+        std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        while (count) {
+            std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            rgb888ToRgb565(size, rgb, chunk);
+            writePixels(size, chunk);
+            rgb += size * 3;
+            count -= size;
+        }
+        return this;
+    }
+
+    PixelFormat Driver::pixelFormat() {
+        return PixelFormat::Rgb565;
+    }
+
+    Driver *Driver::writeNativePixels(std::size_t count, const std::uint8_t *data) {
+        // Chunks hold a multiple of 8 pixels, so that 1-bit pixels start each
+        // chunk on a byte boundary.
+        constexpr std::size_t CHUNK = KEMPOZER_SCREEN_CONVERSION_CHUNK & ~std::size_t(7);
+        static_assert(CHUNK > 0, "KEMPOZER_SCREEN_CONVERSION_CHUNK must be at least 8");
+        PixelFormat format = pixelFormat();
+        std::uint16_t chunk[CHUNK];
+        while (count) {
+            std::size_t size = count < CHUNK ? count : CHUNK;
+            nativeToRgb565(format, size, data, chunk);
+            writePixels(size, chunk);
+            data += pixelBytes(format, size);
+            count -= size;
+        }
+        return this;
+    }
+
+    Driver *Driver::writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) {
+        return writeRepeatedPixel(count, nativeToRgb565(pixelFormat(), pixel));
+    }
+
+    Driver *Driver::writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                     TransferCallback callback, void *context) {
+        writePixels(count, data);
+        if (callback) {
+            callback(this, context);
         }
         return this;
     }
 
+    bool Driver::poll() {
+        return false;
+    }
+
+    Driver *Driver::wait() {
+        while (poll());
+        return this;
+    }
+
     Driver *Driver::write16(std::uint16_t u16) {
+        if (mByteOrder == ByteOrder::BigEndian) {
+            write(std::uint8_t(u16 >> 8));
+            return write(std::uint8_t(u16));
+        }
         write(std::uint8_t(u16));
         return write(std::uint8_t(u16 >> 8));
     }
 
     Driver *Driver::write32(std::uint32_t u32) {
+        if (mByteOrder == ByteOrder::BigEndian) {
+            write16(std::uint16_t(u32 >> 16));
+            return write16(std::uint16_t(u32));
+        }
         write16(std::uint16_t(u32));
         return write16(std::uint16_t(u32 >> 16));
     }
 
     Driver *Driver::write64(std::uint64_t u64) {
+        if (mByteOrder == ByteOrder::BigEndian) {
+            write32(std::uint32_t(u64 >> 32));
+            return write32(std::uint32_t(u64));
+        }
         write32(std::uint32_t(u64));
         return write32(std::uint32_t(u64 >> 32));
     }
@@ -75,22 +209,181 @@ namespace Kempozer::Screen {
         return this;
     }
 
+    Driver *Driver::writeArray16(std::size_t count, const std::uint16_t *data) {
+        if (mByteOrder == HOST_BYTE_ORDER) {
+            return writeArray(count * sizeof(std::uint16_t), reinterpret_cast<const std::uint8_t *>(data));
+        }
+        std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        while (count) {
+            std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            swapBytes16(size, data, chunk);
+            writeArray(size * sizeof(std::uint16_t), reinterpret_cast<const std::uint8_t *>(chunk));
+            data += size;
+            count -= size;
+        }
+        return this;
+    }
+
+    Driver *Driver::submit(std::size_t count, const std::uint8_t *data) {
+        CommandBuffer::Record record;
+        while (std::size_t size = CommandBuffer::decode(count, data, record)) {
+            switch (record.type) {
+                case CommandBuffer::RecordType::Command:
+                    assertCommand();
+                    writeArray(record.length, record.payload);
+                    deassertCommand();
+                    break;
+                case CommandBuffer::RecordType::Data:
+                    writeArray(record.length, record.payload);
+                    break;
+                case CommandBuffer::RecordType::Pixels:
+                    writePixels(record.length / sizeof(std::uint16_t),
+                                reinterpret_cast<const std::uint16_t *>(record.payload));
+                    break;
+            }
+            count -= size;
+            data += size;
+        }
+        return this;
+    }
+
+    Driver *Driver::writeSequence(std::size_t count, const std::uint8_t *data) {
+        // Tables hold multi-byte commands in the wire byte order; a driver
+        // using the other order gets those records reversed one at a time.
+        bool reversed = byteOrder() != KEMPOZER_SCREEN_WIRE_BYTE_ORDER;
+        InitSegment segment;
+        select();
+        while (std::size_t size = InitSegment::decode(count, data, segment)) {
+            if (!reversed || !hasWideCommand(segment)) {
+                submit(segment.length, segment.records);
+            } else {
+                CommandBuffer::Record record;
+                for (std::size_t offset = 0; offset < segment.length;) {
+                    std::size_t recordSize = CommandBuffer::decode(segment.length - offset, segment.records + offset, record);
+                    if (!recordSize) {
+                        break;
+                    }
+                    if (record.type == CommandBuffer::RecordType::Command) {
+                        std::uint8_t command[8];
+                        std::size_t length = record.length < sizeof(command) ? record.length : sizeof(command);
+                        for (std::size_t i = 0; i < length; ++i) {
+                            command[i] = record.payload[length - 1 - i];
+                        }
+                        assertCommand();
+                        writeArray(length, command);
+                        deassertCommand();
+                    } else {
+                        submit(recordSize, segment.records + offset);
+                    }
+                    offset += recordSize;
+                }
+            }
+            if (segment.delay) {
+                pause(segment.delay);
+            }
+            count -= size;
+            data += size;
+        }
+        deselect();
+        return this;
+    }
+
+    Driver *Driver::pause(std::uint16_t milliseconds) {
+#if defined(ARDUINO)
+        delay(milliseconds);
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+#endif
+        return this;
+    }
+
     void Driver::readPixels(std::size_t count, std::uint16_t *data) {
         for (std::size_t i = 0; i < count; ++i) {
             data[i] = readPixel();
         }
     }
 
+    void Driver::readRgb888Pixels(std::size_t count, std::uint8_t *rgb) {
+        std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+        while (count) {
+            std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            readPixels(size, chunk);
+            rgb565ToRgb888(size, chunk, rgb);
+            rgb += size * 3;
+            count -= size;
+        }
+    }
+
+    bool Driver::beginRead() {
+        return false;
+    }
+
+    Driver *Driver::readRegion(std::uint16_t x1, std::uint16_t y1, std::uint16_t x2, std::uint16_t y2,
+                               std::uint16_t *buffer) {
+        Rect window{x1, y1, x2, y2};
+        if (!window.clip(mLogicalWidth, mLogicalHeight)) {
+            return this;
+        }
+        transform(window);
+        setAddressWindow(window.x1, window.y1, window.x2, window.y2);
+        std::size_t count = window.area();
+        if (beginRead()) {
+            readArray16(count, buffer);
+        } else {
+            readPixels(count, buffer);
+        }
+        return this;
+    }
+
+    Driver *Driver::readRegion(std::uint16_t x1, std::uint16_t y1, std::uint16_t x2, std::uint16_t y2,
+                               std::uint16_t *buffer, std::size_t capacity,
+                               ReadCallback callback, void *context) {
+        Rect window{x1, y1, x2, y2};
+        if (!capacity || !window.clip(mLogicalWidth, mLogicalHeight)) {
+            return this;
+        }
+        transform(window);
+        setAddressWindow(window.x1, window.y1, window.x2, window.y2);
+        std::size_t count = window.area();
+        bool burst = beginRead();
+        while (count) {
+            std::size_t size = count < capacity ? count : capacity;
+            if (burst) {
+                readArray16(size, buffer);
+            } else {
+                readPixels(size, buffer);
+            }
+            callback(this, context, buffer, size);
+            count -= size;
+        }
+        return this;
+    }
+
     std::uint16_t Driver::read16() {
-        return std::uint16_t(read()) | (std::uint16_t(read()) << 8);
+        std::uint16_t first = read(),
+                      second = read();
+        if (mByteOrder == ByteOrder::BigEndian) {
+            return (first << 8) | second;
+        }
+        return first | (second << 8);
     }
 
     std::uint32_t Driver::read32() {
-        return std::uint32_t(read16()) | (std::uint32_t(read16()) << 16);
+        std::uint32_t first = read16(),
+                      second = read16();
+        if (mByteOrder == ByteOrder::BigEndian) {
+            return (first << 16) | second;
+        }
+        return first | (second << 16);
     }
 
     std::uint64_t Driver::read64() {
-        return std::uint64_t(read32()) | (std::uint64_t(read32()) << 32);
+        std::uint64_t first = read32(),
+                      second = read32();
+        if (mByteOrder == ByteOrder::BigEndian) {
+            return (first << 32) | second;
+        }
+        return first | (second << 32);
     }
 
     void Driver::readArray(std::size_t count, std::uint8_t *data) {
@@ -99,7 +392,52 @@ namespace Kempozer::Screen {
         }
     }
 
-    Driver *Driver::rotate(int rotation) {
+    void Driver::readArray16(std::size_t count, std::uint16_t *data) {
+        // Swap each chunk right after reading it, while it is still in cache.
+        while (count) {
+            std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+            readArray(size * sizeof(std::uint16_t), reinterpret_cast<std::uint8_t *>(data));
+            if (mByteOrder != HOST_BYTE_ORDER) {
+                swapBytes16(size, data, data);
+            }
+            data += size;
+            count -= size;
+        }
+    }
+
+    bool Driver::applyRotation(int rotation) {
+        return false;
+    }
+
+    Driver *Driver::scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) {
+        return this;
+    }
+
+    Driver *Driver::scroll(std::uint16_t start) {
+        return this;
+    }
+
+    bool Driver::scrollable() {
+        return false;
+    }
+
+    Driver *Driver::partialArea(std::uint16_t start, std::uint16_t end) {
+        return this;
+    }
+
+    Driver *Driver::partialMode(bool enabled) {
+        return this;
+    }
+
+    Driver *Driver::tearingEffectOutput(bool enabled) {
         return this;
     }
+
+    bool Driver::hasTearingEffect() {
+        return false;
+    }
+
+    bool Driver::tearingEffect() {
+        return false;
+    }
 }
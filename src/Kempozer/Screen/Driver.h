@@ -32,6 +32,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdint>
 #include <type_traits>
 #include "KempozerScreenConcepts.h"
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/PixelFormat.h"
+#include "Kempozer/Screen/Types.h"
 
 namespace Kempozer::Screen {
 
@@ -118,7 +121,11 @@ namespace Kempozer::Screen {
         virtual Driver *writePixels(std::size_t count, const std::uint16_t *data);
 
         /**
-         * Sends the same color of pixel to the screen repeatedly.
+         * Sends the same color of pixel to the screen repeatedly. The default
+         * implementation fills a buffer of KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK
+         * pixels on the stack and sends it through
+         * {@link writePixels(std::size_t, const std::uint16_t *)}, so drivers
+         * that override writePixels get bulk fills for free.
          * 
          * @param count
          * @param color
@@ -137,6 +144,173 @@ namespace Kempozer::Screen {
             return writePixels(C, data);
         }
 
+        /**
+         * Converts count ARGB8888 pixels (0xAARRGGBB) to RGB565 and sends them
+         * to the screen, KEMPOZER_SCREEN_CONVERSION_CHUNK pixels at a time
+         * through {@link writePixels(std::size_t, const std::uint16_t *)}.
+         * 
+         * @param count
+         * @param argb
+         */
+        [[gnu::nonnull]]
+        Driver *writePixels(std::size_t count, const std::uint32_t *argb);
+
+        /**
+         * Converts count packed RGB888 pixels (R, G, B byte order) to RGB565
+         * and sends them to the screen, KEMPOZER_SCREEN_CONVERSION_CHUNK
+         * pixels at a time through
+         * {@link writePixels(std::size_t, const std::uint16_t *)}.
+         * 
+         * @param count
+         * @param rgb
+         */
+        [[gnu::nonnull]]
+        Driver *writeRgb888Pixels(std::size_t count, const std::uint8_t *rgb);
+
+        /**
+         * Gets the format in which the controller takes pixels. The default is
+         * {@link PixelFormat::Rgb565}.
+         *
+         * @return
+         */
+        virtual PixelFormat pixelFormat();
+
+        /**
+         * Sends count pixels already in this driver's {@link pixelFormat()},
+         * which take pixelBytes(pixelFormat(), count) bytes. Drivers whose
+         * format is not RGB565 should override this method to send the bytes
+         * as they are; the default implementation converts them to RGB565
+         * KEMPOZER_SCREEN_CONVERSION_CHUNK pixels at a time and sends them
+         * through {@link writePixels(std::size_t, const std::uint16_t *)}.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        virtual Driver *writeNativePixels(std::size_t count, const std::uint8_t *data);
+
+        /**
+         * Sends the same pixel in this driver's {@link pixelFormat()}
+         * repeatedly. pixel is the value of its wire bytes, as given by
+         * {@link PixelTraits::native}. The default implementation converts it
+         * to RGB565 and sends it through
+         * {@link writeRepeatedPixel(std::size_t, std::uint16_t)}.
+         *
+         * @param count
+         * @param pixel
+         */
+        virtual Driver *writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel);
+
+        /**
+         * Sends count pixels of Format to the screen. When Format is this
+         * driver's {@link pixelFormat()}, they go through
+         * {@link writeNativePixels(std::size_t, const std::uint8_t *)}:
+         * directly for formats whose pixels are stored as they are sent, and
+         * otherwise packed into a small buffer on the stack. Pixels of any
+         * other format are converted to RGB565 first.
+         *
+         * @tparam Format
+         * @param count
+         * @param pixels
+         */
+        template<PixelFormat Format>
+        [[gnu::nonnull]]
+        inline Driver *writePixels(std::size_t count, const typename PixelTraits<Format>::Pixel *pixels) {
+            using Traits = PixelTraits<Format>;
+            if constexpr (Format == PixelFormat::Rgb565) {
+                return writePixels(count, pixels);
+            } else if (pixelFormat() != Format) {
+                std::uint16_t chunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+                while (count) {
+                    std::size_t size = count < KEMPOZER_SCREEN_CONVERSION_CHUNK ? count : KEMPOZER_SCREEN_CONVERSION_CHUNK;
+                    for (std::size_t i = 0; i < size; ++i) {
+                        chunk[i] = Traits::toRgb565(pixels[i]);
+                    }
+                    writePixels(size, chunk);
+                    pixels += size;
+                    count -= size;
+                }
+                return this;
+            } else if constexpr (Traits::CONTIGUOUS) {
+                return writeNativePixels(count, reinterpret_cast<const std::uint8_t *>(pixels));
+            } else {
+                constexpr std::size_t CHUNK = 2 * KEMPOZER_SCREEN_CONVERSION_CHUNK * 8 / Traits::BITS;
+                std::uint8_t chunk[2 * KEMPOZER_SCREEN_CONVERSION_CHUNK] = {};
+                while (count) {
+                    std::size_t size = count < CHUNK ? count : CHUNK;
+                    for (std::size_t i = 0; i < size; ++i) {
+                        Traits::store(chunk, i, pixels[i]);
+                    }
+                    writeNativePixels(size, chunk);
+                    pixels += size;
+                    count -= size;
+                }
+                return this;
+            }
+        }
+
+        /**
+         * Sends the same pixel of Format to the screen repeatedly, natively
+         * when Format is this driver's {@link pixelFormat()} and as RGB565
+         * otherwise.
+         *
+         * @tparam Format
+         * @param count
+         * @param pixel
+         */
+        template<PixelFormat Format>
+        inline Driver *writeRepeatedPixel(std::size_t count, typename PixelTraits<Format>::Pixel pixel) {
+            using Traits = PixelTraits<Format>;
+            if constexpr (Format == PixelFormat::Rgb565) {
+                return writeRepeatedPixel(count, pixel);
+            } else if (pixelFormat() == Format) {
+                return writeRepeatedNativePixel(count, Traits::native(pixel));
+            } else {
+                return writeRepeatedPixel(count, Traits::toRgb565(pixel));
+            }
+        }
+
+        /**
+         * Called once an asynchronous transfer has completed and its buffer may
+         * be reused. This may be called from an interrupt.
+         */
+        using TransferCallback = void (*)(Driver *driver, void *context);
+
+        /**
+         * Starts sending all 16-bit pixels to the screen and returns, possibly
+         * before the transfer has completed. data must remain valid and
+         * unmodified until callback is called with context. If a previous
+         * transfer is still in progress, it is waited for first.
+         * 
+         * Drivers capable of DMA or interrupt driven transfers should override
+         * this method, {@link poll()} and {@link wait()}. The default
+         * implementation sends the pixels synchronously through
+         * {@link writePixels(std::size_t, const std::uint16_t *)} and calls
+         * callback before returning.
+         * 
+         * @param count
+         * @param data
+         * @param callback
+         * @param context
+         */
+        [[gnu::nonnull(3)]]
+        virtual Driver *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                         TransferCallback callback = nullptr, void *context = nullptr);
+
+        /**
+         * Advances any asynchronous transfer in progress, calling its callback
+         * if it has completed.
+         * 
+         * @return Whether an asynchronous transfer is still in progress.
+         */
+        virtual bool poll();
+
+        /**
+         * Blocks until every asynchronous transfer has completed and its
+         * callback has been called.
+         */
+        virtual Driver *wait();
+
         /**
          * Sends an 8-bit value to the screen. At minimum, this send method must
          * be implemented, though the others should be overridden with higher
@@ -151,21 +325,24 @@ namespace Kempozer::Screen {
         virtual Driver *write(std::uint8_t u8) = 0;
 
         /**
-         * Sends a 16-bit value to the screen.
+         * Sends a 16-bit value to the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @param u16
          */
         virtual Driver *write16(std::uint16_t u16);
 
         /**
-         * Sends a 32-bit value to the screen.
+         * Sends a 32-bit value to the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @param u32
          */
         virtual Driver *write32(std::uint32_t u32);
 
         /**
-         * Sends a 64-bit value to the screen.
+         * Sends a 64-bit value to the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @param u64
          */
@@ -192,6 +369,69 @@ namespace Kempozer::Screen {
             return writeArray(C, data);
         }
 
+        /**
+         * Sends count 16-bit values to the screen in this driver's
+         * {@link byteOrder()}. The default implementation passes data straight
+         * to {@link writeArray(std::size_t, const std::uint8_t *)} when the byte
+         * order matches the host's, and otherwise byte swaps it in chunks of
+         * KEMPOZER_SCREEN_CONVERSION_CHUNK values on the way out.
+         * 
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        virtual Driver *writeArray16(std::size_t count, const std::uint16_t *data);
+
+        /**
+         * Sends a batch of commands, parameters and pixels recorded by a
+         * {@link CommandBuffer}. Drivers that can should override this method
+         * to send the whole batch as a single bus transaction; the default
+         * implementation replays each record through {@link writeCommand},
+         * {@link writeArray(std::size_t, const std::uint8_t *)} and
+         * {@link writePixels(std::size_t, const std::uint16_t *)}.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        virtual Driver *submit(std::size_t count, const std::uint8_t *data);
+
+        /**
+         * Plays back an init sequence table built by {@link initSequence}:
+         * each run of commands between delays is handed to
+         * {@link submit(std::size_t, const std::uint8_t *)} in one call, so
+         * parameters go out as a single data phase per command, and each
+         * delay is waited out with {@link pause(std::uint16_t)}. The whole
+         * sequence is sent within one selection.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        Driver *writeSequence(std::size_t count, const std::uint8_t *data);
+
+        /**
+         * Plays back an {@link InitSequence}.
+         *
+         * @tparam SequenceT
+         * @param sequence
+         */
+        template<typename SequenceT>
+        [[gnu::always_inline]]
+        inline Driver *writeSequence(const SequenceT &sequence) {
+            return writeSequence(sequence.size(), sequence.data());
+        }
+
+        /**
+         * Waits for the given number of milliseconds, such as after a reset
+         * or sleep out command. The default implementation blocks with the
+         * platform's delay; drivers without real hardware behind them may
+         * return immediately.
+         *
+         * @param milliseconds
+         */
+        virtual Driver *pause(std::uint16_t milliseconds);
+
         /**
          * Reads a single pixel from the screen.
          */
@@ -212,6 +452,85 @@ namespace Kempozer::Screen {
             readPixels(C, data);
         }
 
+        /**
+         * Reads count pixels from the screen as packed RGB888 (R, G, B byte
+         * order), KEMPOZER_SCREEN_CONVERSION_CHUNK pixels at a time through
+         * {@link readPixels(std::size_t, std::uint16_t *)}.
+         * 
+         * @param count
+         * @param rgb
+         */
+        [[gnu::nonnull]]
+        void readRgb888Pixels(std::size_t count, std::uint8_t *rgb);
+
+        /**
+         * Starts a burst read of graphics RAM from the start of the current
+         * address window, as RAMRD does on MIPI-DCS controllers. The driver
+         * pays for the bus turnaround and any dummy read here, once per burst
+         * (for instance KEMPOZER_SCREEN_HX8357_READ_DELAY on HX8357 panels),
+         * after which {@link readArray16(std::size_t, std::uint16_t *)}
+         * returns consecutive pixels.
+         * 
+         * The default implementation returns false, meaning the driver only
+         * supports reading through {@link readPixel()}.
+         * 
+         * @return Whether a burst was started.
+         */
+        virtual bool beginRead();
+
+        /**
+         * Called with each chunk of pixels read by
+         * {@link readRegion(std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t *, std::size_t, ReadCallback, void *)}.
+         * The burst is still open, so the driver must not be used.
+         */
+        using ReadCallback = void (*)(Driver *driver, void *context,
+                                      const std::uint16_t *pixels, std::size_t count);
+
+        /**
+         * Reads the pixels of a window into buffer, which must hold
+         * (x2 - x1 + 1) * (y2 - y1 + 1) pixels, in row-major order. The window
+         * is given in logical coordinates and first clipped to the screen, and
+         * buffer then receives the pixels of the clipped window only; nothing
+         * is read if the window is reversed or entirely off screen. The window
+         * is mapped through {@link transform(Rect &)}, so when the rotation is
+         * applied in software the pixels come back in native order, running
+         * along the native axes. The window is read with one
+         * {@link beginRead()} and one bulk
+         * {@link readArray16(std::size_t, std::uint16_t *)}, falling back to
+         * {@link readPixels(std::size_t, std::uint16_t *)} if the driver does
+         * not support burst reads.
+         * 
+         * @param x1
+         * @param y1
+         * @param x2
+         * @param y2
+         * @param buffer
+         */
+        [[gnu::nonnull]]
+        Driver *readRegion(std::uint16_t x1, std::uint16_t y1, std::uint16_t x2, std::uint16_t y2,
+                           std::uint16_t *buffer);
+
+        /**
+         * Reads the pixels of a window in row-major order, capacity pixels at
+         * a time into buffer, handing each chunk to callback. The whole window
+         * is still read in a single burst, so snapshots of any size need only
+         * a small buffer. The window is clipped and mapped as above, so under
+         * software rotation the chunks run in native order.
+         * 
+         * @param x1
+         * @param y1
+         * @param x2
+         * @param y2
+         * @param buffer
+         * @param capacity
+         * @param callback
+         * @param context
+         */
+        [[gnu::nonnull(6, 8)]]
+        Driver *readRegion(std::uint16_t x1, std::uint16_t y1, std::uint16_t x2, std::uint16_t y2,
+                           std::uint16_t *buffer, std::size_t capacity,
+                           ReadCallback callback, void *context = nullptr);
+
         /**
          * Receives an 8-bit value from the screen.
          * 
@@ -220,21 +539,24 @@ namespace Kempozer::Screen {
         virtual std::uint8_t read() = 0;
 
         /**
-         * Receives a 16-bit value from the screen.
+         * Receives a 16-bit value from the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @return
          */
         virtual std::uint16_t read16();
 
         /**
-         * Receives a 32-bit value from the screen.
+         * Receives a 32-bit value from the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @return
          */
         virtual std::uint32_t read32();
 
         /**
-         * Receives a 64-bit value from the screen.
+         * Receives a 64-bit value from the screen in this driver's
+         * {@link byteOrder()}.
          * 
          * @return
          */
@@ -261,6 +583,43 @@ namespace Kempozer::Screen {
             readArray(C, data);
         }
 
+        /**
+         * Receives count 16-bit values from the screen in this driver's
+         * {@link byteOrder()}. The default implementation reads through
+         * {@link readArray(std::size_t, std::uint8_t *)} in chunks of
+         * KEMPOZER_SCREEN_CONVERSION_CHUNK values, byte swapping each chunk
+         * as it arrives when the byte order differs from the host's.
+         * 
+         * @param count
+         * @param data
+         */
+        [[gnu::nonnull]]
+        virtual void readArray16(std::size_t count, std::uint16_t *data);
+
+        /**
+         * Gets the order in which the bytes of multi-byte values are sent to
+         * and received from the screen.
+         * 
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline ByteOrder byteOrder() const {
+            return mByteOrder;
+        }
+
+        /**
+         * Sets the order in which the bytes of multi-byte values are sent to
+         * and received from the screen. Defaults to
+         * KEMPOZER_SCREEN_WIRE_BYTE_ORDER.
+         * 
+         * @param byteOrder
+         */
+        [[gnu::always_inline]]
+        inline Driver *byteOrder(ByteOrder byteOrder) {
+            mByteOrder = byteOrder;
+            return this;
+        }
+
         /**
          * Gets the write or read graphics RAM address window.
          * 
@@ -301,38 +660,201 @@ namespace Kempozer::Screen {
                                          std::uint16_t x2, std::uint16_t y2) = 0;
 
         /**
-         * Rotates the screen to the given rotation. The values of rotation
-         * are defined by the individual driver. If the driver does not
-         * support rotation, then this method is a no-op. 
+         * Rotates the screen clockwise by the given number of quarter turns:
+         * 0, 1, 2 and 3 select 0, 90, 180 and 270 degrees respectively. The
+         * rotation is recorded and the logical resolution recomputed whether
+         * or not the controller can rotate; see {@link hardwareRotation()}.
          * 
          * @param rotation
          */
-        virtual Driver *rotate(int rotation);
+        Driver *rotate(int rotation);
+
+        /**
+         * Gets the number of clockwise quarter turns the screen is rotated by.
+         * 
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline int rotation() const {
+            return mRotation;
+        }
+
+        /**
+         * Gets whether or not the screen has been rotated by 90 or 270
+         * degrees, that is, whether its logical width and height are swapped.
+         * 
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool rotated() const {
+            return mRotation & 1;
+        }
+
+        /**
+         * Gets whether or not the controller applies the current rotation
+         * itself, in which case address windows and pixel streams are given
+         * in logical coordinates and order. Otherwise drawing code must pass
+         * coordinates through {@link transform(std::uint16_t &, std::uint16_t &)}
+         * and order pixels along the native axes.
+         * 
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool hardwareRotation() const {
+            return mHardwareRotation;
+        }
+
+        /**
+         * Maps a logical point to the address the controller expects for it.
+         * This is the identity unless the rotation is applied in software.
+         * 
+         * @param x
+         * @param y
+         */
+        [[gnu::always_inline]]
+        inline void transform(std::uint16_t &x, std::uint16_t &y) const {
+            if (mHardwareRotation) {
+                return;
+            }
+            std::uint16_t logicalX = x;
+            switch (mRotation) {
+                case 1:
+                    x = mWidth - 1 - y;
+                    y = logicalX;
+                    break;
+                case 2:
+                    x = mWidth - 1 - x;
+                    y = mHeight - 1 - y;
+                    break;
+                case 3:
+                    x = y;
+                    y = mHeight - 1 - logicalX;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        /**
+         * Maps a logical rectangle to the address window the controller
+         * expects for it. When the rotation is applied in software, pixels
+         * streamed into the window run along the native axes.
+         * 
+         * @param rect
+         */
+        [[gnu::always_inline]]
+        inline void transform(Rect &rect) const {
+            if (mHardwareRotation || !mRotation) {
+                return;
+            }
+            std::uint16_t x1 = rect.x1,
+                          y1 = rect.y1,
+                          x2 = rect.x2,
+                          y2 = rect.y2;
+            transform(x1, y1);
+            transform(x2, y2);
+            rect.x1 = x1 < x2 ? x1 : x2;
+            rect.y1 = y1 < y2 ? y1 : y2;
+            rect.x2 = x1 < x2 ? x2 : x1;
+            rect.y2 = y1 < y2 ? y2 : y1;
+        }
+
+        /**
+         * Defines the vertical scrolling area of the screen as top fixed rows,
+         * followed by height scrolling rows, followed by bottom fixed rows,
+         * counted along the screen's native (unrotated) vertical axis. The
+         * three must add up to the native height of the screen. If the driver
+         * does not support hardware scrolling, then this method is a no-op.
+         * 
+         * @param top
+         * @param height
+         * @param bottom
+         */
+        virtual Driver *scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom);
+
+        /**
+         * Sets the graphics RAM row shown at the first line of the vertical
+         * scrolling area defined by {@link scrollArea(std::uint16_t, std::uint16_t, std::uint16_t)}.
+         * If the driver does not support hardware scrolling, then this method
+         * is a no-op.
+         * 
+         * @param start
+         */
+        virtual Driver *scroll(std::uint16_t start);
+
+        /**
+         * Gets whether or not {@link scrollArea(std::uint16_t, std::uint16_t, std::uint16_t)}
+         * and {@link scroll(std::uint16_t)} move the picture on this screen.
+         * 
+         * @return
+         */
+        virtual bool scrollable();
+
+        /**
+         * Defines the rows, inclusive and along the screen's native vertical
+         * axis, that remain lit in partial display mode. If the driver does
+         * not support partial display mode, then this method is a no-op.
+         * 
+         * @param start
+         * @param end
+         */
+        virtual Driver *partialArea(std::uint16_t start, std::uint16_t end);
+
+        /**
+         * Enters partial display mode, which only drives the rows defined by
+         * {@link partialArea(std::uint16_t, std::uint16_t)}, or returns to
+         * normal display mode. If the driver does not support partial display
+         * mode, then this method is a no-op.
+         * 
+         * @param enabled
+         */
+        virtual Driver *partialMode(bool enabled);
 
         /**
-         * Gets whether or not the screen has been rotated.
+         * Turns the tearing effect output of the controller (TEON/TEOFF) on
+         * or off. While on, the controller raises its TE line for the
+         * duration of every vertical blanking period. If the driver has no
+         * TE line wired, then this method is a no-op.
+         * 
+         * @param enabled
+         */
+        virtual Driver *tearingEffectOutput(bool enabled);
+
+        /**
+         * Gets whether or not {@link tearingEffect()} reports the level of
+         * the controller's TE line.
          * 
          * @return
          */
-        virtual bool rotated() = 0;
+        virtual bool hasTearingEffect();
 
         /**
-         * Queries the screen resolution and places its width and height into the
-         * given references. If {@link rotated()} returns true, then width and
-         * height must be flipped.
+         * Polls the controller's TE line, which is high while the panel is in
+         * vertical blanking. Drivers that cannot read the line return false;
+         * boards that wire it to an interrupt instead report its edges to a
+         * {@link PresentationScheduler} directly.
          * 
-         * This method may be overridden by drivers that are able to query the
-         * screen's resolution.
+         * @return
+         */
+        virtual bool tearingEffect();
+
+        /**
+         * Places the logical width and height of the screen, which are
+         * swapped if {@link rotated()} returns true, into the given references.
          * 
          * @param width
          * @param height
          */
-        virtual Driver *resolution(std::uint16_t &width, std::uint16_t &height);
+        [[gnu::always_inline]]
+        inline Driver *resolution(std::uint16_t &width, std::uint16_t &height) {
+            width = mLogicalWidth;
+            height = mLogicalHeight;
+            return this;
+        }
 
         /**
-         * Queries the screen resolution and places its width and height into the
-         * given pointers. If {@link rotated()} returns true, then width and
-         * height must be flipped.
+         * Places the logical width and height of the screen into the given
+         * pointers.
          * 
          * This method is an alias of {@link resolution(std::uint16_t, std::uint16_t)}.
          * 
@@ -352,10 +874,65 @@ namespace Kempozer::Screen {
         inline Driver(std::uint16_t width, std::uint16_t height) {
             mHeight = height;
             mWidth = width;
+            mLogicalHeight = height;
+            mLogicalWidth = width;
+            mByteOrder = KEMPOZER_SCREEN_WIRE_BYTE_ORDER;
+            mRotation = 0;
+            mHardwareRotation = true;
+        }
+
+        /**
+         * Changes the native width and height of the driver, for drivers that
+         * only learn their resolution from the screen.
+         * 
+         * @param width
+         * @param height
+         */
+        Driver *resize(std::uint16_t width, std::uint16_t height);
+
+        /**
+         * Takes on the native resolution, byte order and rotation of the
+         * screen behind a driver that this one wraps and forwards to.
+         *
+         * @param width
+         * @param height
+         * @param byteOrder
+         * @param rotation
+         * @param hardwareRotation
+         */
+        Driver *mirror(std::uint16_t width, std::uint16_t height, ByteOrder byteOrder, int rotation,
+                       bool hardwareRotation);
+
+        /**
+         * Takes on the native resolution, byte order and rotation of driver,
+         * which this one wraps and forwards to.
+         *
+         * @param driver
+         */
+        [[gnu::always_inline]]
+        inline Driver *mirror(const Driver &driver) {
+            return mirror(driver.mWidth, driver.mHeight, driver.mByteOrder, driver.mRotation,
+                          driver.mHardwareRotation);
         }
 
+        /**
+         * Maps a rotation, given in clockwise quarter turns from 0 to 3, onto
+         * the controller, typically by rewriting its memory access control
+         * (MADCTL) register. Drivers that cannot rotate return false, and
+         * drawing code applies the rotation in software instead.
+         * 
+         * @param rotation
+         * @return Whether the controller now applies the rotation.
+         */
+        virtual bool applyRotation(int rotation);
+
         std::uint16_t mHeight,
-                      mWidth;
+                      mWidth,
+                      mLogicalHeight,
+                      mLogicalWidth;
+        ByteOrder mByteOrder;
+        std::uint8_t mRotation;
+        bool mHardwareRotation;
     };
 }
 
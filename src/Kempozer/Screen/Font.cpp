@@ -0,0 +1,68 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/Font.h"
+
+namespace Kempozer::Screen {
+    std::uint16_t blend565(std::uint16_t foreground, std::uint16_t background, std::uint8_t alpha) {
+        // Blend red and blue together in one 32-bit lane, and green in another,
+        // each scaled to 5 bits of alpha so the products cannot collide.
+        std::uint32_t a = (alpha + 4) >> 3,
+                      fg = (foreground | (std::uint32_t(foreground) << 16)) & 0x07E0F81F,
+                      bg = (background | (std::uint32_t(background) << 16)) & 0x07E0F81F,
+                      mixed = ((fg * a + bg * (32 - a)) >> 5) & 0x07E0F81F;
+        return std::uint16_t(mixed | (mixed >> 16));
+    }
+
+    void rasterizeGlyph(const Font &font, const Glyph &glyph,
+                        std::uint16_t foreground, std::uint16_t background,
+                        std::uint16_t firstRow, std::uint16_t rows, std::uint16_t *out) {
+        unsigned bits = font.bitsPerPixel,
+                 levels = 1u << bits;
+        std::uint16_t shades[16];
+        for (unsigned level = 0; level < levels; ++level) {
+            shades[level] = blend565(foreground, background, std::uint8_t(level * 255 / (levels - 1)));
+        }
+
+        const std::uint8_t *bitmap = font.bitmap + glyph.offset;
+        std::uint8_t mask = std::uint8_t(levels - 1);
+        for (std::uint16_t row = firstRow; row < firstRow + rows; ++row) {
+            std::int32_t glyphRow = std::int32_t(row) - glyph.y;
+            bool inside = glyphRow >= 0 && glyphRow < glyph.height;
+            for (std::uint16_t column = 0; column < glyph.advance; ++column) {
+                std::int32_t glyphColumn = std::int32_t(column) - glyph.x;
+                std::uint16_t color = background;
+                if (inside && glyphColumn >= 0 && glyphColumn < glyph.width) {
+                    std::size_t bit = (std::size_t(glyphRow) * glyph.width + glyphColumn) * bits;
+                    color = shades[(bitmap[bit >> 3] >> (8 - bits - (bit & 7))) & mask];
+                }
+                *out++ = color;
+            }
+        }
+    }
+}
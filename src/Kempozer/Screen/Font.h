@@ -0,0 +1,112 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_Font_h__
+#define __Kempozer_Screen_Font_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A single glyph of a {@link Font}. The glyph's bitmap is a width by
+     * height block of coverage values placed at (x, y) within a cell that is
+     * advance pixels wide and {@link Font::height} pixels tall; the rest of
+     * the cell is background.
+     */
+    ks_packed_struct Glyph {
+        std::uint32_t offset;
+        std::uint8_t width;
+        std::uint8_t height;
+        std::uint8_t advance;
+        std::int8_t x;
+        std::int8_t y;
+    };
+
+    /**
+     * A precompiled bitmap font, normally stored in flash.
+     *
+     * Each glyph's bitmap starts at byte {@link Glyph::offset} of bitmap and
+     * holds width * height coverage values of bitsPerPixel bits each, packed
+     * row after row, most significant bits first, with no padding between
+     * rows. A bitsPerPixel of 1 gives a plain bitmap font, while 2 or 4 give
+     * anti-aliased fonts whose coverage blends the foreground into the
+     * background. No other depths are supported.
+     */
+    struct Font {
+        const std::uint8_t *bitmap;
+        const Glyph *glyphs;
+        std::uint16_t first;
+        std::uint16_t last;
+        std::uint8_t height;
+        std::uint8_t bitsPerPixel;
+
+        /**
+         * Gets the glyph for a character, or nullptr if the font does not
+         * have it.
+         *
+         * @param character
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Glyph *glyph(std::uint16_t character) const {
+            return character >= first && character <= last ? glyphs + (character - first) : nullptr;
+        }
+    };
+
+    /**
+     * Blends two RGB565 colors, giving foreground alpha out of 255.
+     *
+     * @param foreground
+     * @param background
+     * @param alpha
+     * @return
+     */
+    std::uint16_t blend565(std::uint16_t foreground, std::uint16_t background, std::uint8_t alpha);
+
+    /**
+     * Rasterizes rows [firstRow, firstRow + rows) of a glyph's cell into out,
+     * which receives advance pixels per row.
+     *
+     * @param font
+     * @param glyph
+     * @param foreground
+     * @param background
+     * @param firstRow
+     * @param rows
+     * @param out
+     */
+    [[gnu::nonnull]]
+    void rasterizeGlyph(const Font &font, const Glyph &glyph,
+                        std::uint16_t foreground, std::uint16_t background,
+                        std::uint16_t firstRow, std::uint16_t rows, std::uint16_t *out);
+}
+
+#endif//__Kempozer_Screen_Font_h__
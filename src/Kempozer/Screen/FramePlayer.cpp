@@ -0,0 +1,235 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/CompressedImage.h"
+#include "Kempozer/Screen/FramePlayer.h"
+#include "KempozerScreenConfig.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        std::uint32_t systemClock() {
+#if defined(ARDUINO)
+            return micros();
+#else
+            using Clock = std::chrono::steady_clock;
+            return std::uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t load16(const std::uint8_t *data) {
+            return std::uint16_t(data[0] | (data[1] << 8));
+        }
+
+        /**
+         * Gathers literals into one chunk across packets and coalesces
+         * consecutive runs of one color, so that each reaches the driver in
+         * as few calls as possible.
+         */
+        class PixelWriter {
+        public:
+            explicit PixelWriter(Driver &driver)
+                : mDriver(driver), mFilled(0), mCount(0), mColor(0) {}
+
+            [[gnu::always_inline]]
+            inline void run(std::size_t count, std::uint16_t color) {
+                flushLiterals();
+                if (mCount && color != mColor) {
+                    flushRun();
+                }
+                mColor = color;
+                mCount += count;
+            }
+
+            [[gnu::always_inline]]
+            inline void literal(std::uint16_t color) {
+                if (mCount) {
+                    flushRun();
+                }
+                mChunk[mFilled++] = color;
+                if (mFilled == KEMPOZER_SCREEN_CONVERSION_CHUNK) {
+                    flushLiterals();
+                }
+            }
+
+            [[gnu::always_inline]]
+            inline void flush() {
+                flushLiterals();
+                flushRun();
+            }
+        private:
+            [[gnu::always_inline]]
+            inline void flushLiterals() {
+                if (mFilled) {
+                    mDriver.writePixels(mFilled, mChunk);
+                    mFilled = 0;
+                }
+            }
+
+            [[gnu::always_inline]]
+            inline void flushRun() {
+                if (mCount) {
+                    mDriver.writeRepeatedPixel(mCount, mColor);
+                    mCount = 0;
+                }
+            }
+
+            Driver &mDriver;
+            std::uint16_t mChunk[KEMPOZER_SCREEN_CONVERSION_CHUNK];
+            std::size_t mFilled,
+                        mCount;
+            std::uint16_t mColor;
+        };
+    }
+
+    FramePlayer::FramePlayer(Driver &driver, FrameStream &stream, Clock clock)
+        : mDriver(driver), mStream(stream) {
+        mClock = clock ? clock : systemClock;
+        mDue = 0;
+        mLast = 0;
+        mX = 0;
+        mY = 0;
+        mPacing = false;
+        resetStatistics();
+    }
+
+    FramePlayer *FramePlayer::position(std::uint16_t x, std::uint16_t y) {
+        mX = x;
+        mY = y;
+        return this;
+    }
+
+    bool FramePlayer::next() {
+        FrameStream::Frame frame;
+        if (!mStream.next(frame)) {
+            return false;
+        }
+        std::uint32_t start = mClock();
+        if (mTiming) {
+            mStatistics.elapsed += start - mLast;
+        }
+        mTiming = true;
+        bool drawn = draw(frame);
+        mLast = mClock();
+        mStatistics.busy += mLast - start;
+        mStatistics.elapsed += mLast - start;
+        mStatistics.bytes += FrameStream::FRAME_HEADER_SIZE + frame.size;
+        if (drawn) {
+            ++mStatistics.frames;
+        }
+        return drawn;
+    }
+
+    bool FramePlayer::play() {
+        std::uint32_t period = mStream.period();
+        if (period) {
+            std::uint32_t now = mClock();
+            if (!mPacing) {
+                mDue = now;
+                mPacing = true;
+            } else if (std::int32_t(now - mDue) >= std::int32_t(period)) {
+                ++mStatistics.late;
+                mDue = now;
+            }
+            while (std::int32_t(mClock() - mDue) < 0);
+            mDue += period;
+        }
+        return next();
+    }
+
+    FramePlayer *FramePlayer::rewind() {
+        mStream.rewind();
+        mPacing = false;
+        return this;
+    }
+
+    FramePlayer *FramePlayer::resetStatistics() {
+        mStatistics = Statistics{};
+        mTiming = false;
+        return this;
+    }
+
+    float FramePlayer::framesPerSecond() const {
+        return mStatistics.elapsed ? float(mStatistics.frames) * 1e6f / float(mStatistics.elapsed) : 0.0f;
+    }
+
+    float FramePlayer::bytesPerFrame() const {
+        return mStatistics.frames ? float(mStatistics.bytes) / float(mStatistics.frames) : 0.0f;
+    }
+
+    bool FramePlayer::draw(const FrameStream::Frame &frame) {
+        const std::uint8_t *in = frame.data,
+                           *end = frame.data + frame.size;
+        PixelWriter writer(mDriver);
+        for (std::uint16_t i = 0; i < frame.rects; ++i) {
+            if (std::size_t(end - in) < FrameStream::RECT_SIZE) {
+                return false;
+            }
+            Rect rect{load16(in), load16(in + 2), load16(in + 4), load16(in + 6)};
+            in += FrameStream::RECT_SIZE;
+            if (rect.x1 > rect.x2 || rect.y1 > rect.y2 || rect.x2 >= mStream.width() || rect.y2 >= mStream.height()) {
+                return false;
+            }
+            mDriver.setAddressWindow(mX + rect.x1, mY + rect.y1, mX + rect.x2, mY + rect.y2);
+            std::size_t remaining = rect.area();
+            while (remaining) {
+                if (in >= end) {
+                    writer.flush();
+                    return false;
+                }
+                std::uint8_t control = *in++;
+                std::size_t count = (control & ~CompressedImage::RUN) + 1;
+                std::size_t bytes = control & CompressedImage::RUN ? 2 : count * 2;
+                if (count > remaining || std::size_t(end - in) < bytes) {
+                    writer.flush();
+                    return false;
+                }
+                if (control & CompressedImage::RUN) {
+                    writer.run(count, load16(in));
+                } else {
+                    for (std::size_t j = 0; j < count; ++j) {
+                        writer.literal(load16(in + j * 2));
+                    }
+                }
+                in += bytes;
+                remaining -= count;
+            }
+            writer.flush();
+            mStatistics.pixels += rect.area();
+            ++mStatistics.rects;
+        }
+        return in == end;
+    }
+}
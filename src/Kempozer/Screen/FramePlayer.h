@@ -0,0 +1,165 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __Kempozer_Screen_FramePlayer_h__
+#define __Kempozer_Screen_FramePlayer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/FrameStream.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Plays a {@link FrameStream} on a {@link Driver}, sending only what
+     * changed from one frame to the next.
+     *
+     * Each changed rectangle gets one address window. Its runs are sent with
+     * {@link Driver::writeRepeatedPixel}, consecutive runs of one color as
+     * one call, and its literals with {@link Driver::writePixels}, gathered
+     * across packets into chunks of KEMPOZER_SCREEN_CONVERSION_CHUNK pixels.
+     * Frames are decoded straight from the stream, so nothing but the chunk
+     * is held in RAM.
+     *
+     * The driver must be selected while frames are sent. {@link play()}
+     * paces the stream at its period by spinning on the clock, which reads
+     * microseconds; frames that start more than a period late count as late,
+     * and pacing restarts from them rather than rushing to catch up.
+     */
+    class FramePlayer {
+    public:
+        /**
+         * A source of microseconds, which may wrap around.
+         */
+        using Clock = std::uint32_t (*)();
+
+        /**
+         * Counters since construction or the last call to
+         * {@link resetStatistics()}. bytes counts the stream bytes of the
+         * frames played, and pixels the pixels sent for them. busy is the
+         * time spent decoding and sending, and elapsed the time from the
+         * start of the first frame to the end of the last, both in
+         * microseconds.
+         */
+        struct Statistics {
+            std::uint32_t frames;
+            std::uint32_t rects;
+            std::uint32_t late;
+            std::uint64_t bytes;
+            std::uint64_t pixels;
+            std::uint64_t busy;
+            std::uint64_t elapsed;
+        };
+
+        /**
+         * Creates a player of stream on driver. Both must outlive the player.
+         *
+         * @param driver
+         * @param stream
+         * @param clock The clock to use, or nullptr for the system's.
+         */
+        FramePlayer(Driver &driver, FrameStream &stream, Clock clock = nullptr);
+
+        /**
+         * Sets where on the screen the top-left corner of the frames goes.
+         * The frames must lie entirely on screen.
+         *
+         * @param x
+         * @param y
+         */
+        FramePlayer *position(std::uint16_t x, std::uint16_t y);
+
+        /**
+         * Sends the next frame right away.
+         *
+         * @return Whether a frame was sent; false at the end of the stream
+         *         or if the frame is malformed, in which case the pixels up
+         *         to the error have been sent.
+         */
+        bool next();
+
+        /**
+         * Waits until the next frame is due, then sends it.
+         *
+         * @return See {@link next()}.
+         */
+        bool play();
+
+        /**
+         * Goes back to the first frame, which repaints the whole picture.
+         */
+        FramePlayer *rewind();
+
+        /**
+         * Gets the statistics of this player.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Statistics &statistics() const {
+            return mStatistics;
+        }
+
+        /**
+         * Zeroes the statistics of this player.
+         */
+        FramePlayer *resetStatistics();
+
+        /**
+         * Gets the rate at which frames were played, from the statistics.
+         *
+         * @return
+         */
+        float framesPerSecond() const;
+
+        /**
+         * Gets the average stream bytes per frame played, from the
+         * statistics.
+         *
+         * @return
+         */
+        float bytesPerFrame() const;
+    private:
+        bool draw(const FrameStream::Frame &frame);
+
+        Driver &mDriver;
+        FrameStream &mStream;
+        Clock mClock;
+        Statistics mStatistics;
+        std::uint32_t mDue,
+                      mLast;
+        std::uint16_t mX,
+                      mY;
+        bool mPacing,
+             mTiming;
+    };
+}
+
+#endif//__Kempozer_Screen_FramePlayer_h__
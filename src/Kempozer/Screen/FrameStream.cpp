@@ -0,0 +1,246 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/CompressedImage.h"
+#include "Kempozer/Screen/FrameStream.h"
+#include "Kempozer/Screen/RegionSet.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        [[gnu::always_inline]]
+        inline std::uint16_t load16(const std::uint8_t *data) {
+            return std::uint16_t(data[0] | (data[1] << 8));
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint32_t load32(const std::uint8_t *data) {
+            return std::uint32_t(load16(data)) | std::uint32_t(load16(data + 2)) << 16;
+        }
+
+        [[gnu::always_inline]]
+        inline void store16(std::uint8_t *out, std::uint16_t value) {
+            out[0] = std::uint8_t(value);
+            out[1] = std::uint8_t(value >> 8);
+        }
+
+        [[gnu::always_inline]]
+        inline void store32(std::uint8_t *out, std::uint32_t value) {
+            store16(out, std::uint16_t(value));
+            store16(out + 2, std::uint16_t(value >> 16));
+        }
+
+        /**
+         * Walks the pixels of a rectangle of a frame in row-major order.
+         */
+        class RectPixels {
+        public:
+            RectPixels(const std::uint16_t *frame, std::uint16_t stride, Rect rect)
+                : mFrame(frame + std::size_t(rect.y1) * stride + rect.x1), mStride(stride), mWidth(rect.width()) {}
+
+            [[gnu::always_inline]]
+            inline std::uint16_t operator[](std::size_t index) const {
+                return mFrame[index / mWidth * mStride + index % mWidth];
+            }
+
+            /**
+             * Gets the length of the run of equal pixels starting at index,
+             * up to a packet's worth.
+             */
+            std::size_t run(std::size_t index, std::size_t count) const {
+                std::uint16_t color = (*this)[index];
+                std::size_t end = index + 1;
+                while (end < count && end - index < CompressedImage::MAX_PACKET && (*this)[end] == color) {
+                    ++end;
+                }
+                return end - index;
+            }
+        private:
+            const std::uint16_t *mFrame;
+            std::size_t mStride;
+            std::size_t mWidth;
+        };
+    }
+
+    FrameStream::FrameStream(const std::uint8_t *data, std::size_t size) {
+        mFrames = nullptr;
+        mPosition = nullptr;
+        mEnd = data + size;
+        mFrameCount = 0;
+        mPeriod = 0;
+        mIndex = 0;
+        mWidth = 0;
+        mHeight = 0;
+        if (size < HEADER_SIZE || data[0] != 'K' || data[1] != 'F' || data[2] != VERSION) {
+            return;
+        }
+        mWidth = load16(data + 4);
+        mHeight = load16(data + 6);
+        mFrameCount = load32(data + 8);
+        mPeriod = load32(data + 12);
+        mFrames = data + HEADER_SIZE;
+        mPosition = mFrames;
+    }
+
+    FrameStream *FrameStream::rewind() {
+        mPosition = mFrames;
+        mIndex = 0;
+        return this;
+    }
+
+    bool FrameStream::next(Frame &frame) {
+        if (!valid() || mIndex == mFrameCount || std::size_t(mEnd - mPosition) < FRAME_HEADER_SIZE) {
+            return false;
+        }
+        std::uint32_t size = load32(mPosition);
+        if (size < FRAME_HEADER_SIZE - 4 || std::size_t(mEnd - mPosition) - 4 < size) {
+            return false;
+        }
+        frame.rects = load16(mPosition + 4);
+        frame.data = mPosition + FRAME_HEADER_SIZE;
+        frame.size = size - (FRAME_HEADER_SIZE - 4);
+        mPosition += 4 + std::size_t(size);
+        ++mIndex;
+        return true;
+    }
+
+    std::size_t FrameStream::writeHeader(std::uint8_t *out, std::size_t capacity, std::uint16_t width,
+                                         std::uint16_t height, std::uint32_t frames, std::uint32_t period) {
+        if (capacity < HEADER_SIZE) {
+            return 0;
+        }
+        out[0] = 'K';
+        out[1] = 'F';
+        out[2] = VERSION;
+        out[3] = 0;
+        store16(out + 4, width);
+        store16(out + 6, height);
+        store32(out + 8, frames);
+        store32(out + 12, period);
+        return HEADER_SIZE;
+    }
+
+    std::size_t FrameStream::encodeFrame(const std::uint16_t *previous, const std::uint16_t *current,
+                                         std::uint16_t width, std::uint16_t height, std::size_t windowCost,
+                                         std::uint8_t *out, std::size_t capacity) {
+        if (capacity < FRAME_HEADER_SIZE) {
+            return 0;
+        }
+        RegionSet regions;
+        regions.windowCost(windowCost);
+        if (!previous) {
+            regions.add(Rect{0, 0, std::uint16_t(width - 1), std::uint16_t(height - 1)});
+        } else {
+            for (std::uint16_t y = 0; y < height; ++y) {
+                const std::uint16_t *before = previous + std::size_t(y) * width,
+                                    *after = current + std::size_t(y) * width;
+                if (!std::memcmp(before, after, std::size_t(width) * sizeof(*after))) {
+                    continue;
+                }
+                // Cut the row into spans of changes, bridging gaps of unchanged
+                // pixels that are cheaper to resend than to skip.
+                std::size_t x = 0;
+                while (x < width) {
+                    while (x < width && before[x] == after[x]) {
+                        ++x;
+                    }
+                    if (x == width) {
+                        break;
+                    }
+                    std::size_t start = x,
+                                end = x;
+                    while (++x < width) {
+                        if (before[x] != after[x]) {
+                            end = x;
+                        } else if (x - end > windowCost) {
+                            break;
+                        }
+                    }
+                    regions.add(Rect{std::uint16_t(start), y, std::uint16_t(end), y});
+                    x = end + 1;
+                }
+            }
+        }
+
+        std::size_t size = FRAME_HEADER_SIZE;
+        for (std::size_t i = 0; i < regions.count(); ++i) {
+            const Rect &rect = regions.region(i);
+            if (capacity - size < RECT_SIZE) {
+                return 0;
+            }
+            store16(out + size, rect.x1);
+            store16(out + size + 2, rect.y1);
+            store16(out + size + 4, rect.x2);
+            store16(out + size + 6, rect.y2);
+            size += RECT_SIZE;
+            std::size_t packets = encodeRect(current, width, rect, out + size, capacity - size);
+            if (!packets) {
+                return 0;
+            }
+            size += packets;
+        }
+        store32(out, std::uint32_t(size - 4));
+        store16(out + 4, std::uint16_t(regions.count()));
+        return size;
+    }
+
+    std::size_t FrameStream::encodeRect(const std::uint16_t *frame, std::uint16_t stride, Rect rect,
+                                        std::uint8_t *out, std::size_t capacity) {
+        RectPixels pixels(frame, stride, rect);
+        std::size_t count = rect.area(),
+                    size = 0,
+                    i = 0;
+        while (i < count) {
+            std::size_t run = pixels.run(i, count);
+            if (run >= 2) {
+                if (capacity - size < 3) {
+                    return 0;
+                }
+                out[size] = std::uint8_t(CompressedImage::RUN | (run - 1));
+                store16(out + size + 1, pixels[i]);
+                size += 3;
+                i += run;
+                continue;
+            }
+            std::size_t start = i;
+            while (i < count && i - start < CompressedImage::MAX_PACKET && pixels.run(i, count) < 2) {
+                ++i;
+            }
+            std::size_t literals = i - start;
+            if (capacity - size < 1 + literals * 2) {
+                return 0;
+            }
+            out[size++] = std::uint8_t(literals - 1);
+            for (std::size_t j = start; j < i; ++j) {
+                store16(out + size, pixels[j]);
+                size += 2;
+            }
+        }
+        return size;
+    }
+}
@@ -0,0 +1,217 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __Kempozer_Screen_FrameStream_h__
+#define __Kempozer_Screen_FrameStream_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A delta-encoded animation, read in place from memory such as a
+     * memory-mapped file on a host or memory-mapped flash on a device, and
+     * played by {@link FramePlayer}.
+     *
+     * All multi-byte fields are little-endian. The stream starts with a
+     * {@link HEADER_SIZE} byte header:
+     *
+     *     offset 0   'K', 'F'      magic
+     *     offset 2   version       {@link VERSION}
+     *     offset 3   0             reserved
+     *     offset 4   width         std::uint16_t
+     *     offset 6   height        std::uint16_t
+     *     offset 8   frames        std::uint32_t
+     *     offset 12  period        std::uint32_t, microseconds per frame,
+     *                              0 to play as fast as possible
+     *
+     * followed by the frames. Each frame holds the rectangles that changed
+     * since the previous one, so the first frame holds the whole picture:
+     *
+     *     std::uint32_t size       bytes in the rest of the frame
+     *     std::uint16_t rects
+     *
+     * and then, for each rectangle, its inclusive corners x1, y1, x2, y2 as
+     * std::uint16_t values followed by its pixels in row-major order, as
+     * the run and literal packets of {@link CompressedImage::Format::Rle565}.
+     */
+    class FrameStream {
+    public:
+        static constexpr std::uint8_t VERSION = 1;
+        static constexpr std::size_t HEADER_SIZE = 16;
+        static constexpr std::size_t FRAME_HEADER_SIZE = 6;
+        static constexpr std::size_t RECT_SIZE = 8;
+
+        /**
+         * One frame of a stream: rects rectangles in size bytes at data.
+         */
+        struct Frame {
+            const std::uint8_t *data;
+            std::size_t size;
+            std::uint16_t rects;
+        };
+
+        /**
+         * Wraps a stream of size bytes, which must outlive this object. Use
+         * {@link valid()} to check that the header made sense.
+         *
+         * @param data
+         * @param size
+         */
+        [[gnu::nonnull]]
+        FrameStream(const std::uint8_t *data, std::size_t size);
+
+        /**
+         * Gets whether the header of this stream is well formed.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool valid() const {
+            return mFrames != nullptr;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t width() const {
+            return mWidth;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t height() const {
+            return mHeight;
+        }
+
+        /**
+         * Gets the number of frames in the stream.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t frames() const {
+            return mFrameCount;
+        }
+
+        /**
+         * Gets the time each frame is shown for, in microseconds, or 0 if the
+         * stream is to be played as fast as possible.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t period() const {
+            return mPeriod;
+        }
+
+        /**
+         * Gets the index of the frame that {@link next(Frame &)} returns next.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t index() const {
+            return mIndex;
+        }
+
+        /**
+         * Goes back to the first frame.
+         */
+        FrameStream *rewind();
+
+        /**
+         * Reads the next frame.
+         *
+         * @param frame
+         * @return Whether there was another whole frame.
+         */
+        bool next(Frame &frame);
+
+        /**
+         * Writes a stream header into out.
+         *
+         * @param out
+         * @param capacity
+         * @param width
+         * @param height
+         * @param frames
+         * @param period
+         * @return HEADER_SIZE, or 0 if out is too small.
+         */
+        static std::size_t writeHeader(std::uint8_t *out, std::size_t capacity, std::uint16_t width,
+                                       std::uint16_t height, std::uint32_t frames, std::uint32_t period);
+
+        /**
+         * Encodes a width by height RGB565 frame into out as the rectangles
+         * that differ from previous, or as the whole frame when previous is
+         * nullptr. Changed spans of a row closer than windowCost pixels are
+         * sent together, and the spans are merged into rectangles by a
+         * {@link RegionSet} with the same window cost.
+         *
+         * @param previous
+         * @param current
+         * @param width
+         * @param height
+         * @param windowCost
+         * @param out
+         * @param capacity
+         * @return The size of the encoded frame, or 0 if out is too small.
+         */
+        [[gnu::nonnull(2)]]
+        static std::size_t encodeFrame(const std::uint16_t *previous, const std::uint16_t *current,
+                                       std::uint16_t width, std::uint16_t height, std::size_t windowCost,
+                                       std::uint8_t *out, std::size_t capacity);
+
+        /**
+         * Encodes the pixels of rect, read from a frame stride pixels wide,
+         * as run and literal packets.
+         *
+         * @param frame
+         * @param stride
+         * @param rect
+         * @param out
+         * @param capacity
+         * @return The size of the packets, or 0 if out is too small.
+         */
+        [[gnu::nonnull(1)]]
+        static std::size_t encodeRect(const std::uint16_t *frame, std::uint16_t stride, Rect rect,
+                                      std::uint8_t *out, std::size_t capacity);
+    private:
+        const std::uint8_t *mFrames;
+        const std::uint8_t *mPosition;
+        const std::uint8_t *mEnd;
+        std::uint32_t mFrameCount,
+                      mPeriod,
+                      mIndex;
+        std::uint16_t mWidth,
+                      mHeight;
+    };
+}
+
+#endif//__Kempozer_Screen_FrameStream_h__
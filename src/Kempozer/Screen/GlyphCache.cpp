@@ -0,0 +1,78 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/GlyphCache.h"
+
+namespace Kempozer::Screen {
+    GlyphCache::GlyphCache(Entry *entries, std::uint16_t *pixels, std::size_t slots, std::size_t slotPixels) {
+        mEntries = entries;
+        mPixels = pixels;
+        mSlots = slots;
+        mSlotPixels = slotPixels;
+        mHits = 0;
+        mMisses = 0;
+        clear();
+    }
+
+    const std::uint16_t *GlyphCache::lookup(const Font &font, const Glyph &glyph,
+                                            std::uint16_t foreground, std::uint16_t background) {
+        std::size_t area = std::size_t(glyph.advance) * font.height;
+        if (area > mSlotPixels || !mSlots) {
+            return nullptr;
+        }
+        std::size_t victim = 0;
+        for (std::size_t i = 0; i < mSlots; ++i) {
+            Entry &entry = mEntries[i];
+            if (entry.glyph == &glyph && entry.foreground == foreground && entry.background == background) {
+                entry.lastUsed = ++mClock;
+                ++mHits;
+                return mPixels + i * mSlotPixels;
+            }
+            if (entry.lastUsed < mEntries[victim].lastUsed) {
+                victim = i;
+            }
+        }
+        ++mMisses;
+        Entry &entry = mEntries[victim];
+        entry.glyph = &glyph;
+        entry.foreground = foreground;
+        entry.background = background;
+        entry.lastUsed = ++mClock;
+        std::uint16_t *cell = mPixels + victim * mSlotPixels;
+        rasterizeGlyph(font, glyph, foreground, background, 0, font.height, cell);
+        return cell;
+    }
+
+    GlyphCache *GlyphCache::clear() {
+        for (std::size_t i = 0; i < mSlots; ++i) {
+            mEntries[i] = Entry{nullptr, 0, 0, 0};
+        }
+        mClock = 0;
+        return this;
+    }
+}
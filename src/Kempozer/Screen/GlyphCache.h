@@ -0,0 +1,136 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_GlyphCache_h__
+#define __Kempozer_Screen_GlyphCache_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Font.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A small least-recently-used cache of glyph cells rasterized to RGB565
+     * for a given foreground and background color, so that drawing a glyph
+     * that was drawn recently is a single bulk transfer.
+     *
+     * The cache is made of a fixed number of slots of a fixed number of
+     * pixels. Glyph cells larger than a slot are never cached.
+     */
+    class GlyphCache {
+    public:
+        /**
+         * A cached glyph cell.
+         */
+        struct Entry {
+            const Glyph *glyph;
+            std::uint16_t foreground;
+            std::uint16_t background;
+            std::uint32_t lastUsed;
+        };
+
+        /**
+         * Creates a cache over slots entries and slots * slotPixels pixels of
+         * storage, both of which must outlive this cache.
+         *
+         * @param entries
+         * @param pixels
+         * @param slots
+         * @param slotPixels
+         */
+        [[gnu::nonnull]]
+        GlyphCache(Entry *entries, std::uint16_t *pixels, std::size_t slots, std::size_t slotPixels);
+
+        /**
+         * Gets the rasterized cell of a glyph, rasterizing it into the least
+         * recently used slot if it is not cached yet.
+         *
+         * @param font
+         * @param glyph
+         * @param foreground
+         * @param background
+         * @return The glyph.advance by font.height cell, or nullptr if it does
+         *         not fit in a slot.
+         */
+        const std::uint16_t *lookup(const Font &font, const Glyph &glyph,
+                                    std::uint16_t foreground, std::uint16_t background);
+
+        /**
+         * Forgets every cached glyph. This must be called if a font's glyphs
+         * are changed in place.
+         */
+        GlyphCache *clear();
+
+        /**
+         * Gets the number of lookups that found their glyph cached.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t hits() const {
+            return mHits;
+        }
+
+        /**
+         * Gets the number of lookups that had to rasterize their glyph.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t misses() const {
+            return mMisses;
+        }
+    private:
+        Entry *mEntries;
+        std::uint16_t *mPixels;
+        std::size_t mSlots,
+                    mSlotPixels;
+        std::uint32_t mClock,
+                      mHits,
+                      mMisses;
+    };
+
+    /**
+     * A {@link GlyphCache} that owns its storage.
+     *
+     * @tparam Slots
+     * @tparam SlotPixels
+     */
+    template<std::size_t Slots, std::size_t SlotPixels>
+    class StaticGlyphCache : public GlyphCache {
+    public:
+        StaticGlyphCache()
+            : GlyphCache(mEntryStorage, mPixelStorage, Slots, SlotPixels) {}
+    private:
+        Entry mEntryStorage[Slots];
+        std::uint16_t mPixelStorage[Slots * SlotPixels];
+    };
+}
+
+#endif//__Kempozer_Screen_GlyphCache_h__
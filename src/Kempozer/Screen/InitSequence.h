@@ -0,0 +1,302 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_InitSequence_h__
+#define __Kempozer_Screen_InitSequence_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "KempozerScreenConcepts.h"
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/CommandBuffer.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Reports a malformed init sequence. This function is deliberately not
+     * constexpr, so a sequence that fails a check while being built as a
+     * constexpr table does not compile.
+     *
+     * @param reason
+     */
+    inline void invalidInitSequence(const char *reason) {
+        (void) reason;
+    }
+
+    /**
+     * Gets whether or not EnumT meets the commandtype concept: an enumeration
+     * whose underlying type is an unsigned 8, 16, 32 or 64-bit integer. Used
+     * where commandtype falls back to typename before C++20.
+     *
+     * @tparam EnumT
+     * @return
+     */
+    template<typename EnumT>
+    constexpr bool isCommandType() {
+        if constexpr (std::is_enum_v<EnumT>) {
+            using UnderlyingT = std::underlying_type_t<EnumT>;
+            return std::is_same_v<std::uint8_t, UnderlyingT> || std::is_same_v<std::uint16_t, UnderlyingT>
+                || std::is_same_v<std::uint32_t, UnderlyingT> || std::is_same_v<std::uint64_t, UnderlyingT>;
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * One step of an init sequence: a command, its parameters, and
+     * optionally a delay to wait once they have been sent. Create steps with
+     * {@link initCommand} and {@link delay(std::uint16_t)}.
+     *
+     * @tparam EnumT
+     * @tparam Count
+     * @tparam Delayed
+     */
+    template<commandtype EnumT, std::size_t Count, bool Delayed = false>
+    struct InitCommand {
+        static_assert(isCommandType<EnumT>(),
+                      "commands must be enumerations with an unsigned 8, 16, 32 or 64-bit underlying type");
+        static_assert(Count <= CommandBuffer::MAX_LENGTH, "too many parameters for one command");
+
+        /**
+         * The size of this step in a table: a command record and, with
+         * parameters, a data record.
+         */
+        static constexpr std::size_t SIZE =
+            ((CommandBuffer::HEADER_SIZE + sizeof(EnumT) + CommandBuffer::ALIGNMENT - 1) & ~(CommandBuffer::ALIGNMENT - 1))
+            + (Count ? (CommandBuffer::HEADER_SIZE + Count + CommandBuffer::ALIGNMENT - 1) & ~(CommandBuffer::ALIGNMENT - 1) : 0);
+
+        EnumT command;
+        std::uint8_t parameters[Count ? Count : 1];
+        std::uint16_t milliseconds;
+
+        /**
+         * Gets this step followed by a delay.
+         *
+         * @param milliseconds
+         * @return
+         */
+        constexpr InitCommand<EnumT, Count, true> delay(std::uint16_t milliseconds) const {
+            static_assert(!Delayed, "a command is followed by at most one delay");
+            InitCommand<EnumT, Count, true> step{command, {}, milliseconds};
+            for (std::size_t i = 0; i < Count; ++i) {
+                step.parameters[i] = parameters[i];
+            }
+            return step;
+        }
+    };
+
+    /**
+     * Creates a step of an init sequence that sends command followed by its
+     * parameters, each of which must fit in a byte.
+     *
+     * @tparam EnumT
+     * @tparam ParametersT
+     * @param command
+     * @param parameters
+     * @return
+     */
+    template<commandtype EnumT, typename... ParametersT>
+    constexpr InitCommand<EnumT, sizeof...(ParametersT)> initCommand(EnumT command, ParametersT... parameters) {
+        static_assert((std::is_integral_v<ParametersT> && ...), "parameters must be integers");
+        InitCommand<EnumT, sizeof...(ParametersT)> step{command, {}, 0};
+        const long long values[] = {static_cast<long long>(parameters)..., 0};
+        for (std::size_t i = 0; i < sizeof...(ParametersT); ++i) {
+            if (values[i] < 0 || values[i] > 0xFF) {
+                invalidInitSequence("a parameter does not fit in a byte");
+            }
+            step.parameters[i] = std::uint8_t(values[i]);
+        }
+        return step;
+    }
+
+    /**
+     * A run of {@link CommandBuffer} records in an init sequence table,
+     * followed by a delay.
+     *
+     * A table is a sequence of segments, each a 4 byte header (the
+     * little-endian delay in milliseconds and length of the records) followed
+     * by the records. Command records hold the command in
+     * KEMPOZER_SCREEN_WIRE_BYTE_ORDER.
+     */
+    struct InitSegment {
+        static constexpr std::size_t HEADER_SIZE = 4;
+
+        std::uint16_t delay;
+        std::size_t length;
+        const std::uint8_t *records;
+
+        /**
+         * Decodes the segment at the start of data.
+         *
+         * @param count
+         * @param data
+         * @param segment
+         * @return The number of bytes occupied by the segment, or 0 if data
+         *         does not start with a complete segment.
+         */
+        static constexpr std::size_t decode(std::size_t count, const std::uint8_t *data, InitSegment &segment) {
+            if (count < HEADER_SIZE) {
+                return 0;
+            }
+            segment.delay = std::uint16_t(data[0] | data[1] << 8);
+            segment.length = std::size_t(data[2]) | std::size_t(data[3]) << 8;
+            segment.records = data + HEADER_SIZE;
+            return HEADER_SIZE + segment.length <= count ? HEADER_SIZE + segment.length : 0;
+        }
+    };
+
+    /**
+     * An init sequence flattened into a single table of Size bytes, ready
+     * to be played back by {@link Driver::writeSequence}. Build it with
+     * {@link initSequence} into a constexpr variable, so that the table is
+     * computed and checked at compile time and placed in read-only memory:
+     *
+     *     constexpr auto INIT = initSequence(
+     *         initCommand(Command::SWRESET).delay(150),
+     *         initCommand(Command::COLMOD, 0x55),
+     *         initCommand(Command::MADCTL, 0x48),
+     *         initCommand(Command::SLPOUT).delay(120),
+     *         initCommand(Command::DISPON));
+     *
+     * Consecutive steps without a delay share a segment, which drivers can
+     * send as a single bus transaction through
+     * {@link Driver::submit(std::size_t, const std::uint8_t *)}.
+     *
+     * @tparam Size
+     */
+    template<std::size_t Size>
+    class InitSequence {
+    public:
+        template<commandtype EnumT, std::size_t... Counts, bool... Delays>
+        constexpr explicit InitSequence(const InitCommand<EnumT, Counts, Delays> &... steps)
+            : mBytes{} {
+            std::size_t offset = 0,
+                        segment = 0;
+            bool open = false;
+            (append(steps, offset, segment, open), ...);
+            if (open) {
+                close(offset, segment, 0);
+            }
+            if (offset != Size) {
+                invalidInitSequence("the table size was miscalculated");
+            }
+        }
+
+        /**
+         * Gets the table.
+         *
+         * @return
+         */
+        constexpr const std::uint8_t *data() const {
+            return mBytes;
+        }
+
+        /**
+         * Gets the size of the table.
+         *
+         * @return
+         */
+        constexpr std::size_t size() const {
+            return Size;
+        }
+    private:
+        template<commandtype EnumT, std::size_t Count, bool Delayed>
+        constexpr void append(const InitCommand<EnumT, Count, Delayed> &step, std::size_t &offset,
+                              std::size_t &segment, bool &open) {
+            if (!open) {
+                segment = offset;
+                offset += InitSegment::HEADER_SIZE;
+                open = true;
+            }
+            std::uint64_t command = std::uint64_t(step.command);
+            std::uint8_t bytes[sizeof(EnumT)] = {};
+            for (std::size_t i = 0; i < sizeof(EnumT); ++i) {
+                bytes[KEMPOZER_SCREEN_WIRE_BYTE_ORDER == ByteOrder::BigEndian ? sizeof(EnumT) - 1 - i : i] =
+                    std::uint8_t(command >> (8 * i));
+            }
+            record(CommandBuffer::RecordType::Command, sizeof(EnumT), bytes, offset);
+            if (Count) {
+                record(CommandBuffer::RecordType::Data, Count, step.parameters, offset);
+            }
+            if (Delayed) {
+                close(offset, segment, step.milliseconds);
+                open = false;
+            }
+        }
+
+        constexpr void record(CommandBuffer::RecordType type, std::size_t length, const std::uint8_t *payload,
+                              std::size_t &offset) {
+            mBytes[offset] = std::uint8_t(type);
+            mBytes[offset + 2] = std::uint8_t(length);
+            mBytes[offset + 3] = std::uint8_t(length >> 8);
+            for (std::size_t i = 0; i < length; ++i) {
+                mBytes[offset + CommandBuffer::HEADER_SIZE + i] = payload[i];
+            }
+            offset += (CommandBuffer::HEADER_SIZE + length + CommandBuffer::ALIGNMENT - 1)
+                & ~(CommandBuffer::ALIGNMENT - 1);
+        }
+
+        constexpr void close(std::size_t offset, std::size_t segment, std::uint16_t delay) {
+            std::size_t length = offset - segment - InitSegment::HEADER_SIZE;
+            if (length > 0xFFFF) {
+                invalidInitSequence("too many commands between two delays");
+            }
+            mBytes[segment] = std::uint8_t(delay);
+            mBytes[segment + 1] = std::uint8_t(delay >> 8);
+            mBytes[segment + 2] = std::uint8_t(length);
+            mBytes[segment + 3] = std::uint8_t(length >> 8);
+        }
+
+        alignas(CommandBuffer::ALIGNMENT) std::uint8_t mBytes[Size];
+    };
+
+    /**
+     * Flattens steps into an {@link InitSequence}. Every step must use the
+     * same command type.
+     *
+     * @tparam EnumT
+     * @tparam Counts
+     * @tparam Delays
+     * @param steps
+     * @return
+     */
+    template<commandtype EnumT, std::size_t... Counts, bool... Delays>
+    constexpr auto initSequence(const InitCommand<EnumT, Counts, Delays> &... steps) {
+        static_assert(sizeof...(steps) > 0, "an init sequence needs at least one command");
+        // A segment ends at every delay, and at the end of the sequence.
+        constexpr bool DELAYS[] = {Delays...};
+        constexpr std::size_t SEGMENTS = (std::size_t(Delays) + ...) + !DELAYS[sizeof...(Delays) - 1];
+        constexpr std::size_t SIZE = (InitCommand<EnumT, Counts, Delays>::SIZE + ...)
+            + SEGMENTS * InitSegment::HEADER_SIZE;
+        return InitSequence<SIZE>(steps...);
+    }
+}
+
+#endif//__Kempozer_Screen_InitSequence_h__
@@ -0,0 +1,435 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdarg>
+#include <cstdio>
+#include "Kempozer/Screen/InstrumentedDriver.h"
+
+#if KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        constexpr const char *OPERATION_NAMES[] = {
+            "select",
+            "deselect",
+            "command",
+            "data",
+            "address-window",
+            "write-pixels",
+            "write-repeated-pixel",
+            "read-pixels",
+        };
+
+        static_assert(sizeof(OPERATION_NAMES) / sizeof(*OPERATION_NAMES) == std::size_t(Operation::Count),
+                      "every operation needs a name");
+
+#if defined(ARDUINO)
+        constexpr const char *TICK_UNIT = "us";
+#else
+        constexpr const char *TICK_UNIT = "ns";
+#endif
+
+        /**
+         * Appends formatted text to a dump, tracking the full length even once
+         * the buffer is exhausted, like snprintf does.
+         */
+        [[gnu::format(printf, 4, 5)]]
+        void append(char *buffer, std::size_t capacity, std::size_t &length, const char *format, ...) {
+            std::va_list arguments;
+            va_start(arguments, format);
+            std::size_t offset = length < capacity ? length : capacity - 1;
+            int written = std::vsnprintf(buffer + offset, capacity - offset, format, arguments);
+            va_end(arguments);
+            if (written > 0) {
+                length += std::size_t(written);
+            }
+        }
+
+        std::size_t header(char *buffer, std::size_t capacity, bool enabled) {
+            std::size_t length = 0;
+            buffer[0] = '\0';
+            append(buffer, capacity, length, "# kempozer-screen instrumentation v1 ticks=%s%s\n",
+                   TICK_UNIT, enabled ? "" : " disabled");
+            append(buffer, capacity, length, "# operation calls bytes ticks min max histogram[%u]\n",
+                   unsigned(OperationStatistics::BUCKETS));
+            return length;
+        }
+
+#if KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+        [[gnu::always_inline]]
+        inline std::uint32_t now() {
+#if defined(ARDUINO)
+            return micros();
+#else
+            using Clock = std::chrono::steady_clock;
+            return std::uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        [[gnu::always_inline]]
+        inline std::size_t bucket(std::uint32_t ticks) {
+            std::size_t index = 0;
+            for (std::uint64_t value = std::uint64_t(ticks) + 1; value > 1; value >>= 1) {
+                ++index;
+            }
+            return index < OperationStatistics::BUCKETS ? index : OperationStatistics::BUCKETS - 1;
+        }
+#endif
+    }
+
+#if KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+
+    InstrumentedDriver::InstrumentedDriver(Driver &driver)
+        : Driver(0, 0), mDriver(driver) {
+        mirror(mDriver);
+        mCommandStart = 0;
+        mCommandBytes = 0;
+        mCommandAsserted = false;
+        reset();
+    }
+
+    InstrumentedDriver *InstrumentedDriver::reset() {
+        for (OperationStatistics &statistics : mStatistics) {
+            statistics = OperationStatistics{};
+        }
+        return this;
+    }
+
+    std::size_t InstrumentedDriver::dump(char *buffer, std::size_t capacity) const {
+        if (!capacity) {
+            return 0;
+        }
+        std::size_t length = header(buffer, capacity, true);
+        for (std::size_t i = 0; i < std::size_t(Operation::Count); ++i) {
+            const OperationStatistics &statistics = mStatistics[i];
+            append(buffer, capacity, length, "%s %lu %llu %llu %lu %lu",
+                   OPERATION_NAMES[i], static_cast<unsigned long>(statistics.calls),
+                   static_cast<unsigned long long>(statistics.bytes),
+                   static_cast<unsigned long long>(statistics.ticks),
+                   static_cast<unsigned long>(statistics.minimum),
+                   static_cast<unsigned long>(statistics.maximum));
+            for (std::uint32_t count : statistics.histogram) {
+                append(buffer, capacity, length, " %lu", static_cast<unsigned long>(count));
+            }
+            append(buffer, capacity, length, "\n");
+        }
+        return length;
+    }
+
+    bool InstrumentedDriver::initialize() {
+        return mDriver.initialize();
+    }
+
+    Driver *InstrumentedDriver::select() {
+        std::uint32_t start = now();
+        mDriver.select();
+        record(Operation::Select, start, 0);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::deselect() {
+        std::uint32_t start = now();
+        mDriver.deselect();
+        record(Operation::Deselect, start, 0);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::assertCommand() {
+        mCommandAsserted = true;
+        mCommandBytes = 0;
+        mCommandStart = now();
+        mDriver.assertCommand();
+        return this;
+    }
+
+    Driver *InstrumentedDriver::deassertCommand() {
+        mDriver.deassertCommand();
+        mCommandAsserted = false;
+        record(Operation::Command, mCommandStart, mCommandBytes);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writePixel(std::uint16_t color) {
+        std::uint32_t start = now();
+        mDriver.writePixel(color);
+        record(Operation::WritePixels, start, sizeof(color));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writePixels(std::size_t count, const std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.writePixels(count, data);
+        record(Operation::WritePixels, start, count * sizeof(*data));
+        return this;
+    }
+
+    PixelFormat InstrumentedDriver::pixelFormat() {
+        return mDriver.pixelFormat();
+    }
+
+    Driver *InstrumentedDriver::writeNativePixels(std::size_t count, const std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.writeNativePixels(count, data);
+        record(Operation::WritePixels, start, pixelBytes(mDriver.pixelFormat(), count));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) {
+        std::uint32_t start = now();
+        mDriver.writeRepeatedNativePixel(count, pixel);
+        record(Operation::WriteRepeatedPixel, start, pixelBytes(mDriver.pixelFormat(), count));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writeRepeatedPixel(std::size_t count, const std::uint16_t color) {
+        std::uint32_t start = now();
+        mDriver.writeRepeatedPixel(count, color);
+        record(Operation::WriteRepeatedPixel, start, count * sizeof(color));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                                 TransferCallback callback, void *context) {
+        std::uint32_t start = now();
+        mDriver.writePixelsAsync(count, data, callback, context);
+        record(Operation::WritePixels, start, count * sizeof(*data));
+        return this;
+    }
+
+    bool InstrumentedDriver::poll() {
+        return mDriver.poll();
+    }
+
+    Driver *InstrumentedDriver::wait() {
+        mDriver.wait();
+        return this;
+    }
+
+    Driver *InstrumentedDriver::write(std::uint8_t u8) {
+        std::uint32_t start = now();
+        mDriver.write(u8);
+        record(Operation::Data, start, sizeof(u8));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::write16(std::uint16_t u16) {
+        std::uint32_t start = now();
+        mDriver.write16(u16);
+        record(Operation::Data, start, sizeof(u16));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::write32(std::uint32_t u32) {
+        std::uint32_t start = now();
+        mDriver.write32(u32);
+        record(Operation::Data, start, sizeof(u32));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::write64(std::uint64_t u64) {
+        std::uint32_t start = now();
+        mDriver.write64(u64);
+        record(Operation::Data, start, sizeof(u64));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writeArray(std::size_t count, const std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.writeArray(count, data);
+        record(Operation::Data, start, count);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::writeArray16(std::size_t count, const std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.writeArray16(count, data);
+        record(Operation::Data, start, count * sizeof(*data));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::submit(std::size_t count, const std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.submit(count, data);
+        record(Operation::Data, start, count);
+        return this;
+    }
+
+    std::uint16_t InstrumentedDriver::readPixel() {
+        std::uint32_t start = now();
+        std::uint16_t color = mDriver.readPixel();
+        record(Operation::ReadPixels, start, sizeof(color));
+        return color;
+    }
+
+    void InstrumentedDriver::readPixels(std::size_t count, std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.readPixels(count, data);
+        record(Operation::ReadPixels, start, count * sizeof(*data));
+    }
+
+    bool InstrumentedDriver::beginRead() {
+        return mDriver.beginRead();
+    }
+
+    std::uint8_t InstrumentedDriver::read() {
+        std::uint32_t start = now();
+        std::uint8_t u8 = mDriver.read();
+        record(Operation::Data, start, sizeof(u8));
+        return u8;
+    }
+
+    std::uint16_t InstrumentedDriver::read16() {
+        std::uint32_t start = now();
+        std::uint16_t u16 = mDriver.read16();
+        record(Operation::Data, start, sizeof(u16));
+        return u16;
+    }
+
+    std::uint32_t InstrumentedDriver::read32() {
+        std::uint32_t start = now();
+        std::uint32_t u32 = mDriver.read32();
+        record(Operation::Data, start, sizeof(u32));
+        return u32;
+    }
+
+    std::uint64_t InstrumentedDriver::read64() {
+        std::uint32_t start = now();
+        std::uint64_t u64 = mDriver.read64();
+        record(Operation::Data, start, sizeof(u64));
+        return u64;
+    }
+
+    void InstrumentedDriver::readArray(std::size_t count, std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.readArray(count, data);
+        record(Operation::Data, start, count);
+    }
+
+    void InstrumentedDriver::readArray16(std::size_t count, std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.readArray16(count, data);
+        record(Operation::Data, start, count * sizeof(*data));
+    }
+
+    Driver *InstrumentedDriver::addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                                              std::uint16_t &x2, std::uint16_t &y2) {
+        mDriver.addressWindow(x1, y1, x2, y2);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                                 std::uint16_t x2, std::uint16_t y2) {
+        std::uint32_t start = now();
+        mDriver.setAddressWindow(x1, y1, x2, y2);
+        record(Operation::AddressWindow, start, 4 * sizeof(x1));
+        return this;
+    }
+
+    Driver *InstrumentedDriver::scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) {
+        mDriver.scrollArea(top, height, bottom);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::scroll(std::uint16_t start) {
+        mDriver.scroll(start);
+        return this;
+    }
+
+    bool InstrumentedDriver::scrollable() {
+        return mDriver.scrollable();
+    }
+
+    Driver *InstrumentedDriver::partialArea(std::uint16_t start, std::uint16_t end) {
+        mDriver.partialArea(start, end);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::partialMode(bool enabled) {
+        mDriver.partialMode(enabled);
+        return this;
+    }
+
+    Driver *InstrumentedDriver::tearingEffectOutput(bool enabled) {
+        mDriver.tearingEffectOutput(enabled);
+        return this;
+    }
+
+    bool InstrumentedDriver::hasTearingEffect() {
+        return mDriver.hasTearingEffect();
+    }
+
+    bool InstrumentedDriver::tearingEffect() {
+        return mDriver.tearingEffect();
+    }
+
+    Driver *InstrumentedDriver::pause(std::uint16_t milliseconds) {
+        mDriver.pause(milliseconds);
+        return this;
+    }
+
+    bool InstrumentedDriver::applyRotation(int rotation) {
+        mDriver.rotate(rotation);
+        return mDriver.hardwareRotation();
+    }
+
+    void InstrumentedDriver::record(Operation operation, std::uint32_t start, std::uint64_t bytes) {
+        if (mCommandAsserted && operation == Operation::Data) {
+            // Bytes sent while the command line is asserted are part of the
+            // command, which is timed as a whole.
+            mCommandBytes += std::uint32_t(bytes);
+            return;
+        }
+        std::uint32_t ticks = now() - start;
+        OperationStatistics &statistics = mStatistics[std::size_t(operation)];
+        if (!statistics.calls || ticks < statistics.minimum) {
+            statistics.minimum = ticks;
+        }
+        if (ticks > statistics.maximum) {
+            statistics.maximum = ticks;
+        }
+        ++statistics.calls;
+        statistics.bytes += bytes;
+        statistics.ticks += ticks;
+        ++statistics.histogram[bucket(ticks)];
+    }
+
+#else
+
+    std::size_t InstrumentedDriver::dump(char *buffer, std::size_t capacity) const {
+        return capacity ? header(buffer, capacity, false) : 0;
+    }
+
+#endif//KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+}
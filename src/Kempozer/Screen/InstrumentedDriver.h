@@ -0,0 +1,282 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_InstrumentedDriver_h__
+#define __Kempozer_Screen_InstrumentedDriver_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * The operations that {@link InstrumentedDriver} keeps statistics for.
+     */
+    enum class Operation : std::uint8_t {
+        Select,
+        Deselect,
+        /**
+         * Everything sent while the command line is asserted, as done by
+         * {@link Driver::writeCommand}.
+         */
+        Command,
+        /**
+         * Raw bytes and words sent or received outside of a command, such as
+         * command parameters and command buffers.
+         */
+        Data,
+        AddressWindow,
+        WritePixels,
+        WriteRepeatedPixel,
+        ReadPixels,
+        Count,
+    };
+
+    /**
+     * The statistics of one {@link Operation}. Durations are in ticks of the
+     * instrumentation clock: microseconds on Arduino, nanoseconds elsewhere.
+     * Bucket i of the histogram counts calls that took from 2^i - 1 up to
+     * 2^(i + 1) - 2 ticks, so the buckets span every 32-bit tick count and
+     * only a call of exactly 2^32 - 1 ticks shares the last one.
+     */
+    struct OperationStatistics {
+        static constexpr std::size_t BUCKETS = 32;
+
+        std::uint32_t calls;
+        std::uint64_t bytes;
+        std::uint64_t ticks;
+        std::uint32_t minimum;
+        std::uint32_t maximum;
+        std::uint32_t histogram[BUCKETS];
+    };
+
+#if KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+
+    /**
+     * A driver that wraps another and records, for every {@link Operation},
+     * how often it was called, how many bytes it moved and how long it took.
+     *
+     * Hand {@link driver()} to drawing code rather than the wrapped driver.
+     * When KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION is 0, this class keeps the
+     * same interface but driver() returns the wrapped driver itself, so the
+     * instrumentation costs nothing.
+     *
+     * Asynchronous completions are reported to their callback with the
+     * wrapped driver, and byte order changes must be made on the wrapped
+     * driver.
+     */
+    class InstrumentedDriver : public Driver {
+    public:
+        /**
+         * Wraps driver, which must outlive this one.
+         *
+         * @param driver
+         */
+        explicit InstrumentedDriver(Driver &driver);
+
+        /**
+         * Gets the driver that drawing code should use.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline Driver &driver() {
+            return *this;
+        }
+
+        /**
+         * Gets the statistics of an operation.
+         *
+         * @param operation
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const OperationStatistics &statistics(Operation operation) const {
+            return mStatistics[std::size_t(operation)];
+        }
+
+        /**
+         * Zeroes every statistic.
+         */
+        InstrumentedDriver *reset();
+
+        /**
+         * Writes the statistics as text into buffer, one line per operation
+         * in a fixed order, so that dumps from two builds can be diffed.
+         * Output is truncated to capacity - 1 characters and always
+         * terminated.
+         *
+         * @param buffer
+         * @param capacity
+         * @return The length of the full dump, excluding the terminator.
+         */
+        [[gnu::nonnull]]
+        std::size_t dump(char *buffer, std::size_t capacity) const;
+
+        bool initialize() override;
+
+        Driver *select() override;
+
+        Driver *deselect() override;
+
+        Driver *assertCommand() override;
+
+        Driver *deassertCommand() override;
+
+        Driver *writePixel(std::uint16_t color) override;
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override;
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override;
+
+        PixelFormat pixelFormat() override;
+
+        Driver *writeNativePixels(std::size_t count, const std::uint8_t *data) override;
+
+        Driver *writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) override;
+
+        [[gnu::nonnull(3)]]
+        Driver *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                 TransferCallback callback = nullptr, void *context = nullptr) override;
+
+        bool poll() override;
+
+        Driver *wait() override;
+
+        Driver *write(std::uint8_t u8) override;
+
+        Driver *write16(std::uint16_t u16) override;
+
+        Driver *write32(std::uint32_t u32) override;
+
+        Driver *write64(std::uint64_t u64) override;
+
+        Driver *writeArray(std::size_t count, const std::uint8_t *data) override;
+
+        Driver *writeArray16(std::size_t count, const std::uint16_t *data) override;
+
+        Driver *submit(std::size_t count, const std::uint8_t *data) override;
+
+        std::uint16_t readPixel() override;
+
+        void readPixels(std::size_t count, std::uint16_t *data) override;
+
+        bool beginRead() override;
+
+        std::uint8_t read() override;
+
+        std::uint16_t read16() override;
+
+        std::uint32_t read32() override;
+
+        std::uint64_t read64() override;
+
+        void readArray(std::size_t count, std::uint8_t *data) override;
+
+        void readArray16(std::size_t count, std::uint16_t *data) override;
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override;
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override;
+
+        Driver *scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) override;
+
+        Driver *scroll(std::uint16_t start) override;
+
+        bool scrollable() override;
+
+        Driver *partialArea(std::uint16_t start, std::uint16_t end) override;
+
+        Driver *partialMode(bool enabled) override;
+
+        Driver *tearingEffectOutput(bool enabled) override;
+
+        bool hasTearingEffect() override;
+
+        bool tearingEffect() override;
+
+        Driver *pause(std::uint16_t milliseconds) override;
+
+        using Driver::writePixels;
+        using Driver::writeArray;
+        using Driver::readPixels;
+        using Driver::readArray;
+        using Driver::addressWindow;
+    protected:
+        bool applyRotation(int rotation) override;
+    private:
+        void record(Operation operation, std::uint32_t start, std::uint64_t bytes);
+
+        Driver &mDriver;
+        OperationStatistics mStatistics[std::size_t(Operation::Count)];
+        std::uint32_t mCommandStart;
+        std::uint32_t mCommandBytes;
+        bool mCommandAsserted;
+    };
+
+#else
+
+    /**
+     * The disabled form of the instrumentation layer: {@link driver()} is the
+     * wrapped driver itself, and every statistic stays zero.
+     */
+    class InstrumentedDriver {
+    public:
+        explicit InstrumentedDriver(Driver &driver)
+            : mDriver(driver) {}
+
+        [[gnu::always_inline]]
+        inline Driver &driver() {
+            return mDriver;
+        }
+
+        [[gnu::always_inline]]
+        inline const OperationStatistics &statistics(Operation) const {
+            static const OperationStatistics NONE{};
+            return NONE;
+        }
+
+        [[gnu::always_inline]]
+        inline InstrumentedDriver *reset() {
+            return this;
+        }
+
+        [[gnu::nonnull]]
+        std::size_t dump(char *buffer, std::size_t capacity) const;
+    private:
+        Driver &mDriver;
+    };
+
+#endif//KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+}
+
+#endif//__Kempozer_Screen_InstrumentedDriver_h__
@@ -0,0 +1,454 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/MemoryDriver.h"
+
+namespace Kempozer::Screen {
+    MemoryDriver::MemoryDriver(std::uint16_t width, std::uint16_t height, std::uint16_t *gram)
+        : Driver(width, height) {
+        mGram = gram;
+        mByteOrder = ByteOrder::BigEndian;
+        mSelected = false;
+        reset();
+        resetCounters();
+    }
+
+    bool MemoryDriver::initialize() {
+        ++mCounters.virtualCalls;
+        reset();
+        if (mRotation) {
+            applyRotation(mRotation);
+        }
+        return true;
+    }
+
+    Driver *MemoryDriver::select() {
+        ++mCounters.virtualCalls;
+        if (!mSelected) {
+            ++mCounters.transactions;
+            mSelected = true;
+        }
+        return this;
+    }
+
+    Driver *MemoryDriver::deselect() {
+        ++mCounters.virtualCalls;
+        mSelected = false;
+        return this;
+    }
+
+    Driver *MemoryDriver::assertCommand() {
+        ++mCounters.virtualCalls;
+        mCommandAsserted = true;
+        return this;
+    }
+
+    Driver *MemoryDriver::deassertCommand() {
+        ++mCounters.virtualCalls;
+        mCommandAsserted = false;
+        return this;
+    }
+
+    Driver *MemoryDriver::writePixel(std::uint16_t color) {
+        ++mCounters.virtualCalls;
+        if (mMode != Mode::Write) {
+            writeCommand(Command::RAMWR);
+        }
+        if (mFormat != PixelFormat::Rgb565) {
+            std::uint32_t pixel = rgb565ToNative(mFormat, color);
+            for (std::size_t byte = pixelBytes(mFormat, 1); byte-- > 0;) {
+                write(std::uint8_t(pixel >> (8 * byte)));
+            }
+            return this;
+        }
+        write(std::uint8_t(color >> 8));
+        return write(std::uint8_t(color));
+    }
+
+    PixelFormat MemoryDriver::pixelFormat() {
+        ++mCounters.virtualCalls;
+        return mFormat;
+    }
+
+    Driver *MemoryDriver::writeNativePixels(std::size_t count, const std::uint8_t *data) {
+        ++mCounters.virtualCalls;
+        if (mMode != Mode::Write) {
+            writeCommand(Command::RAMWR);
+        }
+        return writeArray(pixelBytes(mFormat, count), data);
+    }
+
+    Driver *MemoryDriver::writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) {
+        ++mCounters.virtualCalls;
+        if (mMode != Mode::Write) {
+            writeCommand(Command::RAMWR);
+        }
+        std::size_t bytes = pixelBytes(mFormat, 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            for (std::size_t byte = bytes; byte-- > 0;) {
+                write(std::uint8_t(pixel >> (8 * byte)));
+            }
+        }
+        return this;
+    }
+
+    Driver *MemoryDriver::write(std::uint8_t u8) {
+        ++mCounters.virtualCalls;
+        ++mCounters.bytesWritten;
+        if (mCommandAsserted) {
+            ++mCounters.commands;
+            beginCommand(u8);
+        } else {
+            parameter(u8);
+        }
+        return this;
+    }
+
+    std::uint16_t MemoryDriver::readPixel() {
+        ++mCounters.virtualCalls;
+        if (mMode != Mode::Read) {
+            writeCommand(Command::RAMRD);
+            read();
+        }
+        std::uint16_t high = read();
+        return (high << 8) | read();
+    }
+
+    std::uint8_t MemoryDriver::read() {
+        ++mCounters.virtualCalls;
+        ++mCounters.bytesRead;
+        if (mMode != Mode::Read) {
+            return 0;
+        }
+        if (mReadDummy) {
+            mReadDummy = false;
+            return 0;
+        }
+        if (mPixelByte == 0) {
+            std::uint16_t *pixel = cell();
+            mPixel = pixel ? *pixel : 0;
+            mPixelByte = 1;
+            return std::uint8_t(mPixel >> 8);
+        }
+        mPixelByte = 0;
+        ++mCounters.pixelsRead;
+        advance();
+        return std::uint8_t(mPixel);
+    }
+
+    bool MemoryDriver::beginRead() {
+        ++mCounters.virtualCalls;
+        writeCommand(Command::RAMRD);
+        read();
+        return true;
+    }
+
+    Driver *MemoryDriver::addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                                        std::uint16_t &x2, std::uint16_t &y2) {
+        ++mCounters.virtualCalls;
+        x1 = mX1;
+        y1 = mY1;
+        x2 = mX2;
+        y2 = mY2;
+        return this;
+    }
+
+    Driver *MemoryDriver::setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                           std::uint16_t x2, std::uint16_t y2) {
+        ++mCounters.virtualCalls;
+        writeCommand(Command::CASET);
+        write(std::uint8_t(x1 >> 8));
+        write(std::uint8_t(x1));
+        write(std::uint8_t(x2 >> 8));
+        write(std::uint8_t(x2));
+        writeCommand(Command::PASET);
+        write(std::uint8_t(y1 >> 8));
+        write(std::uint8_t(y1));
+        write(std::uint8_t(y2 >> 8));
+        write(std::uint8_t(y2));
+        return writeCommand(Command::RAMWR);
+    }
+
+    bool MemoryDriver::applyRotation(int rotation) {
+        static constexpr std::uint8_t MADCTL_ROTATIONS[] = {
+            0,
+            MADCTL_MV | MADCTL_MY,
+            MADCTL_MX | MADCTL_MY,
+            MADCTL_MV | MADCTL_MX,
+        };
+        ++mCounters.virtualCalls;
+        writeCommand(Command::MADCTL);
+        write(MADCTL_ROTATIONS[rotation & 3] | (mMemoryAccess & MADCTL_BGR));
+        return true;
+    }
+
+    Driver *MemoryDriver::scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) {
+        ++mCounters.virtualCalls;
+        writeCommand(Command::VSCRDEF);
+        write(std::uint8_t(top >> 8));
+        write(std::uint8_t(top));
+        write(std::uint8_t(height >> 8));
+        write(std::uint8_t(height));
+        write(std::uint8_t(bottom >> 8));
+        return write(std::uint8_t(bottom));
+    }
+
+    Driver *MemoryDriver::scroll(std::uint16_t start) {
+        ++mCounters.virtualCalls;
+        writeCommand(Command::VSCRSADD);
+        write(std::uint8_t(start >> 8));
+        return write(std::uint8_t(start));
+    }
+
+    bool MemoryDriver::scrollable() {
+        ++mCounters.virtualCalls;
+        return true;
+    }
+
+    Driver *MemoryDriver::partialArea(std::uint16_t start, std::uint16_t end) {
+        ++mCounters.virtualCalls;
+        writeCommand(Command::PTLAR);
+        write(std::uint8_t(start >> 8));
+        write(std::uint8_t(start));
+        write(std::uint8_t(end >> 8));
+        return write(std::uint8_t(end));
+    }
+
+    Driver *MemoryDriver::partialMode(bool enabled) {
+        ++mCounters.virtualCalls;
+        return writeCommand(enabled ? Command::PTLON : Command::NORON);
+    }
+
+    Driver *MemoryDriver::tearingEffectOutput(bool enabled) {
+        ++mCounters.virtualCalls;
+        if (!enabled) {
+            return writeCommand(Command::TEOFF);
+        }
+        // The mode parameter selects V-blank only (0) or V- and H-blank (1).
+        writeCommand(Command::TEON);
+        return write(std::uint8_t(0));
+    }
+
+    Driver *MemoryDriver::pause(std::uint16_t) {
+        ++mCounters.virtualCalls;
+        return this;
+    }
+
+    std::uint16_t MemoryDriver::displayedRow(std::uint16_t line) const {
+        std::uint16_t bottom = mScrollTop + mScrollHeight;
+        if (line < mScrollTop || line >= bottom || mScrollStart < mScrollTop || mScrollStart >= bottom) {
+            return line;
+        }
+        std::uint32_t row = std::uint32_t(line - mScrollTop) + (mScrollStart - mScrollTop);
+        return std::uint16_t(mScrollTop + row % mScrollHeight);
+    }
+
+    void MemoryDriver::resetCounters() {
+        mCounters = Counters{};
+    }
+
+    void MemoryDriver::reset() {
+        mX1 = 0;
+        mY1 = 0;
+        mX2 = mWidth - 1;
+        mY2 = mHeight - 1;
+        mColumn = 0;
+        mRow = 0;
+        mPixel = 0;
+        mParameterCount = 0;
+        mCommand = std::uint8_t(Command::NOP);
+        mMemoryAccess = 0;
+        mScrollTop = 0;
+        mScrollHeight = mHeight;
+        mScrollStart = 0;
+        mPartialStart = 0;
+        mPartialEnd = mHeight - 1;
+        mPartial = false;
+        mTearingEffect = false;
+        mPixelByte = 0;
+        mNativePixel = 0;
+        mFormat = PixelFormat::Rgb565;
+        mMode = Mode::Idle;
+        mReadDummy = false;
+        mCommandAsserted = false;
+    }
+
+    void MemoryDriver::beginCommand(std::uint8_t command) {
+        mCommand = command;
+        mParameterCount = 0;
+        mPixelByte = 0;
+        switch (Command(command)) {
+            case Command::SWRESET:
+                reset();
+                break;
+            case Command::RAMWR:
+                mMode = Mode::Write;
+                mColumn = mX1;
+                mRow = mY1;
+                break;
+            case Command::RAMRD:
+                mMode = Mode::Read;
+                mReadDummy = true;
+                mColumn = mX1;
+                mRow = mY1;
+                break;
+            case Command::PTLON:
+                mMode = Mode::Idle;
+                mPartial = true;
+                break;
+            case Command::NORON:
+                mMode = Mode::Idle;
+                mPartial = false;
+                break;
+            case Command::TEOFF:
+                mMode = Mode::Idle;
+                mTearingEffect = false;
+                break;
+            case Command::TEON:
+                mMode = Mode::Idle;
+                mTearingEffect = true;
+                break;
+            default:
+                mMode = Mode::Idle;
+                break;
+        }
+    }
+
+    void MemoryDriver::parameter(std::uint8_t u8) {
+        switch (Command(mCommand)) {
+            case Command::CASET:
+            case Command::PASET:
+                if (mParameterCount < 4) {
+                    mParameters[mParameterCount++] = u8;
+                    if (mParameterCount == 4) {
+                        std::uint16_t start = (std::uint16_t(mParameters[0]) << 8) | mParameters[1],
+                                      end = (std::uint16_t(mParameters[2]) << 8) | mParameters[3];
+                        if (Command(mCommand) == Command::CASET) {
+                            mX1 = start;
+                            mX2 = end;
+                        } else {
+                            mY1 = start;
+                            mY2 = end;
+                        }
+                    }
+                }
+                break;
+            case Command::PTLAR:
+                if (mParameterCount < 4) {
+                    mParameters[mParameterCount++] = u8;
+                    if (mParameterCount == 4) {
+                        mPartialStart = (std::uint16_t(mParameters[0]) << 8) | mParameters[1];
+                        mPartialEnd = (std::uint16_t(mParameters[2]) << 8) | mParameters[3];
+                    }
+                }
+                break;
+            case Command::VSCRDEF:
+                if (mParameterCount < 6) {
+                    mParameters[mParameterCount++] = u8;
+                    if (mParameterCount == 6) {
+                        mScrollTop = (std::uint16_t(mParameters[0]) << 8) | mParameters[1];
+                        mScrollHeight = (std::uint16_t(mParameters[2]) << 8) | mParameters[3];
+                    }
+                }
+                break;
+            case Command::VSCRSADD:
+                if (mParameterCount < 2) {
+                    mParameters[mParameterCount++] = u8;
+                    if (mParameterCount == 2) {
+                        mScrollStart = (std::uint16_t(mParameters[0]) << 8) | mParameters[1];
+                    }
+                }
+                break;
+            case Command::MADCTL:
+                if (mParameterCount++ == 0) {
+                    mMemoryAccess = u8;
+                }
+                break;
+            case Command::COLMOD:
+                if (mParameterCount++ == 0) {
+                    // The low bits select the format of the MCU interface.
+                    switch (u8 & 0x07) {
+                        case 0x02:
+                            mFormat = PixelFormat::Rgb332;
+                            break;
+                        case 0x05:
+                            mFormat = PixelFormat::Rgb565;
+                            break;
+                        case 0x06:
+                            mFormat = PixelFormat::Rgb666;
+                            break;
+                        case 0x07:
+                            mFormat = PixelFormat::Rgb888;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                break;
+            case Command::RAMWR:
+                mNativePixel = mNativePixel << 8 | u8;
+                if (++mPixelByte == pixelBytes(mFormat, 1)) {
+                    std::uint16_t *pixel = cell();
+                    if (pixel) {
+                        *pixel = nativeToRgb565(mFormat, mNativePixel);
+                    }
+                    mNativePixel = 0;
+                    mPixelByte = 0;
+                    ++mCounters.pixelsWritten;
+                    advance();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void MemoryDriver::advance() {
+        if (mColumn < mX2) {
+            ++mColumn;
+        } else {
+            mColumn = mX1;
+            mRow = mRow < mY2 ? mRow + 1 : mY1;
+        }
+    }
+
+    std::uint16_t *MemoryDriver::cell() const {
+        bool swapped = mMemoryAccess & MADCTL_MV;
+        std::uint16_t width = swapped ? mHeight : mWidth,
+                      height = swapped ? mWidth : mHeight;
+        if (mColumn >= width || mRow >= height) {
+            return nullptr;
+        }
+        std::uint16_t column = (mMemoryAccess & MADCTL_MX) ? width - 1 - mColumn : mColumn,
+                      row = (mMemoryAccess & MADCTL_MY) ? height - 1 - mRow : mRow;
+        if (swapped) {
+            return mGram + std::size_t(column) * mWidth + row;
+        }
+        return mGram + std::size_t(row) * mWidth + column;
+    }
+}
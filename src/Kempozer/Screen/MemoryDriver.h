@@ -0,0 +1,291 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __Kempozer_Screen_MemoryDriver_h__
+#define __Kempozer_Screen_MemoryDriver_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A driver that emulates a MIPI-DCS style display controller in RAM.
+     *
+     * Every byte handed to {@link write(std::uint8_t)} is decoded exactly as a
+     * controller would decode it off the bus: command bytes are recognized
+     * while the command line is asserted, and the parameter bytes that follow
+     * CASET, PASET, MADCTL, RAMWR and RAMRD update the address window, the
+     * memory access control register, and the graphics RAM. VSCRDEF,
+     * VSCRSADD, PTLAR, PTLON and NORON are tracked so that
+     * {@link displayedRow(std::uint16_t)} can report what the panel would
+     * show, and TEON and TEOFF so that {@link tearingEffectEnabled()} can
+     * report whether the TE line would be driven. Pixels are
+     * transferred high byte first, as RGB565 controllers expect on the wire,
+     * so the driver's {@link byteOrder()} is big-endian. COLMOD selects 8,
+     * 16, 18 or 24-bit pixels, which {@link pixelFormat()} reports; pixels
+     * are stored in the graphics RAM, and read back, as RGB565.
+     *
+     * Since nothing is overridden beyond what a minimal driver must provide,
+     * the counters collected by this driver show exactly what the default
+     * {@link Driver} implementations cost, which makes it suitable as the
+     * engine of a host-side throughput benchmark.
+     */
+    class MemoryDriver : public Driver {
+    public:
+        /**
+         * The subset of MIPI-DCS commands understood by this driver.
+         */
+        enum class Command : std::uint8_t {
+            NOP = 0x00,
+            SWRESET = 0x01,
+            SLPOUT = 0x11,
+            PTLON = 0x12,
+            NORON = 0x13,
+            DISPOFF = 0x28,
+            DISPON = 0x29,
+            CASET = 0x2A,
+            PASET = 0x2B,
+            RAMWR = 0x2C,
+            RAMRD = 0x2E,
+            PTLAR = 0x30,
+            VSCRDEF = 0x33,
+            TEOFF = 0x34,
+            TEON = 0x35,
+            MADCTL = 0x36,
+            VSCRSADD = 0x37,
+            COLMOD = 0x3A,
+        };
+
+        /**
+         * The bits of the memory access control register.
+         */
+        enum MemoryAccess : std::uint8_t {
+            MADCTL_MY = 0x80,
+            MADCTL_MX = 0x40,
+            MADCTL_MV = 0x20,
+            MADCTL_ML = 0x10,
+            MADCTL_BGR = 0x08,
+        };
+
+        /**
+         * The traffic observed by this driver since construction or the last
+         * call to {@link resetCounters()}.
+         */
+        struct Counters {
+            std::uint64_t virtualCalls;
+            std::uint64_t bytesWritten;
+            std::uint64_t bytesRead;
+            std::uint64_t commands;
+            std::uint64_t transactions;
+            std::uint64_t pixelsWritten;
+            std::uint64_t pixelsRead;
+        };
+
+        /**
+         * Creates a driver backed by the given graphics RAM, which must hold
+         * at least width * height pixels.
+         *
+         * @param width
+         * @param height
+         * @param gram
+         */
+        [[gnu::nonnull]]
+        MemoryDriver(std::uint16_t width, std::uint16_t height, std::uint16_t *gram);
+
+        bool initialize() override;
+
+        Driver *select() override;
+
+        Driver *deselect() override;
+
+        Driver *assertCommand() override;
+
+        Driver *deassertCommand() override;
+
+        Driver *writePixel(std::uint16_t color) override;
+
+        PixelFormat pixelFormat() override;
+
+        Driver *writeNativePixels(std::size_t count, const std::uint8_t *data) override;
+
+        Driver *writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) override;
+
+        Driver *write(std::uint8_t u8) override;
+
+        std::uint16_t readPixel() override;
+
+        std::uint8_t read() override;
+
+        /**
+         * Sends RAMRD and discards the dummy read that follows it.
+         *
+         * @return
+         */
+        bool beginRead() override;
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override;
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override;
+
+        Driver *scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) override;
+
+        Driver *scroll(std::uint16_t start) override;
+
+        bool scrollable() override;
+
+        Driver *partialArea(std::uint16_t start, std::uint16_t end) override;
+
+        Driver *partialMode(bool enabled) override;
+
+        Driver *tearingEffectOutput(bool enabled) override;
+
+        /**
+         * Returns immediately, since the emulated controller needs no time to
+         * settle.
+         *
+         * @param milliseconds
+         */
+        Driver *pause(std::uint16_t milliseconds) override;
+
+        /**
+         * Gets the graphics RAM row that the panel shows at the given native
+         * display line, taking the vertical scrolling area and start address
+         * into account.
+         *
+         * @param line
+         * @return
+         */
+        std::uint16_t displayedRow(std::uint16_t line) const;
+
+        /**
+         * Gets whether or not the panel is in partial display mode.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool partial() const {
+            return mPartial;
+        }
+
+        /**
+         * Gets whether or not the tearing effect output has been turned on.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool tearingEffectEnabled() const {
+            return mTearingEffect;
+        }
+
+        /**
+         * Gets the graphics RAM backing this driver, in native (unrotated)
+         * row-major order.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t *gram() {
+            return mGram;
+        }
+
+        /**
+         * Gets the current value of the memory access control register.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint8_t memoryAccess() const {
+            return mMemoryAccess;
+        }
+
+        /**
+         * Gets the traffic counters of this driver.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Counters &counters() const {
+            return mCounters;
+        }
+
+        /**
+         * Zeroes the traffic counters of this driver.
+         */
+        void resetCounters();
+    protected:
+        /**
+         * Rotates the picture by writing MADCTL, keeping its BGR bit.
+         *
+         * @param rotation
+         * @return
+         */
+        bool applyRotation(int rotation) override;
+    private:
+        enum class Mode : std::uint8_t {
+            Idle,
+            Write,
+            Read,
+        };
+
+        void reset();
+
+        void beginCommand(std::uint8_t command);
+
+        void parameter(std::uint8_t u8);
+
+        void advance();
+
+        std::uint16_t *cell() const;
+
+        std::uint16_t *mGram;
+        Counters mCounters;
+        std::uint32_t mNativePixel;
+        std::uint16_t mX1, mY1, mX2, mY2;
+        std::uint16_t mColumn, mRow;
+        std::uint16_t mPixel;
+        std::uint16_t mScrollTop, mScrollHeight, mScrollStart;
+        std::uint16_t mPartialStart, mPartialEnd;
+        std::uint8_t mParameters[6];
+        std::uint8_t mParameterCount;
+        std::uint8_t mCommand;
+        std::uint8_t mMemoryAccess;
+        std::uint8_t mPixelByte;
+        PixelFormat mFormat;
+        Mode mMode;
+        bool mReadDummy;
+        bool mCommandAsserted;
+        bool mSelected;
+        bool mPartial;
+        bool mTearingEffect;
+    };
+}
+
+#endif//__Kempozer_Screen_MemoryDriver_h__
@@ -0,0 +1,71 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/PixelDoubleBuffer.h"
+
+namespace Kempozer::Screen {
+    PixelDoubleBuffer::PixelDoubleBuffer(Driver &driver, std::uint16_t *first, std::uint16_t *second,
+                                         std::size_t capacity)
+        : mDriver(driver) {
+        mBuffers[0] = first;
+        mBuffers[1] = second;
+        mBusy[0] = false;
+        mBusy[1] = false;
+        mCapacity = capacity;
+        mIndex = 0;
+    }
+
+    std::uint16_t *PixelDoubleBuffer::acquire() {
+        while (mBusy[mIndex]) {
+            mDriver.poll();
+        }
+        return mBuffers[mIndex];
+    }
+
+    PixelDoubleBuffer *PixelDoubleBuffer::submit(std::size_t count) {
+        if (count > mCapacity) {
+            count = mCapacity;
+        }
+        // Mark the buffer busy before starting, since synchronous drivers call
+        // back before writePixelsAsync returns.
+        mBusy[mIndex] = true;
+        mDriver.writePixelsAsync(count, mBuffers[mIndex], completed,
+                                 const_cast<bool *>(&mBusy[mIndex]));
+        mIndex ^= 1;
+        return this;
+    }
+
+    PixelDoubleBuffer *PixelDoubleBuffer::finish() {
+        mDriver.wait();
+        return this;
+    }
+
+    void PixelDoubleBuffer::completed(Driver *, void *context) {
+        *static_cast<volatile bool *>(context) = false;
+    }
+}
@@ -0,0 +1,112 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_PixelDoubleBuffer_h__
+#define __Kempozer_Screen_PixelDoubleBuffer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A ping-pong pair of pixel buffers for overlapping rendering with
+     * transfers. While one buffer is being sent by
+     * {@link Driver::writePixelsAsync}, the other is handed out by
+     * {@link acquire()} to be rendered into:
+     *
+     *     std::uint16_t *strip = buffer.acquire();
+     *     render(strip);
+     *     buffer.submit(count);
+     *
+     * With drivers that complete transfers synchronously this degrades to
+     * plain rendering followed by {@link Driver::writePixels}.
+     */
+    class PixelDoubleBuffer {
+    public:
+        /**
+         * Creates a double buffer over two buffers of capacity pixels each.
+         * The driver and both buffers must outlive this double buffer.
+         *
+         * @param driver
+         * @param first
+         * @param second
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        PixelDoubleBuffer(Driver &driver, std::uint16_t *first, std::uint16_t *second,
+                          std::size_t capacity);
+
+        PixelDoubleBuffer(const PixelDoubleBuffer &) = delete;
+
+        PixelDoubleBuffer &operator=(const PixelDoubleBuffer &) = delete;
+
+        /**
+         * Gets the buffer to render the next strip into, waiting for its
+         * previous transfer to complete if necessary.
+         *
+         * @return
+         */
+        std::uint16_t *acquire();
+
+        /**
+         * Starts sending the first count pixels of the buffer returned by the
+         * last call to {@link acquire()}, and flips to the other buffer.
+         * count is clamped to {@link capacity()}.
+         *
+         * @param count
+         */
+        PixelDoubleBuffer *submit(std::size_t count);
+
+        /**
+         * Waits for both buffers to finish transferring.
+         */
+        PixelDoubleBuffer *finish();
+
+        /**
+         * Gets the number of pixels each buffer holds.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t capacity() const {
+            return mCapacity;
+        }
+    private:
+        static void completed(Driver *driver, void *context);
+
+        Driver &mDriver;
+        std::uint16_t *mBuffers[2];
+        volatile bool mBusy[2];
+        std::size_t mCapacity;
+        std::uint8_t mIndex;
+    };
+}
+
+#endif//__Kempozer_Screen_PixelDoubleBuffer_h__
@@ -0,0 +1,90 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/PixelFormat.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        template<PixelFormat Format>
+        void convert(std::size_t count, const std::uint8_t *data, std::uint16_t *out) {
+            using Traits = PixelTraits<Format>;
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = Traits::toRgb565(Traits::load(data, i));
+            }
+        }
+    }
+
+    std::uint32_t rgb565ToNative(PixelFormat format, std::uint16_t color) {
+        switch (format) {
+            case PixelFormat::Mono1:
+                return PixelTraits<PixelFormat::Mono1>::native(PixelTraits<PixelFormat::Mono1>::fromRgb565(color));
+            case PixelFormat::Rgb332:
+                return PixelTraits<PixelFormat::Rgb332>::native(PixelTraits<PixelFormat::Rgb332>::fromRgb565(color));
+            case PixelFormat::Rgb666:
+                return PixelTraits<PixelFormat::Rgb666>::native(PixelTraits<PixelFormat::Rgb666>::fromRgb565(color));
+            case PixelFormat::Rgb888:
+                return PixelTraits<PixelFormat::Rgb888>::native(PixelTraits<PixelFormat::Rgb888>::fromRgb565(color));
+            case PixelFormat::Rgb565:
+                break;
+        }
+        return color;
+    }
+
+    std::uint16_t nativeToRgb565(PixelFormat format, std::uint32_t pixel) {
+        switch (format) {
+            case PixelFormat::Mono1:
+                return PixelTraits<PixelFormat::Mono1>::toRgb565(pixel & 1);
+            case PixelFormat::Rgb332:
+                return PixelTraits<PixelFormat::Rgb332>::toRgb565(std::uint8_t(pixel));
+            case PixelFormat::Rgb666:
+            case PixelFormat::Rgb888:
+                return rgb565(std::uint8_t(pixel >> 16), std::uint8_t(pixel >> 8), std::uint8_t(pixel));
+            case PixelFormat::Rgb565:
+                break;
+        }
+        return std::uint16_t(pixel);
+    }
+
+    void nativeToRgb565(PixelFormat format, std::size_t count, const std::uint8_t *data, std::uint16_t *out) {
+        switch (format) {
+            case PixelFormat::Mono1:
+                convert<PixelFormat::Mono1>(count, data, out);
+                break;
+            case PixelFormat::Rgb332:
+                convert<PixelFormat::Rgb332>(count, data, out);
+                break;
+            case PixelFormat::Rgb565:
+                convert<PixelFormat::Rgb565>(count, data, out);
+                break;
+            case PixelFormat::Rgb666:
+            case PixelFormat::Rgb888:
+                rgb888ToRgb565(count, data, out);
+                break;
+        }
+    }
+}
@@ -0,0 +1,306 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_PixelFormat_h__
+#define __Kempozer_Screen_PixelFormat_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/ColorConversion.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * The formats that pixels can take on the wire. Each is described by a
+     * {@link PixelTraits} specialization.
+     */
+    enum class PixelFormat : std::uint8_t {
+        /**
+         * One bit per pixel, eight pixels per byte, first pixel in the most
+         * significant bit.
+         */
+        Mono1,
+        /**
+         * One byte per pixel: 3 bits of red, 3 of green and 2 of blue.
+         */
+        Rgb332,
+        /**
+         * Two bytes per pixel, high byte first.
+         */
+        Rgb565,
+        /**
+         * Three bytes per pixel, red first, each channel in the high 6 bits.
+         */
+        Rgb666,
+        /**
+         * Three bytes per pixel, red first.
+         */
+        Rgb888,
+    };
+
+    /**
+     * A pixel of three 8-bit channels, laid out as it is sent.
+     */
+    struct Rgb24 {
+        std::uint8_t r, g, b;
+    };
+
+    static_assert(sizeof(Rgb24) == 3, "Rgb24 must have the layout of its wire bytes");
+
+    /**
+     * Describes a {@link PixelFormat}: the type holding one pixel, the bits
+     * it takes on the wire, and conversions to and from RGB565. Formats whose
+     * CONTIGUOUS is true keep arrays of Pixel in exactly their wire layout,
+     * so such arrays can be sent without being converted or copied.
+     *
+     * store writes the index-th pixel of a run of native bytes, and load
+     * reads it back; native gets a pixel as the right-aligned value of its
+     * wire bytes, first byte most significant.
+     *
+     * @tparam Format
+     */
+    template<PixelFormat Format>
+    struct PixelTraits;
+
+    template<>
+    struct PixelTraits<PixelFormat::Mono1> {
+        using Pixel = bool;
+        static constexpr std::uint8_t BITS = 1;
+        static constexpr bool CONTIGUOUS = false;
+
+        [[gnu::always_inline]]
+        inline static constexpr Pixel fromRgb565(std::uint16_t color) {
+            // Rec. 601 luma of the channels scaled to 0-31, 0-63 and 0-31.
+            return (std::uint32_t(color >> 11) * 2 * 77 + std::uint32_t(color >> 5 & 0x3F) * 150
+                    + std::uint32_t(color & 0x1F) * 2 * 29) >= 64 * 128;
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint16_t toRgb565(Pixel pixel) {
+            return pixel ? 0xFFFF : 0x0000;
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint32_t native(Pixel pixel) {
+            return pixel;
+        }
+
+        [[gnu::always_inline]]
+        inline static void store(std::uint8_t *data, std::size_t index, Pixel pixel) {
+            std::uint8_t bit = std::uint8_t(0x80 >> (index & 7));
+            data[index >> 3] = pixel ? data[index >> 3] | bit : data[index >> 3] & ~bit;
+        }
+
+        [[gnu::always_inline]]
+        inline static Pixel load(const std::uint8_t *data, std::size_t index) {
+            return data[index >> 3] & (0x80 >> (index & 7));
+        }
+    };
+
+    template<>
+    struct PixelTraits<PixelFormat::Rgb332> {
+        using Pixel = std::uint8_t;
+        static constexpr std::uint8_t BITS = 8;
+        static constexpr bool CONTIGUOUS = true;
+
+        [[gnu::always_inline]]
+        inline static constexpr Pixel fromRgb565(std::uint16_t color) {
+            return Pixel((color >> 8 & 0xE0) | (color >> 6 & 0x1C) | (color >> 3 & 0x03));
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint16_t toRgb565(Pixel pixel) {
+            std::uint16_t r = pixel >> 5,
+                          g = pixel >> 2 & 0x07,
+                          b = pixel & 0x03;
+            return std::uint16_t((r << 2 | r >> 1) << 11 | (g << 3 | g) << 5 | (b << 3 | b << 1 | b >> 1));
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint32_t native(Pixel pixel) {
+            return pixel;
+        }
+
+        [[gnu::always_inline]]
+        inline static void store(std::uint8_t *data, std::size_t index, Pixel pixel) {
+            data[index] = pixel;
+        }
+
+        [[gnu::always_inline]]
+        inline static Pixel load(const std::uint8_t *data, std::size_t index) {
+            return data[index];
+        }
+    };
+
+    template<>
+    struct PixelTraits<PixelFormat::Rgb565> {
+        using Pixel = std::uint16_t;
+        static constexpr std::uint8_t BITS = 16;
+        static constexpr bool CONTIGUOUS = false;
+
+        [[gnu::always_inline]]
+        inline static constexpr Pixel fromRgb565(std::uint16_t color) {
+            return color;
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint16_t toRgb565(Pixel pixel) {
+            return pixel;
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint32_t native(Pixel pixel) {
+            return pixel;
+        }
+
+        [[gnu::always_inline]]
+        inline static void store(std::uint8_t *data, std::size_t index, Pixel pixel) {
+            data[2 * index] = std::uint8_t(pixel >> 8);
+            data[2 * index + 1] = std::uint8_t(pixel);
+        }
+
+        [[gnu::always_inline]]
+        inline static Pixel load(const std::uint8_t *data, std::size_t index) {
+            return Pixel(data[2 * index] << 8 | data[2 * index + 1]);
+        }
+    };
+
+    template<>
+    struct PixelTraits<PixelFormat::Rgb888> {
+        using Pixel = Rgb24;
+        static constexpr std::uint8_t BITS = 24;
+        static constexpr bool CONTIGUOUS = true;
+
+        [[gnu::always_inline]]
+        inline static constexpr Pixel fromRgb565(std::uint16_t color) {
+            std::uint8_t r = color >> 11,
+                         g = color >> 5 & 0x3F,
+                         b = color & 0x1F;
+            return Pixel{std::uint8_t(r << 3 | r >> 2), std::uint8_t(g << 2 | g >> 4), std::uint8_t(b << 3 | b >> 2)};
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint16_t toRgb565(Pixel pixel) {
+            return rgb565(pixel.r, pixel.g, pixel.b);
+        }
+
+        [[gnu::always_inline]]
+        inline static constexpr std::uint32_t native(Pixel pixel) {
+            return std::uint32_t(pixel.r) << 16 | std::uint32_t(pixel.g) << 8 | pixel.b;
+        }
+
+        [[gnu::always_inline]]
+        inline static void store(std::uint8_t *data, std::size_t index, Pixel pixel) {
+            data[3 * index] = pixel.r;
+            data[3 * index + 1] = pixel.g;
+            data[3 * index + 2] = pixel.b;
+        }
+
+        [[gnu::always_inline]]
+        inline static Pixel load(const std::uint8_t *data, std::size_t index) {
+            return Pixel{data[3 * index], data[3 * index + 1], data[3 * index + 2]};
+        }
+    };
+
+    template<>
+    struct PixelTraits<PixelFormat::Rgb666> : PixelTraits<PixelFormat::Rgb888> {
+        [[gnu::always_inline]]
+        inline static constexpr Pixel fromRgb565(std::uint16_t color) {
+            Pixel pixel = PixelTraits<PixelFormat::Rgb888>::fromRgb565(color);
+            return Pixel{std::uint8_t(pixel.r & 0xFC), std::uint8_t(pixel.g & 0xFC), std::uint8_t(pixel.b & 0xFC)};
+        }
+    };
+
+    /**
+     * Gets the bits a pixel of format takes on the wire.
+     *
+     * @param format
+     * @return
+     */
+    [[gnu::always_inline]]
+    inline constexpr std::uint8_t bitsPerPixel(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::Mono1:
+                return PixelTraits<PixelFormat::Mono1>::BITS;
+            case PixelFormat::Rgb332:
+                return PixelTraits<PixelFormat::Rgb332>::BITS;
+            case PixelFormat::Rgb565:
+                return PixelTraits<PixelFormat::Rgb565>::BITS;
+            case PixelFormat::Rgb666:
+                return PixelTraits<PixelFormat::Rgb666>::BITS;
+            case PixelFormat::Rgb888:
+                return PixelTraits<PixelFormat::Rgb888>::BITS;
+        }
+        return 16;
+    }
+
+    /**
+     * Gets the bytes that count pixels of format take on the wire.
+     *
+     * @param format
+     * @param count
+     * @return
+     */
+    [[gnu::always_inline]]
+    inline constexpr std::size_t pixelBytes(PixelFormat format, std::size_t count) {
+        return (count * bitsPerPixel(format) + 7) / 8;
+    }
+
+    /**
+     * Converts an RGB565 color to the native value of a pixel of format, as
+     * {@link PixelTraits::native} would give it.
+     *
+     * @param format
+     * @param color
+     * @return
+     */
+    std::uint32_t rgb565ToNative(PixelFormat format, std::uint16_t color);
+
+    /**
+     * Converts the native value of a pixel of format to RGB565.
+     *
+     * @param format
+     * @param pixel
+     * @return
+     */
+    std::uint16_t nativeToRgb565(PixelFormat format, std::uint32_t pixel);
+
+    /**
+     * Converts count pixels of format, starting at the first bit of data, to
+     * RGB565.
+     *
+     * @param format
+     * @param count
+     * @param data
+     * @param out
+     */
+    [[gnu::nonnull]]
+    void nativeToRgb565(PixelFormat format, std::size_t count, const std::uint8_t *data, std::uint16_t *out);
+}
+
+#endif//__Kempozer_Screen_PixelFormat_h__
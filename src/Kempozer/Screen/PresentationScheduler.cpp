@@ -0,0 +1,366 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/PresentationScheduler.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        std::uint32_t systemClock() {
+#if defined(ARDUINO)
+            return micros();
+#else
+            using Clock = std::chrono::steady_clock;
+            return std::uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        /**
+         * Compares two wrapping clock readings.
+         */
+        [[gnu::always_inline]]
+        inline bool before(std::uint32_t a, std::uint32_t b) {
+            return std::int32_t(a - b) < 0;
+        }
+    }
+
+    PresentationScheduler::PresentationScheduler(Driver &driver, std::uint16_t refreshRate, Clock clock)
+        : mDriver(driver) {
+        mClock = clock ? clock : systemClock;
+        mStatistics = Statistics{};
+        mPeriod = 1000000u / (refreshRate ? refreshRate : 60);
+        mBlanking = 0;
+        mVsync = 0;
+        mPixelCost = 0;
+        mSignalTime = 0;
+        mSignals = 0;
+        mLines = 0;
+        mSync = driver.hasTearingEffect() ? Sync::Polled : Sync::Timer;
+        mSynced = false;
+        mFrameLate = false;
+    }
+
+    PresentationScheduler *PresentationScheduler::sync(Sync sync) {
+        mSync = sync;
+        mSynced = false;
+        return this;
+    }
+
+    PresentationScheduler *PresentationScheduler::blanking(std::uint32_t blanking) {
+        mBlanking = blanking < mPeriod ? blanking : 0;
+        return this;
+    }
+
+    PresentationScheduler *PresentationScheduler::pixelCost(std::uint32_t cost) {
+        mPixelCost = cost;
+        return this;
+    }
+
+    PresentationScheduler *PresentationScheduler::beginFrame() {
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        mLines = mDriver.rotated() ? width : height;
+        ++mStatistics.frames;
+        mFrameLate = false;
+
+        if (!mSynced && mSync != Sync::Timer) {
+            mDriver.tearingEffectOutput(true);
+        }
+        std::uint32_t now = mClock();
+        bool synced = false;
+        if (mSync == Sync::Polled) {
+            synced = waitForBlanking(now);
+        } else if (mSync == Sync::Interrupt) {
+            synced = waitForSignal(now);
+        }
+        if (synced) {
+            mStatistics.waited += mClock() - now;
+            return this;
+        }
+        if (mSync != Sync::Timer) {
+            ++mStatistics.timeouts;
+        }
+        // Follow the refresh rate from the last known start of a refresh.
+        now = mClock();
+        if (!mSynced) {
+            mVsync = now;
+            mSynced = true;
+        } else {
+            // Present at most one frame per refresh.
+            std::uint32_t periods = (now - mVsync) / mPeriod + 1;
+            mVsync += periods * mPeriod;
+        }
+        return this;
+    }
+
+    PresentationScheduler *PresentationScheduler::present(Rect rect, const std::uint16_t *pixels,
+                                                          std::size_t stride) {
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        Rect visible = rect;
+        if (!visible.clip(width, height)) {
+            return this;
+        }
+        pixels += std::size_t(visible.y1 - rect.y1) * stride + (visible.x1 - rect.x1);
+        rect = visible;
+        if (!mSynced) {
+            beginFrame();
+        }
+
+        std::uint16_t first, last;
+        scanRange(rect, first, last);
+        std::size_t area = rect.area();
+        // Rows reach the panel in scan order unless the controller maps them
+        // onto columns or flips them; then the scanline must stay out of the
+        // region for the whole upload.
+        bool ordered = !mDriver.hardwareRotation() || mDriver.rotation() == 0;
+        std::uint32_t duration = std::uint32_t((std::uint64_t(area) * mPixelCost + 999) / 1000),
+                      row = duration / rect.height(),
+                      fast = duration - duration * KEMPOZER_SCREEN_PRESENTATION_MARGIN / 100,
+                      slow = duration + duration * KEMPOZER_SCREEN_PRESENTATION_MARGIN / 100,
+                      enter = mVsync + lineTime(first),
+                      leave = mVsync + lineTime(std::uint32_t(last) + 1),
+                      earliest, latest;
+        if (ordered) {
+            // Start once the scanline is inside the region and even a faster
+            // than expected upload can no longer overtake it. Every row must
+            // be written before the scanline comes back to it: the first row
+            // is the one at risk when uploading outpaces the scanline, the
+            // last one when it lags behind.
+            earliest = before(enter, leave - fast) ? leave - fast : enter;
+            latest = enter + mPeriod - (row + row * KEMPOZER_SCREEN_PRESENTATION_MARGIN / 100);
+            if (before(leave + mPeriod - slow, latest)) {
+                latest = leave + mPeriod - slow;
+            }
+        } else {
+            earliest = leave;
+            latest = enter + mPeriod - slow;
+        }
+        if (slow >= mPeriod || before(latest, earliest)) {
+            // There is no tear-free window; stay behind the scanline and let
+            // the upload be reported late.
+            latest = earliest;
+        }
+        std::uint32_t now = mClock();
+        if (before(latest, now)) {
+            std::uint32_t slip = ((now - latest) / mPeriod + 1) * mPeriod;
+            earliest += slip;
+            enter += slip;
+            leave += slip;
+            ++mStatistics.missed;
+            if (!mFrameLate) {
+                mFrameLate = true;
+                ++mStatistics.missedFrames;
+            }
+        }
+        if (before(now, earliest)) {
+            waitUntil(earliest);
+            mStatistics.waited += earliest - now;
+        }
+
+        std::uint32_t start = mClock();
+        mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+        if (rect.width() == stride) {
+            mDriver.writePixels(area, pixels);
+        } else {
+            for (std::uint16_t y = rect.y1; y <= rect.y2; ++y, pixels += stride) {
+                mDriver.writePixels(rect.width(), pixels);
+            }
+        }
+        std::uint32_t end = mClock();
+        ++mStatistics.regions;
+
+        if (area >= KEMPOZER_SCREEN_PRESENTATION_MIN_SAMPLE) {
+            std::uint32_t cost = std::uint32_t(std::uint64_t(end - start) * 1000 / area);
+            mPixelCost = mPixelCost ? (mPixelCost * 3 + cost) / 4 : cost;
+        }
+        std::int32_t lateness = std::int32_t(end - (enter + mPeriod));
+        if (ordered) {
+            std::int32_t first = std::int32_t(start + (end - start) / rect.height() - (enter + mPeriod)),
+                         last = std::int32_t(end - (leave + mPeriod));
+            lateness = first > last ? first : last;
+        }
+        if (lateness > 0) {
+            ++mStatistics.late;
+            if (std::uint32_t(lateness) > mStatistics.worstLateness) {
+                mStatistics.worstLateness = std::uint32_t(lateness);
+            }
+            if (!mFrameLate) {
+                mFrameLate = true;
+                ++mStatistics.missedFrames;
+            }
+        }
+        return this;
+    }
+
+    PresentationScheduler *PresentationScheduler::present(DirtyRegionTracker &tracker) {
+        beginFrame();
+        std::size_t count = tracker.regionCount();
+        std::uint8_t order[KEMPOZER_SCREEN_MAX_DIRTY_REGIONS];
+        std::uint16_t keys[KEMPOZER_SCREEN_MAX_DIRTY_REGIONS];
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint16_t key = scanKey(tracker.region(i));
+            std::size_t j = i;
+            for (; j > 0 && keys[j - 1] > key; --j) {
+                keys[j] = keys[j - 1];
+                order[j] = order[j - 1];
+            }
+            keys[j] = key;
+            order[j] = std::uint8_t(i);
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const Rect &rect = tracker.region(order[i]);
+            present(rect, tracker.shadow() + std::size_t(rect.y1) * tracker.width() + rect.x1,
+                    tracker.width());
+        }
+        tracker.clear();
+        return this;
+    }
+
+    std::uint16_t PresentationScheduler::scanKey(const Rect &rect) {
+        std::uint16_t first, last;
+        scanRange(rect, first, last);
+        return first;
+    }
+
+    std::uint16_t PresentationScheduler::scanline() {
+        std::uint32_t phase = (mClock() - mVsync) % mPeriod;
+        if (phase < mBlanking || !mLines) {
+            return 0;
+        }
+        return std::uint16_t(std::uint64_t(phase - mBlanking) * mLines / (mPeriod - mBlanking));
+    }
+
+    PresentationScheduler *PresentationScheduler::resetStatistics() {
+        mStatistics = Statistics{};
+        return this;
+    }
+
+    void PresentationScheduler::scanRange(const Rect &rect, std::uint16_t &first, std::uint16_t &last) {
+        if (!mLines) {
+            std::uint16_t width, height;
+            mDriver.resolution(width, height);
+            mLines = mDriver.rotated() ? width : height;
+        }
+        // Under software rotation the driver is addressed natively already;
+        // under hardware rotation the controller maps logical rows and
+        // columns onto native lines as Driver::transform would.
+        int rotation = mDriver.hardwareRotation() ? mDriver.rotation() : 0;
+        switch (rotation) {
+            case 1:
+                first = rect.x1;
+                last = rect.x2;
+                break;
+            case 2:
+                first = mLines - 1 - rect.y2;
+                last = mLines - 1 - rect.y1;
+                break;
+            case 3:
+                first = mLines - 1 - rect.x2;
+                last = mLines - 1 - rect.x1;
+                break;
+            default:
+                first = rect.y1;
+                last = rect.y2;
+                break;
+        }
+    }
+
+    std::uint32_t PresentationScheduler::lineTime(std::uint32_t line) const {
+        return mBlanking + std::uint32_t(std::uint64_t(mPeriod - mBlanking) * line / mLines);
+    }
+
+    bool PresentationScheduler::waitForSignal(std::uint32_t start) {
+        std::uint32_t signals = mSignals,
+                      timeout = start + 2 * mPeriod;
+        while (mSignals == signals) {
+            if (before(timeout, mClock())) {
+                return false;
+            }
+        }
+        synchronize(mSignalTime);
+        return true;
+    }
+
+    bool PresentationScheduler::waitForBlanking(std::uint32_t start) {
+        std::uint32_t timeout = start + 2 * mPeriod;
+        bool level = mDriver.tearingEffect();
+        if (level && mSynced) {
+            // Already in blanking, which began one whole number of periods
+            // after the last one seen.
+            std::uint32_t vsync = mVsync + (start - mVsync) / mPeriod * mPeriod;
+            if (start - vsync < mBlanking) {
+                mVsync = vsync;
+                return true;
+            }
+        }
+        // Wait for a rising edge, so that the whole refresh lies ahead.
+        for (;;) {
+            bool current = mDriver.tearingEffect();
+            if (current && !level) {
+                break;
+            }
+            level = current;
+            if (before(timeout, mClock())) {
+                return false;
+            }
+        }
+        std::uint32_t vsync = mClock();
+        while (mDriver.tearingEffect()) {
+            if (before(timeout, mClock())) {
+                return false;
+            }
+        }
+        blanking(mClock() - vsync);
+        synchronize(vsync);
+        return true;
+    }
+
+    void PresentationScheduler::synchronize(std::uint32_t vsync) {
+        if (mSynced) {
+            // Refine the period, allowing for refreshes that went unseen.
+            std::uint32_t elapsed = vsync - mVsync,
+                          frames = (elapsed + mPeriod / 2) / mPeriod;
+            if (frames && frames < 8) {
+                mPeriod = (mPeriod * 7 + elapsed / frames) / 8;
+            }
+        }
+        mVsync = vsync;
+        mSynced = true;
+    }
+
+    void PresentationScheduler::waitUntil(std::uint32_t time) {
+        while (before(mClock(), time));
+    }
+}
@@ -0,0 +1,280 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_PresentationScheduler_h__
+#define __Kempozer_Screen_PresentationScheduler_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/DirtyRegionTracker.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Paces uploads to a {@link Driver} against the refresh of its panel so
+     * that the panel never scans out a half-written region.
+     *
+     * The panel refreshes its lines top to bottom, along its native vertical
+     * axis, once every {@link period()}. A region is uploaded only once the
+     * scanline has entered it and late enough that the upload cannot overtake
+     * the scanline, and must be finished before the scanline comes around to
+     * it again; regions are therefore sent in scan order, racing the beam.
+     * How long an upload takes is learned from the uploads already made.
+     *
+     * The refresh is followed in one of three ways:
+     *
+     * - {@link Sync::Polled}: the driver's {@link Driver::tearingEffect()} is
+     *   polled for the start of vertical blanking at the beginning of every
+     *   frame, which also measures the period and the length of blanking.
+     * - {@link Sync::Interrupt}: the board calls {@link signal()} from the
+     *   interrupt handler of the TE line's rising edge.
+     * - {@link Sync::Timer}: the refresh is assumed to run at the configured
+     *   rate, from the phase given to {@link synchronize(std::uint32_t)}.
+     *   Without a phase the first frame is taken as the start of a refresh,
+     *   which is a guess: uploads are then only paced at the refresh rate
+     *   and kept in scan order, and may tear like unscheduled ones.
+     *
+     * Waiting is done by spinning on the clock, which reads microseconds.
+     */
+    class PresentationScheduler {
+    public:
+        /**
+         * A source of microseconds, which may wrap around.
+         */
+        using Clock = std::uint32_t (*)();
+
+        /**
+         * How the scheduler follows the refresh of the panel.
+         */
+        enum class Sync : std::uint8_t {
+            Timer,
+            Polled,
+            Interrupt,
+        };
+
+        /**
+         * Counters since construction or the last call to
+         * {@link resetStatistics()}. Times are in microseconds.
+         *
+         * missed counts regions whose window had already closed when they
+         * were presented, and were held back to a later refresh. late counts
+         * regions still being uploaded when the scanline came back to them,
+         * which may have torn, and worstLateness is by how much the worst of
+         * them overran. missedFrames counts frames with either; timeouts
+         * counts frames for which no start of blanking was seen within two
+         * periods. missed and late are measured against the refresh the
+         * scheduler follows, so in {@link Sync::Timer} mode without a phase
+         * they do not reveal tearing.
+         */
+        struct Statistics {
+            std::uint32_t frames;
+            std::uint32_t regions;
+            std::uint32_t missed;
+            std::uint32_t late;
+            std::uint32_t missedFrames;
+            std::uint32_t timeouts;
+            std::uint32_t worstLateness;
+            std::uint64_t waited;
+        };
+
+        /**
+         * Creates a scheduler for a panel refreshing refreshRate times per
+         * second. It follows the TE line by polling if the driver has one, and
+         * the refresh rate otherwise.
+         *
+         * @param driver
+         * @param refreshRate
+         * @param clock The clock to use, or nullptr for the system's.
+         */
+        PresentationScheduler(Driver &driver, std::uint16_t refreshRate, Clock clock = nullptr);
+
+        /**
+         * Changes how the refresh is followed. The TE output of the
+         * controller is turned on at the start of the next frame unless sync
+         * is {@link Sync::Timer}.
+         *
+         * @param sync
+         */
+        PresentationScheduler *sync(Sync sync);
+
+        /**
+         * Gets how the refresh is followed.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline Sync sync() const {
+            return mSync;
+        }
+
+        /**
+         * Sets how long, in microseconds, vertical blanking lasts after the
+         * start of each refresh. {@link Sync::Polled} measures it instead.
+         *
+         * @param blanking
+         */
+        PresentationScheduler *blanking(std::uint32_t blanking);
+
+        /**
+         * Records the start of vertical blanking. It is safe to call from an
+         * interrupt handler.
+         */
+        [[gnu::always_inline]]
+        inline void signal() {
+            mSignalTime = mClock();
+            mSignals = mSignals + 1;
+        }
+
+        /**
+         * Records that a refresh began at vsync, a reading of the clock, such
+         * as one taken from a TE edge or a panel's frame counter. This gives
+         * {@link Sync::Timer} mode the phase of the panel, and refines the
+         * period when a refresh was already known.
+         *
+         * @param vsync
+         */
+        void synchronize(std::uint32_t vsync);
+
+        /**
+         * Gets the refresh period, in microseconds.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t period() const {
+            return mPeriod;
+        }
+
+        /**
+         * Gets the learned cost of uploading a pixel, in nanoseconds.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t pixelCost() const {
+            return mPixelCost;
+        }
+
+        /**
+         * Sets the cost of uploading a pixel, in nanoseconds, from which the
+         * scheduler goes on learning. Until it is known the scheduler
+         * assumes uploads are instant, and waits for the scanline to leave a
+         * region before uploading it.
+         *
+         * @param cost
+         */
+        PresentationScheduler *pixelCost(std::uint32_t cost);
+
+        /**
+         * Waits for the next refresh to begin, when following the TE line,
+         * and starts a new frame.
+         */
+        PresentationScheduler *beginFrame();
+
+        /**
+         * Uploads a rectangle of a bitmap whose rows are stride pixels apart,
+         * once the scanline allows it. pixels points at the pixel of
+         * rect.x1, rect.y1. Regions of a frame must be presented in scan
+         * order, see {@link present(DirtyRegionTracker &)}.
+         *
+         * @param rect
+         * @param pixels
+         * @param stride
+         */
+        [[gnu::nonnull]]
+        PresentationScheduler *present(Rect rect, const std::uint16_t *pixels, std::size_t stride);
+
+        /**
+         * Begins a frame and uploads every region damaged in tracker in scan
+         * order, then forgets them.
+         *
+         * @param tracker
+         */
+        PresentationScheduler *present(DirtyRegionTracker &tracker);
+
+        /**
+         * Gets the scan key of a rectangle: the first native line of the
+         * panel that shows any of it.
+         *
+         * @param rect
+         * @return
+         */
+        std::uint16_t scanKey(const Rect &rect);
+
+        /**
+         * Gets the line the panel is believed to be scanning now.
+         *
+         * @return
+         */
+        std::uint16_t scanline();
+
+        /**
+         * Gets the counters of this scheduler.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Statistics &statistics() const {
+            return mStatistics;
+        }
+
+        /**
+         * Zeroes the counters of this scheduler.
+         */
+        PresentationScheduler *resetStatistics();
+    private:
+        void scanRange(const Rect &rect, std::uint16_t &first, std::uint16_t &last);
+
+        std::uint32_t lineTime(std::uint32_t line) const;
+
+        bool waitForSignal(std::uint32_t start);
+
+        bool waitForBlanking(std::uint32_t start);
+
+        void waitUntil(std::uint32_t time);
+
+        Driver &mDriver;
+        Clock mClock;
+        Statistics mStatistics;
+        std::uint32_t mPeriod,
+                      mBlanking,
+                      mVsync,
+                      mPixelCost;
+        volatile std::uint32_t mSignalTime,
+                               mSignals;
+        std::uint16_t mLines;
+        Sync mSync;
+        bool mSynced;
+        bool mFrameLate;
+    };
+}
+
+#endif//__Kempozer_Screen_PresentationScheduler_h__
@@ -0,0 +1,122 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/RegionSet.h"
+
+namespace Kempozer::Screen {
+    RegionSet::RegionSet() {
+        mWindowCost = 32;
+        mCount = 0;
+    }
+
+    RegionSet *RegionSet::add(Rect rect) {
+        // Keep absorbing existing regions into rect for as long as it pays,
+        // since every merge grows rect and may make further merges worthwhile.
+        bool merged;
+        do {
+            merged = false;
+            for (std::size_t i = 0; i < mCount; ++i) {
+                if (worthMerging(rect, mRegions[i])) {
+                    rect = rect.united(mRegions[i]);
+                    remove(i);
+                    merged = true;
+                    break;
+                }
+            }
+        } while (merged);
+        insert(rect);
+        return this;
+    }
+
+    void RegionSet::insert(const Rect &rect) {
+        // Clip rect against the first region it overlaps and insert what is
+        // left, so no pixel is ever kept, and sent, twice. The pieces are
+        // smaller than rect, so this ends.
+        for (std::size_t i = 0; i < mCount; ++i) {
+            const Rect &other = mRegions[i];
+            if (!rect.intersects(other)) {
+                continue;
+            }
+            if (other.x1 <= rect.x1 && rect.x2 <= other.x2 && other.y1 <= rect.y1 && rect.y2 <= other.y2) {
+                return;
+            }
+            Rect overlap{rect.x1 > other.x1 ? rect.x1 : other.x1, rect.y1 > other.y1 ? rect.y1 : other.y1,
+                         rect.x2 < other.x2 ? rect.x2 : other.x2, rect.y2 < other.y2 ? rect.y2 : other.y2};
+            if (rect.y1 < overlap.y1) {
+                insert(Rect{rect.x1, rect.y1, rect.x2, std::uint16_t(overlap.y1 - 1)});
+            }
+            if (overlap.y2 < rect.y2) {
+                insert(Rect{rect.x1, std::uint16_t(overlap.y2 + 1), rect.x2, rect.y2});
+            }
+            if (rect.x1 < overlap.x1) {
+                insert(Rect{rect.x1, overlap.y1, std::uint16_t(overlap.x1 - 1), overlap.y2});
+            }
+            if (overlap.x2 < rect.x2) {
+                insert(Rect{std::uint16_t(overlap.x2 + 1), overlap.y1, rect.x2, overlap.y2});
+            }
+            return;
+        }
+
+        if (mCount == KEMPOZER_SCREEN_MAX_DIRTY_REGIONS) {
+            // Out of room: merge rect with its cheapest partner, the region
+            // whose bounding box with it is smallest, then absorb whatever
+            // that box now overlaps so the regions stay disjoint.
+            std::size_t best = 0,
+                        bestCost = ~std::size_t(0);
+            for (std::size_t i = 0; i < mCount; ++i) {
+                std::size_t cost = rect.united(mRegions[i]).area();
+                if (cost < bestCost) {
+                    best = i;
+                    bestCost = cost;
+                }
+            }
+            Rect united = rect.united(mRegions[best]);
+            remove(best);
+            for (std::size_t i = 0; i < mCount;) {
+                if (united.intersects(mRegions[i])) {
+                    united = united.united(mRegions[i]);
+                    remove(i);
+                    i = 0;
+                } else {
+                    ++i;
+                }
+            }
+            mRegions[mCount++] = united;
+            return;
+        }
+        mRegions[mCount++] = rect;
+    }
+
+    void RegionSet::remove(std::size_t index) {
+        mRegions[index] = mRegions[--mCount];
+    }
+
+    bool RegionSet::worthMerging(const Rect &a, const Rect &b) const {
+        return a.united(b).area() <= a.area() + b.area() + mWindowCost;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_RegionSet_h__
+#define __Kempozer_Screen_RegionSet_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A small set of rectangles to be sent to a screen, kept cheap to send.
+     *
+     * Rectangles are merged whenever sending their bounding box costs no more
+     * than sending them separately, where each extra address window is
+     * charged {@link windowCost()} pixels. A rectangle that overlaps one it is
+     * not worth merging with is clipped to the part not already in the set,
+     * so the rectangles never overlap and no pixel is sent twice. At most
+     * KEMPOZER_SCREEN_MAX_DIRTY_REGIONS rectangles are kept; beyond that a new
+     * rectangle is merged regardless with its cheapest partner, the one whose
+     * bounding box with it is smallest.
+     */
+    class RegionSet {
+    public:
+        RegionSet();
+
+        /**
+         * Adds a rectangle, merging it with the rectangles already in the
+         * set as described above.
+         *
+         * @param rect
+         */
+        RegionSet *add(Rect rect);
+
+        /**
+         * Empties the set.
+         */
+        [[gnu::always_inline]]
+        inline RegionSet *clear() {
+            mCount = 0;
+            return this;
+        }
+
+        /**
+         * Gets the number of rectangles in the set.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t count() const {
+            return mCount;
+        }
+
+        /**
+         * Gets a rectangle of the set.
+         *
+         * @param index
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Rect &region(std::size_t index) const {
+            return mRegions[index];
+        }
+
+        /**
+         * Gets the cost of setting up an address window, in pixels.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t windowCost() const {
+            return mWindowCost;
+        }
+
+        /**
+         * Sets the cost of setting up an address window, in pixels.
+         *
+         * @param cost
+         */
+        [[gnu::always_inline]]
+        inline RegionSet *windowCost(std::size_t cost) {
+            mWindowCost = cost;
+            return this;
+        }
+    private:
+        void insert(const Rect &rect);
+
+        void remove(std::size_t index);
+
+        bool worthMerging(const Rect &a, const Rect &b) const;
+
+        std::size_t mWindowCost,
+                    mCount;
+        Rect mRegions[KEMPOZER_SCREEN_MAX_DIRTY_REGIONS];
+    };
+}
+
+#endif//__Kempozer_Screen_RegionSet_h__
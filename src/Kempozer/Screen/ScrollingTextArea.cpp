@@ -0,0 +1,185 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/Canvas.h"
+#include "Kempozer/Screen/ScrollingTextArea.h"
+
+namespace Kempozer::Screen {
+    ScrollingTextArea::ScrollingTextArea(Driver &driver, const Font &font, std::uint16_t top,
+                                         std::uint16_t lines, char *text, std::uint16_t columns)
+        : mDriver(driver), mFont(font) {
+        mText = text;
+        mTop = top;
+        mLines = lines ? lines : 1;
+        mColumns = columns;
+        mFirst = 0;
+        mCount = 0;
+        mForeground = 0xFFFF;
+        mBackground = 0x0000;
+        mBegun = false;
+        mHardware = false;
+    }
+
+    ScrollingTextArea *ScrollingTextArea::colors(std::uint16_t foreground, std::uint16_t background) {
+        mForeground = foreground;
+        mBackground = background;
+        return this;
+    }
+
+    ScrollingTextArea *ScrollingTextArea::clear() {
+        mFirst = 0;
+        mCount = 0;
+        for (std::uint16_t i = 0; i < mLines; ++i) {
+            slot(i)[0] = '\0';
+        }
+        begin();
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        std::uint32_t bottom = std::uint32_t(mTop) + std::uint32_t(mLines) * mFont.height;
+        if (mTop < height && width) {
+            bottom = bottom > height ? height : bottom;
+            Rect rect{0, mTop, std::uint16_t(width - 1), std::uint16_t(bottom - 1)};
+            mDriver.transform(rect);
+            mDriver.setAddressWindow(rect.x1, rect.y1, rect.x2, rect.y2);
+            mDriver.writeRepeatedPixel(std::size_t(width) * (bottom - mTop), mBackground);
+        }
+        return this;
+    }
+
+    ScrollingTextArea *ScrollingTextArea::append(const char *line) {
+        if (!mBegun) {
+            clear();
+        }
+        std::uint16_t index;
+        bool scrolled = mCount == mLines;
+        if (scrolled) {
+            index = mFirst;
+            mFirst = (mFirst + 1) % mLines;
+        } else {
+            index = (mFirst + mCount++) % mLines;
+        }
+        char *text = slot(index);
+        std::strncpy(text, line, mColumns);
+        text[mColumns] = '\0';
+        if (mHardware) {
+            // The line that scrolled off the top becomes the bottom line, so
+            // only it needs to be rewritten.
+            if (scrolled) {
+                mDriver.scroll(std::uint16_t(mTop + mFirst * mFont.height));
+            }
+            drawLine(std::uint16_t(mTop + index * mFont.height), text);
+        } else if (scrolled) {
+            redraw();
+        } else {
+            drawLine(std::uint16_t(mTop + (mCount - 1) * mFont.height), text);
+        }
+        return this;
+    }
+
+    ScrollingTextArea *ScrollingTextArea::redraw() {
+        if (!mBegun) {
+            return clear();
+        }
+        for (std::uint16_t i = 0; i < mCount; ++i) {
+            std::uint16_t index = (mFirst + i) % mLines,
+                          row = mHardware ? index : i;
+            drawLine(std::uint16_t(mTop + row * mFont.height), slot(index));
+        }
+        return this;
+    }
+
+    void ScrollingTextArea::begin() {
+        mBegun = true;
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        std::uint32_t band = std::uint32_t(mLines) * mFont.height;
+        mHardware = mDriver.scrollable() && mDriver.rotation() == 0 && mTop + band <= height;
+        if (mHardware) {
+            mDriver.scrollArea(mTop, std::uint16_t(band), std::uint16_t(height - mTop - band));
+            mDriver.scroll(mTop);
+        }
+    }
+
+    void ScrollingTextArea::drawLine(std::uint16_t y, const char *text) {
+        std::uint16_t width, height;
+        mDriver.resolution(width, height);
+        if (y >= height || !width) {
+            return;
+        }
+        std::uint16_t rows = mFont.height;
+        if (std::uint32_t(y) + rows > height) {
+            rows = height - y;
+        }
+        // Without hardware rotation every row goes out as its own spans.
+        bool window = mDriver.hardwareRotation();
+        Canvas canvas(mDriver);
+        if (window) {
+            mDriver.setAddressWindow(0, y, width - 1, y + rows - 1);
+        }
+        std::uint16_t buffer[256];
+        for (std::uint16_t r = 0; r < rows; ++r) {
+            std::size_t used = 0;
+            std::uint16_t column = 0;
+            auto flush = [&]() {
+                if (window) {
+                    mDriver.writePixels(used, buffer);
+                } else {
+                    canvas.drawSpan(std::int16_t(column - used), std::int16_t(y + r), std::int16_t(used), buffer);
+                }
+                used = 0;
+            };
+            for (const char *c = text; *c && column < width; ++c) {
+                const Glyph *glyph = mFont.glyph(std::uint8_t(*c));
+                if (!glyph || !glyph->advance) {
+                    continue;
+                }
+                if (used + glyph->advance > sizeof(buffer) / sizeof(*buffer)) {
+                    flush();
+                }
+                rasterizeGlyph(mFont, *glyph, mForeground, mBackground, r, 1, buffer + used);
+                std::uint16_t visible = glyph->advance;
+                if (column + visible > width) {
+                    visible = width - column;
+                }
+                used += visible;
+                column += visible;
+            }
+            if (used) {
+                flush();
+            }
+            if (column < width) {
+                if (window) {
+                    mDriver.writeRepeatedPixel(width - column, mBackground);
+                } else {
+                    canvas.hline(std::int16_t(column), std::int16_t(y + r), std::int16_t(width - column), mBackground);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_ScrollingTextArea_h__
+#define __Kempozer_Screen_ScrollingTextArea_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Font.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A full-width band of text lines that scrolls up as lines are appended,
+     * such as a log view.
+     *
+     * When the driver is {@link Driver::scrollable()} and not rotated, the
+     * band is made the screen's vertical scrolling area and used as a ring:
+     * appending to a full band issues one {@link Driver::scroll(std::uint16_t)}
+     * and rewrites only the line that scrolled off, which becomes the new
+     * bottom line. Otherwise every line is redrawn in its new place.
+     *
+     * Each line is sent with a single address window spanning the width of
+     * the screen. The text of every line is kept in caller-provided storage so
+     * that the band can be redrawn at any time.
+     */
+    class ScrollingTextArea {
+    public:
+        /**
+         * Creates a band of lines lines of font, starting top pixels from the
+         * top of the screen. Lines are truncated to columns characters. text
+         * must hold lines * (columns + 1) characters and outlive this area.
+         *
+         * Nothing is sent to driver until the first call to {@link clear()} or
+         * {@link append(const char *)}.
+         *
+         * @param driver
+         * @param font
+         * @param top
+         * @param lines
+         * @param text
+         * @param columns
+         */
+        [[gnu::nonnull]]
+        ScrollingTextArea(Driver &driver, const Font &font, std::uint16_t top, std::uint16_t lines,
+                          char *text, std::uint16_t columns);
+
+        /**
+         * Sets the colors of the text and of the band. Lines already drawn
+         * keep their colors until the next {@link redraw()}.
+         *
+         * @param foreground
+         * @param background
+         */
+        ScrollingTextArea *colors(std::uint16_t foreground, std::uint16_t background);
+
+        /**
+         * Forgets every line, defines the scrolling area and fills the band
+         * with the background color.
+         */
+        ScrollingTextArea *clear();
+
+        /**
+         * Appends a line at the bottom of the band, scrolling the oldest line
+         * out once the band is full.
+         *
+         * @param line
+         */
+        [[gnu::nonnull]]
+        ScrollingTextArea *append(const char *line);
+
+        /**
+         * Redraws every line of the band.
+         */
+        ScrollingTextArea *redraw();
+
+        /**
+         * Gets the number of lines currently shown.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t count() const {
+            return mCount;
+        }
+
+        /**
+         * Gets the text of the index-th line from the top of the band.
+         *
+         * @param index
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const char *line(std::uint16_t index) const {
+            return slot((mFirst + index) % mLines);
+        }
+
+        /**
+         * Gets whether or not appending uses hardware scrolling.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool hardwareScrolling() const {
+            return mHardware;
+        }
+    private:
+        [[gnu::always_inline]]
+        inline char *slot(std::uint16_t index) const {
+            return mText + std::size_t(index) * (mColumns + 1);
+        }
+
+        void begin();
+
+        void drawLine(std::uint16_t y, const char *text);
+
+        Driver &mDriver;
+        const Font &mFont;
+        char *mText;
+        std::uint16_t mTop,
+                      mLines,
+                      mColumns,
+                      mFirst,
+                      mCount,
+                      mForeground,
+                      mBackground;
+        bool mBegun,
+             mHardware;
+    };
+
+    /**
+     * A {@link ScrollingTextArea} that owns its text storage.
+     *
+     * @tparam Lines
+     * @tparam Columns
+     */
+    template<std::uint16_t Lines, std::uint16_t Columns>
+    class StaticScrollingTextArea : public ScrollingTextArea {
+    public:
+        StaticScrollingTextArea(Driver &driver, const Font &font, std::uint16_t top)
+            : ScrollingTextArea(driver, font, top, Lines, mStorage, Columns) {}
+    private:
+        char mStorage[std::size_t(Lines) * (Columns + 1)];
+    };
+}
+
+#endif//__Kempozer_Screen_ScrollingTextArea_h__
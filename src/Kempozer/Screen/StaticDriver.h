@@ -0,0 +1,949 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_StaticDriver_h__
+#define __Kempozer_Screen_StaticDriver_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "KempozerScreenConcepts.h"
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/CommandBuffer.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/PixelFormat.h"
+#include "Kempozer/Screen/Types.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+namespace Kempozer::Screen {
+
+    /**
+     * A compile-time counterpart of {@link Driver}. Drivers derive from
+     * StaticDriver<Derived> and implement the same primitives that
+     * {@link Driver} requires (initialize, select, deselect, assertCommand,
+     * deassertCommand, writePixel, write, readPixel, read, addressWindow,
+     * and setAddressWindow) as ordinary, non-virtual member functions, plus
+     * applyRotation if the controller can rotate.
+     *
+     * Every default provided here calls back into Derived directly, so the
+     * compiler resolves and inlines the whole call chain: a full screen fill
+     * through {@link writeRepeatedPixel(std::size_t, std::uint16_t)} becomes a
+     * tight loop over the derived writePixel instead of one indirect call per
+     * pixel or byte. Any default may be hidden by a method of the same name in
+     * Derived, and the remaining defaults will pick it up.
+     *
+     * Multi-byte values are sent in KEMPOZER_SCREEN_WIRE_BYTE_ORDER.
+     *
+     * Use {@link StaticDriverAdapter} to hand a static driver to code that
+     * takes a {@link Driver}.
+     *
+     * @tparam Derived
+     */
+    template<typename Derived>
+    class StaticDriver {
+    public:
+        /**
+         * The order in which the bytes of multi-byte values are sent. Unlike
+         * {@link Driver::byteOrder()}, this is fixed at compile time.
+         */
+        static constexpr ByteOrder WIRE_BYTE_ORDER = KEMPOZER_SCREEN_WIRE_BYTE_ORDER;
+
+        /**
+         * Called when an asynchronous transfer has completed.
+         */
+        using TransferCallback = void (*)(Derived *driver, void *context);
+
+        /**
+         * Sends a command to the screen. This command must be convertible
+         * to an {@link std::uint8_t}, {@link std::uint16_t}, {@link std::uint32_t},
+         * or {@link std::uint64_t}.
+         *
+         * @tparam EnumT
+         */
+        template<commandtype EnumT>
+        [[gnu::always_inline]]
+        inline Derived *writeCommand(EnumT command) {
+            using UnderlyingT = std::underlying_type_t<EnumT>;
+            derived()->assertCommand();
+            if constexpr (std::is_same_v<std::uint8_t, UnderlyingT>) {
+                derived()->write(std::uint8_t(command));
+            } else if constexpr (std::is_same_v<std::uint16_t, UnderlyingT>) {
+                derived()->write16(std::uint16_t(command));
+            } else if constexpr (std::is_same_v<std::uint32_t, UnderlyingT>) {
+                derived()->write32(std::uint32_t(command));
+            } else if constexpr (std::is_same_v<std::uint64_t, UnderlyingT>) {
+                derived()->write64(std::uint64_t(command));
+            }
+            derived()->deassertCommand();
+            return derived();
+        }
+
+        /**
+         * Sends all 16-bit pixels to the screen.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline Derived *writePixels(std::size_t count, const std::uint16_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                derived()->writePixel(data[i]);
+            }
+            return derived();
+        }
+
+        /**
+         * Sends all 16-bit pixels to the screen.
+         *
+         * @tparam C
+         * @param data
+         */
+        template<std::size_t C>
+        [[gnu::always_inline]]
+        inline Derived *writePixels(const std::uint16_t (&data)[C]) {
+            return derived()->writePixels(C, data);
+        }
+
+        /**
+         * Starts sending all 16-bit pixels to the screen and returns, possibly
+         * before the transfer has completed. data must remain valid and
+         * unmodified until callback is called with context. If a previous
+         * transfer is still in progress, it is waited for first. Unless hidden
+         * by Derived, together with poll and wait, the pixels are sent through
+         * writePixels and callback is called before returning.
+         *
+         * @param count
+         * @param data
+         * @param callback
+         * @param context
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull(3)]]
+        inline Derived *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                         TransferCallback callback = nullptr, void *context = nullptr) {
+            derived()->writePixels(count, data);
+            if (callback) {
+                callback(derived(), context);
+            }
+            return derived();
+        }
+
+        /**
+         * Advances any asynchronous transfer in progress, calling its callback
+         * if it has completed. False unless hidden by Derived.
+         *
+         * @return Whether an asynchronous transfer is still in progress.
+         */
+        [[gnu::always_inline]]
+        inline bool poll() {
+            return false;
+        }
+
+        /**
+         * Blocks until every asynchronous transfer has completed and its
+         * callback has been called.
+         */
+        [[gnu::always_inline]]
+        inline Derived *wait() {
+            while (derived()->poll());
+            return derived();
+        }
+
+        /**
+         * Sends the same color of pixel to the screen repeatedly.
+         *
+         * @param count
+         * @param color
+         */
+        [[gnu::always_inline]]
+        inline Derived *writeRepeatedPixel(std::size_t count, const std::uint16_t color) {
+            for (std::size_t i = 0; i < count; ++i) {
+                derived()->writePixel(color);
+            }
+            return derived();
+        }
+
+        /**
+         * Gets the format in which the controller takes pixels.
+         * {@link PixelFormat::Rgb565} unless hidden by Derived.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline PixelFormat pixelFormat() {
+            return PixelFormat::Rgb565;
+        }
+
+        /**
+         * Sends count pixels already in Derived's pixelFormat(). Unless hidden
+         * by Derived, they are converted to RGB565
+         * KEMPOZER_SCREEN_CONVERSION_CHUNK pixels at a time and sent through
+         * writePixels.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline Derived *writeNativePixels(std::size_t count, const std::uint8_t *data) {
+            // Chunks hold a multiple of 8 pixels, so that 1-bit pixels start
+            // each chunk on a byte boundary.
+            constexpr std::size_t CHUNK = KEMPOZER_SCREEN_CONVERSION_CHUNK & ~std::size_t(7);
+            static_assert(CHUNK > 0, "KEMPOZER_SCREEN_CONVERSION_CHUNK must be at least 8");
+            PixelFormat format = derived()->pixelFormat();
+            std::uint16_t chunk[CHUNK];
+            while (count) {
+                std::size_t size = count < CHUNK ? count : CHUNK;
+                nativeToRgb565(format, size, data, chunk);
+                derived()->writePixels(size, chunk);
+                data += pixelBytes(format, size);
+                count -= size;
+            }
+            return derived();
+        }
+
+        /**
+         * Sends the same pixel in Derived's pixelFormat() repeatedly. Unless
+         * hidden by Derived, it is converted to RGB565 and sent through
+         * writeRepeatedPixel.
+         *
+         * @param count
+         * @param pixel
+         */
+        [[gnu::always_inline]]
+        inline Derived *writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) {
+            return derived()->writeRepeatedPixel(count, nativeToRgb565(derived()->pixelFormat(), pixel));
+        }
+
+        /**
+         * Sends a 16-bit value to the screen.
+         *
+         * @param u16
+         */
+        [[gnu::always_inline]]
+        inline Derived *write16(std::uint16_t u16) {
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                derived()->write(std::uint8_t(u16 >> 8));
+                return derived()->write(std::uint8_t(u16));
+            }
+            derived()->write(std::uint8_t(u16));
+            return derived()->write(std::uint8_t(u16 >> 8));
+        }
+
+        /**
+         * Sends a 32-bit value to the screen.
+         *
+         * @param u32
+         */
+        [[gnu::always_inline]]
+        inline Derived *write32(std::uint32_t u32) {
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                derived()->write16(std::uint16_t(u32 >> 16));
+                return derived()->write16(std::uint16_t(u32));
+            }
+            derived()->write16(std::uint16_t(u32));
+            return derived()->write16(std::uint16_t(u32 >> 16));
+        }
+
+        /**
+         * Sends a 64-bit value to the screen.
+         *
+         * @param u64
+         */
+        [[gnu::always_inline]]
+        inline Derived *write64(std::uint64_t u64) {
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                derived()->write32(std::uint32_t(u64 >> 32));
+                return derived()->write32(std::uint32_t(u64));
+            }
+            derived()->write32(std::uint32_t(u64));
+            return derived()->write32(std::uint32_t(u64 >> 32));
+        }
+
+        /**
+         * Sends count 8-bit values to the screen.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline Derived *writeArray(std::size_t count, const std::uint8_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                derived()->write(data[i]);
+            }
+            return derived();
+        }
+
+        /**
+         * Sends count 8-bit values to the screen.
+         *
+         * @tparam C
+         * @param data
+         */
+        template<std::size_t C>
+        [[gnu::always_inline]]
+        inline Derived *writeArray(const std::uint8_t (&data)[C]) {
+            return derived()->writeArray(C, data);
+        }
+
+        /**
+         * Sends count 16-bit values to the screen in
+         * KEMPOZER_SCREEN_WIRE_BYTE_ORDER.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline Derived *writeArray16(std::size_t count, const std::uint16_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                derived()->write16(data[i]);
+            }
+            return derived();
+        }
+
+        /**
+         * Sends a batch of commands, parameters and pixels recorded by a
+         * {@link CommandBuffer}. Unless hidden by Derived, each record is
+         * replayed through assertCommand, writeArray and writePixels.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline Derived *submit(std::size_t count, const std::uint8_t *data) {
+            CommandBuffer::Record record;
+            while (std::size_t size = CommandBuffer::decode(count, data, record)) {
+                switch (record.type) {
+                    case CommandBuffer::RecordType::Command:
+                        derived()->assertCommand();
+                        derived()->writeArray(record.length, record.payload);
+                        derived()->deassertCommand();
+                        break;
+                    case CommandBuffer::RecordType::Data:
+                        derived()->writeArray(record.length, record.payload);
+                        break;
+                    case CommandBuffer::RecordType::Pixels:
+                        derived()->writePixels(record.length / sizeof(std::uint16_t),
+                                               reinterpret_cast<const std::uint16_t *>(record.payload));
+                        break;
+                }
+                count -= size;
+                data += size;
+            }
+            return derived();
+        }
+
+        /**
+         * Waits for the given number of milliseconds, such as after a reset
+         * or sleep out command. Blocks with the platform's delay unless hidden
+         * by Derived.
+         *
+         * @param milliseconds
+         */
+        [[gnu::always_inline]]
+        inline Derived *pause(std::uint16_t milliseconds) {
+#if defined(ARDUINO)
+            delay(milliseconds);
+#else
+            std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+#endif
+            return derived();
+        }
+
+        /**
+         * Reads all 16-bit pixels from the screen.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline void readPixels(std::size_t count, std::uint16_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i] = derived()->readPixel();
+            }
+        }
+
+        template<std::size_t C>
+        [[gnu::always_inline]]
+        inline void readPixels(std::uint16_t (&data)[C]) {
+            derived()->readPixels(C, data);
+        }
+
+        /**
+         * Receives a 16-bit value from the screen.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t read16() {
+            std::uint16_t first = derived()->read(),
+                          second = derived()->read();
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                return (first << 8) | second;
+            }
+            return first | (second << 8);
+        }
+
+        /**
+         * Receives a 32-bit value from the screen.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t read32() {
+            std::uint32_t first = derived()->read16(),
+                          second = derived()->read16();
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                return (first << 16) | second;
+            }
+            return first | (second << 16);
+        }
+
+        /**
+         * Receives a 64-bit value from the screen.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint64_t read64() {
+            std::uint64_t first = derived()->read32(),
+                          second = derived()->read32();
+            if constexpr (WIRE_BYTE_ORDER == ByteOrder::BigEndian) {
+                return (first << 32) | second;
+            }
+            return first | (second << 32);
+        }
+
+        /**
+         * Recieves count 8-bit values from the screen.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline void readArray(std::size_t count, std::uint8_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i] = derived()->read();
+            }
+        }
+
+        /**
+         * Recieves count 8-bit values from the screen.
+         *
+         * @tparam C
+         * @param data
+         */
+        template<std::size_t C>
+        [[gnu::always_inline]]
+        inline void readArray(std::uint8_t (&data)[C]) {
+            derived()->readArray(C, data);
+        }
+
+        /**
+         * Receives count 16-bit values from the screen in
+         * KEMPOZER_SCREEN_WIRE_BYTE_ORDER.
+         *
+         * @param count
+         * @param data
+         */
+        [[gnu::always_inline]]
+        [[gnu::nonnull]]
+        inline void readArray16(std::size_t count, std::uint16_t *data) {
+            for (std::size_t i = 0; i < count; ++i) {
+                data[i] = derived()->read16();
+            }
+        }
+
+        /**
+         * Starts a burst read of graphics RAM. Returns false, meaning only
+         * readPixel is supported, unless hidden by Derived.
+         *
+         * @return Whether a burst was started.
+         */
+        [[gnu::always_inline]]
+        inline bool beginRead() {
+            return false;
+        }
+
+        /**
+         * Rotates the screen clockwise by the given number of quarter turns,
+         * recording the rotation and letting Derived map it onto the
+         * controller through applyRotation.
+         *
+         * @param rotation
+         */
+        [[gnu::always_inline]]
+        inline Derived *rotate(int rotation) {
+            mRotation = std::uint8_t(rotation & 3);
+            mHardwareRotation = derived()->applyRotation(mRotation) || !mRotation;
+            return derived();
+        }
+
+        /**
+         * Maps a rotation onto the controller. Returns false, leaving the
+         * rotation to software, unless hidden by Derived.
+         *
+         * @param rotation
+         * @return Whether the controller now applies the rotation.
+         */
+        [[gnu::always_inline]]
+        inline bool applyRotation(int) {
+            return false;
+        }
+
+        /**
+         * Gets the number of clockwise quarter turns the screen is rotated by.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline int rotation() const {
+            return mRotation;
+        }
+
+        /**
+         * Gets whether or not the logical width and height are swapped.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool rotated() const {
+            return mRotation & 1;
+        }
+
+        /**
+         * Gets whether or not the controller applies the current rotation.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool hardwareRotation() const {
+            return mHardwareRotation;
+        }
+
+        /**
+         * Defines the vertical scrolling area. A no-op unless hidden by
+         * Derived.
+         *
+         * @param top
+         * @param height
+         * @param bottom
+         */
+        [[gnu::always_inline]]
+        inline Derived *scrollArea(std::uint16_t, std::uint16_t, std::uint16_t) {
+            return derived();
+        }
+
+        /**
+         * Sets the vertical scrolling start address. A no-op unless hidden by
+         * Derived.
+         *
+         * @param start
+         */
+        [[gnu::always_inline]]
+        inline Derived *scroll(std::uint16_t) {
+            return derived();
+        }
+
+        /**
+         * Gets whether or not scrolling moves the picture. False unless hidden
+         * by Derived.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool scrollable() {
+            return false;
+        }
+
+        /**
+         * Defines the partial display area. A no-op unless hidden by Derived.
+         *
+         * @param start
+         * @param end
+         */
+        [[gnu::always_inline]]
+        inline Derived *partialArea(std::uint16_t, std::uint16_t) {
+            return derived();
+        }
+
+        /**
+         * Enters or leaves partial display mode. A no-op unless hidden by
+         * Derived.
+         *
+         * @param enabled
+         */
+        [[gnu::always_inline]]
+        inline Derived *partialMode(bool) {
+            return derived();
+        }
+
+        /**
+         * Turns the tearing effect output on or off. A no-op unless hidden by
+         * Derived.
+         *
+         * @param enabled
+         */
+        [[gnu::always_inline]]
+        inline Derived *tearingEffectOutput(bool) {
+            return derived();
+        }
+
+        /**
+         * Gets whether or not tearingEffect() reports the TE line. False
+         * unless hidden by Derived.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool hasTearingEffect() {
+            return false;
+        }
+
+        /**
+         * Polls the TE line. False unless hidden by Derived.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool tearingEffect() {
+            return false;
+        }
+
+        /**
+         * Places the logical width and height of the screen, which are
+         * swapped if rotated() returns true, into the given references.
+         *
+         * @param width
+         * @param height
+         */
+        [[gnu::always_inline]]
+        inline Derived *resolution(std::uint16_t &width, std::uint16_t &height) {
+            width = rotated() ? mHeight : mWidth;
+            height = rotated() ? mWidth : mHeight;
+            return derived();
+        }
+
+        /**
+         * Places the native, unrotated width and height of the screen into
+         * the given references.
+         *
+         * @param width
+         * @param height
+         */
+        [[gnu::always_inline]]
+        inline Derived *nativeResolution(std::uint16_t &width, std::uint16_t &height) {
+            width = mWidth;
+            height = mHeight;
+            return derived();
+        }
+    protected:
+        /**
+         * Initializes the width and height of the driver.
+         */
+        [[gnu::always_inline]]
+        inline StaticDriver(std::uint16_t width, std::uint16_t height) {
+            mHeight = height;
+            mWidth = width;
+            mRotation = 0;
+            mHardwareRotation = true;
+        }
+
+        std::uint16_t mHeight,
+                      mWidth;
+        std::uint8_t mRotation;
+        bool mHardwareRotation;
+    private:
+        [[gnu::always_inline]]
+        inline Derived *derived() {
+            return static_cast<Derived *>(this);
+        }
+    };
+
+    /**
+     * Presents a {@link StaticDriver} as a {@link Driver}, so that it may be
+     * passed to code that takes a Driver *.
+     *
+     * Every virtual forwards to the static driver in a single call, so the
+     * bulk methods keep their inlined loops and only pay one indirect call per
+     * transfer rather than one per pixel or byte.
+     *
+     * @tparam StaticDriverT
+     */
+    template<typename StaticDriverT>
+    class StaticDriverAdapter : public Driver {
+    public:
+        /**
+         * Wraps driver, which must outlive this adapter.
+         *
+         * @param driver
+         */
+        explicit StaticDriverAdapter(StaticDriverT &driver)
+            : Driver(0, 0), mDriver(driver) {
+            std::uint16_t width, height;
+            mDriver.nativeResolution(width, height);
+            mirror(width, height, StaticDriverT::WIRE_BYTE_ORDER, mDriver.rotation(), mDriver.hardwareRotation());
+            mCallback = nullptr;
+            mContext = nullptr;
+        }
+
+        bool initialize() override {
+            return mDriver.initialize();
+        }
+
+        Driver *select() override {
+            mDriver.select();
+            return this;
+        }
+
+        Driver *deselect() override {
+            mDriver.deselect();
+            return this;
+        }
+
+        Driver *assertCommand() override {
+            mDriver.assertCommand();
+            return this;
+        }
+
+        Driver *deassertCommand() override {
+            mDriver.deassertCommand();
+            return this;
+        }
+
+        Driver *writePixel(std::uint16_t color) override {
+            mDriver.writePixel(color);
+            return this;
+        }
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override {
+            mDriver.writePixels(count, data);
+            return this;
+        }
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override {
+            mDriver.writeRepeatedPixel(count, color);
+            return this;
+        }
+
+        Driver *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                 TransferCallback callback = nullptr, void *context = nullptr) override {
+            // The static driver calls back with itself, so the callback and
+            // context are held here and relayed with this adapter instead.
+            // Only one transfer is in flight at a time, so one slot suffices.
+            mDriver.wait();
+            mCallback = callback;
+            mContext = context;
+            mDriver.writePixelsAsync(count, data, callback ? &relay : nullptr, this);
+            return this;
+        }
+
+        bool poll() override {
+            return mDriver.poll();
+        }
+
+        Driver *wait() override {
+            mDriver.wait();
+            return this;
+        }
+
+        PixelFormat pixelFormat() override {
+            return mDriver.pixelFormat();
+        }
+
+        Driver *writeNativePixels(std::size_t count, const std::uint8_t *data) override {
+            mDriver.writeNativePixels(count, data);
+            return this;
+        }
+
+        Driver *writeRepeatedNativePixel(std::size_t count, std::uint32_t pixel) override {
+            mDriver.writeRepeatedNativePixel(count, pixel);
+            return this;
+        }
+
+        Driver *write(std::uint8_t u8) override {
+            mDriver.write(u8);
+            return this;
+        }
+
+        Driver *write16(std::uint16_t u16) override {
+            mDriver.write16(u16);
+            return this;
+        }
+
+        Driver *write32(std::uint32_t u32) override {
+            mDriver.write32(u32);
+            return this;
+        }
+
+        Driver *write64(std::uint64_t u64) override {
+            mDriver.write64(u64);
+            return this;
+        }
+
+        Driver *writeArray(std::size_t count, const std::uint8_t *data) override {
+            mDriver.writeArray(count, data);
+            return this;
+        }
+
+        Driver *writeArray16(std::size_t count, const std::uint16_t *data) override {
+            mDriver.writeArray16(count, data);
+            return this;
+        }
+
+        Driver *submit(std::size_t count, const std::uint8_t *data) override {
+            mDriver.submit(count, data);
+            return this;
+        }
+
+        Driver *pause(std::uint16_t milliseconds) override {
+            mDriver.pause(milliseconds);
+            return this;
+        }
+
+        std::uint16_t readPixel() override {
+            return mDriver.readPixel();
+        }
+
+        void readPixels(std::size_t count, std::uint16_t *data) override {
+            mDriver.readPixels(count, data);
+        }
+
+        std::uint8_t read() override {
+            return mDriver.read();
+        }
+
+        std::uint16_t read16() override {
+            return mDriver.read16();
+        }
+
+        std::uint32_t read32() override {
+            return mDriver.read32();
+        }
+
+        std::uint64_t read64() override {
+            return mDriver.read64();
+        }
+
+        void readArray(std::size_t count, std::uint8_t *data) override {
+            mDriver.readArray(count, data);
+        }
+
+        void readArray16(std::size_t count, std::uint16_t *data) override {
+            mDriver.readArray16(count, data);
+        }
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override {
+            mDriver.addressWindow(x1, y1, x2, y2);
+            return this;
+        }
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override {
+            mDriver.setAddressWindow(x1, y1, x2, y2);
+            return this;
+        }
+
+        bool beginRead() override {
+            return mDriver.beginRead();
+        }
+
+        Driver *scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) override {
+            mDriver.scrollArea(top, height, bottom);
+            return this;
+        }
+
+        Driver *scroll(std::uint16_t start) override {
+            mDriver.scroll(start);
+            return this;
+        }
+
+        bool scrollable() override {
+            return mDriver.scrollable();
+        }
+
+        Driver *partialArea(std::uint16_t start, std::uint16_t end) override {
+            mDriver.partialArea(start, end);
+            return this;
+        }
+
+        Driver *partialMode(bool enabled) override {
+            mDriver.partialMode(enabled);
+            return this;
+        }
+
+        Driver *tearingEffectOutput(bool enabled) override {
+            mDriver.tearingEffectOutput(enabled);
+            return this;
+        }
+
+        bool hasTearingEffect() override {
+            return mDriver.hasTearingEffect();
+        }
+
+        bool tearingEffect() override {
+            return mDriver.tearingEffect();
+        }
+
+        using Driver::writePixels;
+        using Driver::writeRepeatedPixel;
+        using Driver::writeArray;
+        using Driver::readPixels;
+        using Driver::readArray;
+        using Driver::addressWindow;
+    protected:
+        bool applyRotation(int rotation) override {
+            mDriver.rotate(rotation);
+            return mDriver.hardwareRotation();
+        }
+    private:
+        static void relay(StaticDriverT *, void *context) {
+            auto adapter = static_cast<StaticDriverAdapter *>(context);
+            adapter->mCallback(adapter, adapter->mContext);
+        }
+
+        StaticDriverT &mDriver;
+        TransferCallback mCallback;
+        void *mContext;
+    };
+}
+
+#endif//__Kempozer_Screen_StaticDriver_h__
@@ -0,0 +1,300 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstdint>
+#include <cstring>
+#include "Kempozer/Screen/TiledRenderer.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        /**
+         * Clips a signed, inclusive rectangle to a width by height screen.
+         */
+        bool clipped(std::int32_t x1, std::int32_t y1, std::int32_t x2, std::int32_t y2,
+                     std::uint16_t width, std::uint16_t height, Rect &rect) {
+            if (x1 > x2 || y1 > y2 || x2 < 0 || y2 < 0 || x1 >= width || y1 >= height) {
+                return false;
+            }
+            rect.x1 = std::uint16_t(x1 < 0 ? 0 : x1);
+            rect.y1 = std::uint16_t(y1 < 0 ? 0 : y1);
+            rect.x2 = std::uint16_t(x2 >= width ? width - 1 : x2);
+            rect.y2 = std::uint16_t(y2 >= height ? height - 1 : y2);
+            return true;
+        }
+
+        /**
+         * Gets the inclusive far edge of extent pixels starting at start.
+         * Returns false if it does not fit in a coordinate, since the wrapped
+         * edge would swap the bounds of the primitive.
+         */
+        [[gnu::always_inline]]
+        inline bool farEdge(std::int16_t start, std::int32_t extent, std::int16_t &edge) {
+            std::int32_t end = start + extent - 1;
+            if (end > INT16_MAX) {
+                return false;
+            }
+            edge = std::int16_t(end);
+            return true;
+        }
+
+        [[gnu::always_inline]]
+        inline std::int16_t coordinate(std::uint16_t value) {
+            return std::int16_t(value > INT16_MAX ? INT16_MAX : value);
+        }
+
+        [[gnu::always_inline]]
+        inline Rect intersection(const Rect &a, const Rect &b) {
+            return Rect{
+                a.x1 > b.x1 ? a.x1 : b.x1,
+                a.y1 > b.y1 ? a.y1 : b.y1,
+                a.x2 < b.x2 ? a.x2 : b.x2,
+                a.y2 < b.y2 ? a.y2 : b.y2,
+            };
+        }
+    }
+
+    TiledRenderer::TiledRenderer(Driver &driver, std::uint16_t width, std::uint16_t height,
+                                 std::uint16_t *tile, std::uint16_t tileWidth, std::uint16_t tileHeight,
+                                 Primitive *primitives, std::size_t capacity)
+        : mDriver(driver) {
+        mTile = tile;
+        mPrimitives = primitives;
+        mCapacity = capacity;
+        mCount = 0;
+        mWidth = width;
+        mHeight = height;
+        // A zero tile dimension could never advance over the screen, and
+        // clamping it up would overrun the caller's tile buffer.
+        bool empty = !tileWidth || !tileHeight;
+        mTileWidth = empty ? 0 : tileWidth;
+        mTileHeight = empty ? 0 : tileHeight;
+        mBackground = 0;
+    }
+
+    bool TiledRenderer::fillRect(Rect rect, std::uint16_t color) {
+        Primitive primitive{PrimitiveType::FillRect, false, color, 0, {},
+                            coordinate(rect.x1), coordinate(rect.y1),
+                            coordinate(rect.x2), coordinate(rect.y2), nullptr, nullptr};
+        return record(primitive);
+    }
+
+    bool TiledRenderer::line(std::int16_t x1, std::int16_t y1, std::int16_t x2, std::int16_t y2,
+                             std::uint16_t color) {
+        Primitive primitive{PrimitiveType::Line, false, color, 0, {}, x1, y1, x2, y2, nullptr, nullptr};
+        return record(primitive);
+    }
+
+    bool TiledRenderer::bitmap(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                               const std::uint16_t *pixels) {
+        Primitive primitive{PrimitiveType::Bitmap, false, 0, 0, {}, x, y, 0, 0, pixels, nullptr};
+        if (!width || !height) {
+            return true;
+        }
+        if (!farEdge(x, width, primitive.x2) || !farEdge(y, height, primitive.y2)) {
+            return false;
+        }
+        return record(primitive);
+    }
+
+    bool TiledRenderer::mask(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                             const std::uint8_t *bits, std::uint16_t color,
+                             std::uint16_t background, bool transparent) {
+        Primitive primitive{PrimitiveType::Mask, transparent, color, background, {}, x, y, 0, 0, bits, nullptr};
+        if (!width || !height) {
+            return true;
+        }
+        if (!farEdge(x, width, primitive.x2) || !farEdge(y, height, primitive.y2)) {
+            return false;
+        }
+        return record(primitive);
+    }
+
+    bool TiledRenderer::text(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                             std::uint16_t foreground, std::uint16_t background) {
+        // Glyphs are placed by walking the text from x, so text running past
+        // the last coordinate is simply cut off there.
+        std::int32_t width = 0;
+        for (const char *c = text; *c && x + width <= INT16_MAX; ++c) {
+            const Glyph *glyph = font.glyph(std::uint8_t(*c));
+            width += glyph ? glyph->advance : 0;
+        }
+        if (!width || !font.height) {
+            return true;
+        }
+        Primitive primitive{PrimitiveType::Text, false, foreground, background, {}, x, y,
+                            std::int16_t(x + width - 1 > INT16_MAX ? INT16_MAX : x + width - 1), 0, text, &font};
+        if (!farEdge(y, font.height, primitive.y2)) {
+            return false;
+        }
+        return record(primitive);
+    }
+
+    TiledRenderer *TiledRenderer::clear() {
+        mCount = 0;
+        return this;
+    }
+
+    TiledRenderer *TiledRenderer::render() {
+        return render(Rect{0, 0, std::uint16_t(mWidth - 1), std::uint16_t(mHeight - 1)});
+    }
+
+    TiledRenderer *TiledRenderer::render(Rect area) {
+        if (!mTileWidth || !area.clip(mWidth, mHeight)) {
+            return this;
+        }
+        for (std::uint32_t ty = area.y1; ty <= area.y2; ty += mTileHeight) {
+            for (std::uint32_t tx = area.x1; tx <= area.x2; tx += mTileWidth) {
+                std::uint32_t right = tx + mTileWidth - 1,
+                              bottom = ty + mTileHeight - 1;
+                Rect tile{std::uint16_t(tx), std::uint16_t(ty),
+                          std::uint16_t(right < area.x2 ? right : area.x2),
+                          std::uint16_t(bottom < area.y2 ? bottom : area.y2)};
+                std::size_t size = tile.area();
+                for (std::size_t i = 0; i < size; ++i) {
+                    mTile[i] = mBackground;
+                }
+                for (std::size_t i = 0; i < mCount; ++i) {
+                    if (mPrimitives[i].bounds.intersects(tile)) {
+                        rasterize(mPrimitives[i], tile);
+                    }
+                }
+                mDriver.setAddressWindow(tile.x1, tile.y1, tile.x2, tile.y2);
+                mDriver.writePixels(size, mTile);
+            }
+        }
+        return this;
+    }
+
+    bool TiledRenderer::record(const Primitive &primitive) {
+        if (mCount == mCapacity) {
+            return false;
+        }
+        Primitive &recorded = mPrimitives[mCount];
+        recorded = primitive;
+        std::int16_t minX = primitive.x1 < primitive.x2 ? primitive.x1 : primitive.x2,
+                     maxX = primitive.x1 < primitive.x2 ? primitive.x2 : primitive.x1,
+                     minY = primitive.y1 < primitive.y2 ? primitive.y1 : primitive.y2,
+                     maxY = primitive.y1 < primitive.y2 ? primitive.y2 : primitive.y1;
+        if (clipped(minX, minY, maxX, maxY, mWidth, mHeight, recorded.bounds)) {
+            ++mCount;
+        }
+        // Primitives that are entirely off screen are recorded successfully,
+        // they just never draw anything.
+        return true;
+    }
+
+    void TiledRenderer::rasterize(const Primitive &primitive, const Rect &tile) {
+        std::uint16_t stride = tile.width();
+        Rect area = intersection(primitive.bounds, tile);
+        switch (primitive.type) {
+            case PrimitiveType::FillRect:
+                for (std::uint16_t y = area.y1; y <= area.y2; ++y) {
+                    std::uint16_t *row = mTile + std::size_t(y - tile.y1) * stride;
+                    for (std::uint16_t x = area.x1; x <= area.x2; ++x) {
+                        row[x - tile.x1] = primitive.color;
+                    }
+                }
+                break;
+            case PrimitiveType::Bitmap: {
+                const std::uint16_t *pixels = static_cast<const std::uint16_t *>(primitive.data);
+                std::size_t width = std::size_t(primitive.x2 - primitive.x1 + 1);
+                for (std::uint16_t y = area.y1; y <= area.y2; ++y) {
+                    std::memcpy(mTile + std::size_t(y - tile.y1) * stride + (area.x1 - tile.x1),
+                                pixels + std::size_t(y - primitive.y1) * width + (area.x1 - primitive.x1),
+                                area.width() * sizeof(std::uint16_t));
+                }
+                break;
+            }
+            case PrimitiveType::Mask: {
+                const std::uint8_t *bits = static_cast<const std::uint8_t *>(primitive.data);
+                std::size_t bytesPerRow = (std::size_t(primitive.x2 - primitive.x1) + 8) / 8;
+                for (std::uint16_t y = area.y1; y <= area.y2; ++y) {
+                    const std::uint8_t *source = bits + std::size_t(y - primitive.y1) * bytesPerRow;
+                    std::uint16_t *row = mTile + std::size_t(y - tile.y1) * stride;
+                    for (std::uint16_t x = area.x1; x <= area.x2; ++x) {
+                        std::size_t bit = std::size_t(x - primitive.x1);
+                        if (source[bit >> 3] & (0x80 >> (bit & 7))) {
+                            row[x - tile.x1] = primitive.color;
+                        } else if (!primitive.transparent) {
+                            row[x - tile.x1] = primitive.background;
+                        }
+                    }
+                }
+                break;
+            }
+            case PrimitiveType::Text: {
+                const Font &font = *primitive.font;
+                std::uint16_t cell[256];
+                std::int32_t x = primitive.x1;
+                for (const char *c = static_cast<const char *>(primitive.data); *c && x <= area.x2; ++c) {
+                    const Glyph *glyph = font.glyph(std::uint8_t(*c));
+                    if (!glyph) {
+                        continue;
+                    }
+                    std::int32_t left = x > area.x1 ? x : area.x1,
+                                 right = x + glyph->advance - 1 < area.x2 ? x + glyph->advance - 1 : area.x2;
+                    for (std::uint16_t y = area.y1; left <= right && y <= area.y2; ++y) {
+                        rasterizeGlyph(font, *glyph, primitive.color, primitive.background,
+                                       std::uint16_t(y - primitive.y1), 1, cell);
+                        std::memcpy(mTile + std::size_t(y - tile.y1) * stride + (left - tile.x1),
+                                    cell + (left - x), std::size_t(right - left + 1) * sizeof(std::uint16_t));
+                    }
+                    x += glyph->advance;
+                }
+                break;
+            }
+            case PrimitiveType::Line: {
+                std::int32_t x = primitive.x1,
+                             y = primitive.y1,
+                             dx = primitive.x2 > x ? primitive.x2 - x : x - primitive.x2,
+                             dy = primitive.y2 > y ? y - primitive.y2 : primitive.y2 - y,
+                             sx = primitive.x2 > x ? 1 : -1,
+                             sy = primitive.y2 > y ? 1 : -1,
+                             error = dx + dy;
+                for (;;) {
+                    if (x >= area.x1 && x <= area.x2 && y >= area.y1 && y <= area.y2) {
+                        mTile[std::size_t(y - tile.y1) * stride + (x - tile.x1)] = primitive.color;
+                    }
+                    if (x == primitive.x2 && y == primitive.y2) {
+                        break;
+                    }
+                    std::int32_t doubled = 2 * error;
+                    if (doubled >= dy) {
+                        error += dy;
+                        x += sx;
+                    }
+                    if (doubled <= dx) {
+                        error += dx;
+                        y += sy;
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,269 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_TiledRenderer_h__
+#define __Kempozer_Screen_TiledRenderer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Font.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Renders a recorded list of draw primitives one tile at a time, so that
+     * a frame can be composited with framebuffer quality while only a single
+     * tile of pixels is ever held in memory. Each finished tile is sent with
+     * one {@link Driver::setAddressWindow} and one {@link Driver::writePixels}.
+     *
+     * Tiles may be full-width strips of rows (tileWidth equal to the screen
+     * width, which keeps each tile a single contiguous window) or arbitrary
+     * rectangles. Primitives are replayed in recording order, so later ones
+     * draw over earlier ones.
+     *
+     * Bitmaps, masks and text are referenced, not copied, and must remain
+     * valid until {@link render()} returns.
+     */
+    class TiledRenderer {
+    public:
+        /**
+         * The kind of a recorded primitive.
+         */
+        enum class PrimitiveType : std::uint8_t {
+            FillRect,
+            Line,
+            Bitmap,
+            Mask,
+            Text,
+        };
+
+        /**
+         * A recorded primitive. bounds is the clipped rectangle it may touch.
+         * font is only used by text.
+         */
+        struct Primitive {
+            PrimitiveType type;
+            bool transparent;
+            std::uint16_t color;
+            std::uint16_t background;
+            Rect bounds;
+            std::int16_t x1, y1, x2, y2;
+            const void *data;
+            const Font *font;
+        };
+
+        /**
+         * Creates a renderer for a width by height screen. The tile buffer
+         * must hold tileWidth * tileHeight pixels, and primitives must hold
+         * capacity primitives. The driver and both buffers must outlive this
+         * renderer. Tiles must be at least 1 by 1; a renderer given a zero
+         * tile width or height renders nothing.
+         *
+         * @param driver
+         * @param width
+         * @param height
+         * @param tile
+         * @param tileWidth
+         * @param tileHeight
+         * @param primitives
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        TiledRenderer(Driver &driver, std::uint16_t width, std::uint16_t height,
+                      std::uint16_t *tile, std::uint16_t tileWidth, std::uint16_t tileHeight,
+                      Primitive *primitives, std::size_t capacity);
+
+        /**
+         * Sets the color that tiles are cleared to before primitives are
+         * replayed into them.
+         *
+         * @param color
+         */
+        [[gnu::always_inline]]
+        inline TiledRenderer *background(std::uint16_t color) {
+            mBackground = color;
+            return this;
+        }
+
+        /**
+         * Records a filled rectangle.
+         *
+         * @param rect
+         * @param color
+         * @return Whether the primitive was recorded.
+         */
+        bool fillRect(Rect rect, std::uint16_t color);
+
+        /**
+         * Records a one pixel wide line from (x1, y1) to (x2, y2), inclusive.
+         *
+         * @param x1
+         * @param y1
+         * @param x2
+         * @param y2
+         * @param color
+         * @return Whether the primitive was recorded.
+         */
+        bool line(std::int16_t x1, std::int16_t y1, std::int16_t x2, std::int16_t y2, std::uint16_t color);
+
+        /**
+         * Records a width by height RGB565 bitmap with its top-left corner at
+         * (x, y).
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param height
+         * @param pixels
+         * @return Whether the primitive was recorded. False when the list is
+         *         full or the bitmap reaches past coordinate 32767.
+         */
+        [[gnu::nonnull]]
+        bool bitmap(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                    const std::uint16_t *pixels);
+
+        /**
+         * Records a width by height 1-bit mask, such as a glyph, with its
+         * top-left corner at (x, y). Each row starts on a byte boundary, with
+         * the most significant bit leftmost. Set bits are drawn in color and
+         * clear bits in background, unless transparent is true, in which case
+         * clear bits are left untouched.
+         *
+         * @param x
+         * @param y
+         * @param width
+         * @param height
+         * @param bits
+         * @param color
+         * @param background
+         * @param transparent
+         * @return Whether the primitive was recorded. False when the list is
+         *         full or the mask reaches past coordinate 32767.
+         */
+        [[gnu::nonnull]]
+        bool mask(std::int16_t x, std::int16_t y, std::uint16_t width, std::uint16_t height,
+                  const std::uint8_t *bits, std::uint16_t color,
+                  std::uint16_t background = 0, bool transparent = true);
+
+        /**
+         * Records a line of text in cells of font, with the top-left corner
+         * of its first cell at (x, y). Characters missing from the font are
+         * skipped, and text running past coordinate 32767 is cut off there.
+         *
+         * @param font
+         * @param x
+         * @param y
+         * @param text
+         * @param foreground
+         * @param background
+         * @return Whether the primitive was recorded. False when the list is
+         *         full or the cells reach below coordinate 32767.
+         */
+        [[gnu::nonnull]]
+        bool text(const Font &font, std::int16_t x, std::int16_t y, const char *text,
+                  std::uint16_t foreground, std::uint16_t background);
+
+        /**
+         * Forgets every recorded primitive.
+         */
+        TiledRenderer *clear();
+
+        /**
+         * Renders every tile of the screen and sends it to the driver.
+         */
+        TiledRenderer *render();
+
+        /**
+         * Renders the part of the screen inside area, in tiles starting at
+         * its top-left corner, and sends it to the driver.
+         *
+         * @param area
+         */
+        TiledRenderer *render(Rect area);
+
+        /**
+         * Gets the number of recorded primitives.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t size() const {
+            return mCount;
+        }
+
+        /**
+         * Gets a recorded primitive.
+         *
+         * @param index
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline const Primitive &primitive(std::size_t index) const {
+            return mPrimitives[index];
+        }
+
+        /**
+         * Gets the width of the screen.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t width() const {
+            return mWidth;
+        }
+
+        /**
+         * Gets the height of the screen.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint16_t height() const {
+            return mHeight;
+        }
+    private:
+        bool record(const Primitive &primitive);
+
+        void rasterize(const Primitive &primitive, const Rect &tile);
+
+        Driver &mDriver;
+        std::uint16_t *mTile;
+        Primitive *mPrimitives;
+        std::size_t mCapacity,
+                    mCount;
+        std::uint16_t mWidth,
+                      mHeight,
+                      mTileWidth,
+                      mTileHeight,
+                      mBackground;
+    };
+}
+
+#endif//__Kempozer_Screen_TiledRenderer_h__
@@ -0,0 +1,664 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cstring>
+#include "Kempozer/Screen/TraceDriver.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace Kempozer::Screen {
+    namespace {
+        /**
+         * How the arguments of an event are encoded after its timing.
+         */
+        enum class Shape : std::uint8_t {
+            None,
+            /**
+             * A little-endian value of size bytes.
+             */
+            Value,
+            /**
+             * A one byte result or argument that is not bus data.
+             */
+            Flag,
+            /**
+             * A varint element count, a varint count of stored elements, and
+             * the stored elements of size bytes each.
+             */
+            Array,
+            /**
+             * A varint element count; elements are size bytes each.
+             */
+            Count,
+            /**
+             * A varint pixel count and a 2-byte color.
+             */
+            Repeated,
+            /**
+             * size varint coordinates.
+             */
+            Arguments,
+            /**
+             * A varint number of milliseconds, which is not bus data.
+             */
+            Delay,
+        };
+
+        struct Layout {
+            Shape shape;
+            std::uint8_t size;
+        };
+
+        constexpr Layout LAYOUTS[] = {
+            {Shape::Flag, 1},
+            {Shape::None, 0},
+            {Shape::None, 0},
+            {Shape::None, 0},
+            {Shape::None, 0},
+            {Shape::Value, 1},
+            {Shape::Value, 2},
+            {Shape::Value, 4},
+            {Shape::Value, 8},
+            {Shape::Array, 1},
+            {Shape::Array, 2},
+            {Shape::Array, 1},
+            {Shape::Value, 2},
+            {Shape::Array, 2},
+            {Shape::Repeated, 2},
+            {Shape::None, 0},
+            {Shape::Flag, 1},
+            {Shape::Value, 1},
+            {Shape::Value, 2},
+            {Shape::Value, 4},
+            {Shape::Value, 8},
+            {Shape::Count, 1},
+            {Shape::Count, 2},
+            {Shape::Value, 2},
+            {Shape::Count, 2},
+            {Shape::Arguments, 4},
+            {Shape::Arguments, 3},
+            {Shape::Arguments, 1},
+            {Shape::Arguments, 2},
+            {Shape::Flag, 1},
+            {Shape::Flag, 1},
+            {Shape::Flag, 1},
+            {Shape::Delay, 0},
+        };
+
+        static_assert(sizeof(LAYOUTS) / sizeof(*LAYOUTS) == std::size_t(TraceEvent::Count),
+                      "every trace event needs a layout");
+
+        static_assert(KEMPOZER_SCREEN_TRACE_PAYLOAD >= 2 && KEMPOZER_SCREEN_TRACE_PAYLOAD <= 4096,
+                      "KEMPOZER_SCREEN_TRACE_PAYLOAD must be between 2 and 4096 bytes");
+
+        /**
+         * The largest encoded event: a type byte, four varints and a payload.
+         */
+        constexpr std::size_t MAX_EVENT = 1 + 4 * 5 + KEMPOZER_SCREEN_TRACE_PAYLOAD;
+
+#if defined(ARDUINO)
+        constexpr std::uint8_t TICK_UNIT = 0;
+#else
+        constexpr std::uint8_t TICK_UNIT = 1;
+#endif
+
+        [[gnu::always_inline]]
+        inline std::uint32_t now() {
+#if defined(ARDUINO)
+            return micros();
+#else
+            using Clock = std::chrono::steady_clock;
+            return std::uint32_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        void put32(std::uint8_t *out, std::uint32_t value) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                out[i] = std::uint8_t(value >> (8 * i));
+            }
+        }
+
+        /**
+         * Reads a varint of at most 5 bytes, failing if it runs past end.
+         */
+        bool varint(const std::uint8_t *&data, const std::uint8_t *end, std::uint32_t &value) {
+            value = 0;
+            for (std::size_t shift = 0; shift < 35; shift += 7) {
+                if (data == end) {
+                    return false;
+                }
+                std::uint8_t byte = *data++;
+                value |= std::uint32_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    struct TraceDriver::Encoder {
+        std::uint8_t bytes[MAX_EVENT];
+        std::size_t length = 0;
+
+        void byte(std::uint8_t u8) {
+            bytes[length++] = u8;
+        }
+
+        void varint(std::uint32_t value) {
+            while (value >= 0x80) {
+                byte(std::uint8_t(value) | 0x80);
+                value >>= 7;
+            }
+            byte(std::uint8_t(value));
+        }
+
+        void value(std::uint64_t value, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                byte(std::uint8_t(value >> (8 * i)));
+            }
+        }
+
+        void array(std::size_t count, const std::uint8_t *data) {
+            std::size_t stored = count < KEMPOZER_SCREEN_TRACE_PAYLOAD ? count : KEMPOZER_SCREEN_TRACE_PAYLOAD;
+            varint(std::uint32_t(count));
+            varint(std::uint32_t(stored));
+            std::memcpy(bytes + length, data, stored);
+            length += stored;
+        }
+
+        void array16(std::size_t count, const std::uint16_t *data) {
+            constexpr std::size_t LIMIT = KEMPOZER_SCREEN_TRACE_PAYLOAD / 2;
+            std::size_t stored = count < LIMIT ? count : LIMIT;
+            varint(std::uint32_t(count));
+            varint(std::uint32_t(stored));
+            for (std::size_t i = 0; i < stored; ++i) {
+                value(data[i], 2);
+            }
+        }
+    };
+
+    std::size_t TraceDriver::decode(std::size_t count, const std::uint8_t *data, TraceRecord &record) {
+        const std::uint8_t *cursor = data, *end = data + count;
+        if (cursor == end || *cursor >= std::uint8_t(TraceEvent::Count)) {
+            return 0;
+        }
+        record = TraceRecord{};
+        record.event = TraceEvent(*cursor++);
+        if (!varint(cursor, end, record.delta) || !varint(cursor, end, record.duration)) {
+            return 0;
+        }
+        const Layout &layout = LAYOUTS[std::size_t(record.event)];
+        std::uint32_t stored = 0;
+        switch (layout.shape) {
+            case Shape::None:
+                break;
+            case Shape::Flag:
+            case Shape::Value:
+                if (std::size_t(end - cursor) < layout.size) {
+                    return 0;
+                }
+                for (std::size_t i = 0; i < layout.size; ++i) {
+                    record.value |= std::uint64_t(*cursor++) << (8 * i);
+                }
+                record.bytes = layout.shape == Shape::Value ? layout.size : 0;
+                break;
+            case Shape::Array:
+                if (!varint(cursor, end, record.count) || !varint(cursor, end, stored)
+                    || stored > record.count || std::size_t(end - cursor) / layout.size < stored) {
+                    return 0;
+                }
+                record.stored = std::size_t(stored) * layout.size;
+                record.payload = cursor;
+                record.bytes = std::uint64_t(record.count) * layout.size;
+                cursor += record.stored;
+                break;
+            case Shape::Count:
+                if (!varint(cursor, end, record.count)) {
+                    return 0;
+                }
+                record.bytes = std::uint64_t(record.count) * layout.size;
+                break;
+            case Shape::Repeated:
+                if (!varint(cursor, end, record.count) || end - cursor < 2) {
+                    return 0;
+                }
+                record.value = std::uint64_t(cursor[0]) | std::uint64_t(cursor[1]) << 8;
+                record.bytes = std::uint64_t(record.count) * layout.size;
+                cursor += 2;
+                break;
+            case Shape::Arguments:
+                for (std::size_t i = 0; i < layout.size; ++i) {
+                    std::uint32_t argument;
+                    if (!varint(cursor, end, argument)) {
+                        return 0;
+                    }
+                    record.arguments[i] = std::uint16_t(argument);
+                }
+                record.bytes = 2 * layout.size;
+                break;
+            case Shape::Delay: {
+                std::uint32_t milliseconds;
+                if (!varint(cursor, end, milliseconds)) {
+                    return 0;
+                }
+                record.value = milliseconds;
+                break;
+            }
+        }
+        return std::size_t(cursor - data);
+    }
+
+    TraceDriver::TraceDriver(Driver &driver, std::uint8_t *storage, std::size_t capacity)
+        : Driver(0, 0), mDriver(driver) {
+        mirror(mDriver);
+        mBuffer = storage;
+        mCapacity = capacity;
+        mLast = now();
+        clear();
+    }
+
+    TraceDriver *TraceDriver::clear() {
+        mHead = 0;
+        mTail = 0;
+        mUsed = 0;
+        mBase = mLast;
+        mEvents = 0;
+        mDropped = 0;
+        return this;
+    }
+
+    std::size_t TraceDriver::save(std::uint8_t *out, std::size_t capacity) const {
+        std::size_t size = HEADER_SIZE + mUsed;
+        if (capacity < size) {
+            return size;
+        }
+        out[0] = 'K';
+        out[1] = 'S';
+        out[2] = 'T';
+        out[3] = 'R';
+        out[4] = VERSION;
+        out[5] = TICK_UNIT;
+        out[6] = 0;
+        out[7] = 0;
+        put32(out + 8, mBase);
+        put32(out + 12, std::uint32_t(mUsed));
+        put32(out + 16, mEvents);
+        put32(out + 20, mDropped);
+        std::size_t first = mCapacity - mTail < mUsed ? mCapacity - mTail : mUsed;
+        std::memcpy(out + HEADER_SIZE, mBuffer + mTail, first);
+        std::memcpy(out + HEADER_SIZE + first, mBuffer, mUsed - first);
+        return size;
+    }
+
+    bool TraceDriver::initialize() {
+        std::uint32_t start = now();
+        bool result = mDriver.initialize();
+        record(TraceEvent::Initialize, start, result);
+        return result;
+    }
+
+    Driver *TraceDriver::select() {
+        std::uint32_t start = now();
+        mDriver.select();
+        record(TraceEvent::Select, start);
+        return this;
+    }
+
+    Driver *TraceDriver::deselect() {
+        std::uint32_t start = now();
+        mDriver.deselect();
+        record(TraceEvent::Deselect, start);
+        return this;
+    }
+
+    Driver *TraceDriver::assertCommand() {
+        std::uint32_t start = now();
+        mDriver.assertCommand();
+        record(TraceEvent::AssertCommand, start);
+        return this;
+    }
+
+    Driver *TraceDriver::deassertCommand() {
+        std::uint32_t start = now();
+        mDriver.deassertCommand();
+        record(TraceEvent::DeassertCommand, start);
+        return this;
+    }
+
+    Driver *TraceDriver::writePixel(std::uint16_t color) {
+        std::uint32_t start = now();
+        mDriver.writePixel(color);
+        record(TraceEvent::WritePixel, start, color);
+        return this;
+    }
+
+    Driver *TraceDriver::writePixels(std::size_t count, const std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.writePixels(count, data);
+        Encoder encoder = begin(TraceEvent::WritePixels, start);
+        encoder.array16(count, data);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::writeRepeatedPixel(std::size_t count, const std::uint16_t color) {
+        std::uint32_t start = now();
+        mDriver.writeRepeatedPixel(count, color);
+        Encoder encoder = begin(TraceEvent::WriteRepeatedPixel, start);
+        encoder.varint(std::uint32_t(count));
+        encoder.value(color, 2);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                          TransferCallback callback, void *context) {
+        std::uint32_t start = now();
+        mDriver.writePixelsAsync(count, data, callback, context);
+        Encoder encoder = begin(TraceEvent::WritePixels, start);
+        encoder.array16(count, data);
+        push(encoder, start);
+        return this;
+    }
+
+    bool TraceDriver::poll() {
+        return mDriver.poll();
+    }
+
+    Driver *TraceDriver::wait() {
+        std::uint32_t start = now();
+        mDriver.wait();
+        record(TraceEvent::Wait, start);
+        return this;
+    }
+
+    Driver *TraceDriver::write(std::uint8_t u8) {
+        std::uint32_t start = now();
+        mDriver.write(u8);
+        record(TraceEvent::Write, start, u8);
+        return this;
+    }
+
+    Driver *TraceDriver::write16(std::uint16_t u16) {
+        std::uint32_t start = now();
+        mDriver.write16(u16);
+        record(TraceEvent::Write16, start, u16);
+        return this;
+    }
+
+    Driver *TraceDriver::write32(std::uint32_t u32) {
+        std::uint32_t start = now();
+        mDriver.write32(u32);
+        record(TraceEvent::Write32, start, u32);
+        return this;
+    }
+
+    Driver *TraceDriver::write64(std::uint64_t u64) {
+        std::uint32_t start = now();
+        mDriver.write64(u64);
+        record(TraceEvent::Write64, start, u64);
+        return this;
+    }
+
+    Driver *TraceDriver::writeArray(std::size_t count, const std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.writeArray(count, data);
+        Encoder encoder = begin(TraceEvent::WriteArray, start);
+        encoder.array(count, data);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::writeArray16(std::size_t count, const std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.writeArray16(count, data);
+        Encoder encoder = begin(TraceEvent::WriteArray16, start);
+        encoder.array16(count, data);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::submit(std::size_t count, const std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.submit(count, data);
+        Encoder encoder = begin(TraceEvent::Submit, start);
+        encoder.array(count, data);
+        push(encoder, start);
+        return this;
+    }
+
+    std::uint16_t TraceDriver::readPixel() {
+        std::uint32_t start = now();
+        std::uint16_t color = mDriver.readPixel();
+        record(TraceEvent::ReadPixel, start, color);
+        return color;
+    }
+
+    void TraceDriver::readPixels(std::size_t count, std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.readPixels(count, data);
+        Encoder encoder = begin(TraceEvent::ReadPixels, start);
+        encoder.varint(std::uint32_t(count));
+        push(encoder, start);
+    }
+
+    bool TraceDriver::beginRead() {
+        std::uint32_t start = now();
+        bool result = mDriver.beginRead();
+        record(TraceEvent::BeginRead, start, result);
+        return result;
+    }
+
+    std::uint8_t TraceDriver::read() {
+        std::uint32_t start = now();
+        std::uint8_t u8 = mDriver.read();
+        record(TraceEvent::Read, start, u8);
+        return u8;
+    }
+
+    std::uint16_t TraceDriver::read16() {
+        std::uint32_t start = now();
+        std::uint16_t u16 = mDriver.read16();
+        record(TraceEvent::Read16, start, u16);
+        return u16;
+    }
+
+    std::uint32_t TraceDriver::read32() {
+        std::uint32_t start = now();
+        std::uint32_t u32 = mDriver.read32();
+        record(TraceEvent::Read32, start, u32);
+        return u32;
+    }
+
+    std::uint64_t TraceDriver::read64() {
+        std::uint32_t start = now();
+        std::uint64_t u64 = mDriver.read64();
+        record(TraceEvent::Read64, start, u64);
+        return u64;
+    }
+
+    void TraceDriver::readArray(std::size_t count, std::uint8_t *data) {
+        std::uint32_t start = now();
+        mDriver.readArray(count, data);
+        Encoder encoder = begin(TraceEvent::ReadArray, start);
+        encoder.varint(std::uint32_t(count));
+        push(encoder, start);
+    }
+
+    void TraceDriver::readArray16(std::size_t count, std::uint16_t *data) {
+        std::uint32_t start = now();
+        mDriver.readArray16(count, data);
+        Encoder encoder = begin(TraceEvent::ReadArray16, start);
+        encoder.varint(std::uint32_t(count));
+        push(encoder, start);
+    }
+
+    Driver *TraceDriver::addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                                       std::uint16_t &x2, std::uint16_t &y2) {
+        mDriver.addressWindow(x1, y1, x2, y2);
+        return this;
+    }
+
+    Driver *TraceDriver::setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                          std::uint16_t x2, std::uint16_t y2) {
+        std::uint32_t start = now();
+        mDriver.setAddressWindow(x1, y1, x2, y2);
+        Encoder encoder = begin(TraceEvent::AddressWindow, start);
+        encoder.varint(x1);
+        encoder.varint(y1);
+        encoder.varint(x2);
+        encoder.varint(y2);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) {
+        std::uint32_t start = now();
+        mDriver.scrollArea(top, height, bottom);
+        Encoder encoder = begin(TraceEvent::ScrollArea, start);
+        encoder.varint(top);
+        encoder.varint(height);
+        encoder.varint(bottom);
+        push(encoder, start);
+        return this;
+    }
+
+    Driver *TraceDriver::scroll(std::uint16_t start) {
+        std::uint32_t time = now();
+        mDriver.scroll(start);
+        Encoder encoder = begin(TraceEvent::Scroll, time);
+        encoder.varint(start);
+        push(encoder, time);
+        return this;
+    }
+
+    bool TraceDriver::scrollable() {
+        return mDriver.scrollable();
+    }
+
+    Driver *TraceDriver::partialArea(std::uint16_t start, std::uint16_t end) {
+        std::uint32_t time = now();
+        mDriver.partialArea(start, end);
+        Encoder encoder = begin(TraceEvent::PartialArea, time);
+        encoder.varint(start);
+        encoder.varint(end);
+        push(encoder, time);
+        return this;
+    }
+
+    Driver *TraceDriver::partialMode(bool enabled) {
+        std::uint32_t start = now();
+        mDriver.partialMode(enabled);
+        record(TraceEvent::PartialMode, start, enabled);
+        return this;
+    }
+
+    Driver *TraceDriver::tearingEffectOutput(bool enabled) {
+        std::uint32_t start = now();
+        mDriver.tearingEffectOutput(enabled);
+        record(TraceEvent::TearingEffectOutput, start, enabled);
+        return this;
+    }
+
+    bool TraceDriver::hasTearingEffect() {
+        return mDriver.hasTearingEffect();
+    }
+
+    bool TraceDriver::tearingEffect() {
+        return mDriver.tearingEffect();
+    }
+
+    Driver *TraceDriver::pause(std::uint16_t milliseconds) {
+        std::uint32_t start = now();
+        mDriver.pause(milliseconds);
+        Encoder encoder = begin(TraceEvent::Pause, start);
+        encoder.varint(milliseconds);
+        push(encoder, start);
+        return this;
+    }
+
+    bool TraceDriver::applyRotation(int rotation) {
+        std::uint32_t start = now();
+        mDriver.rotate(rotation);
+        record(TraceEvent::Rotate, start, std::uint8_t(rotation));
+        return mDriver.hardwareRotation();
+    }
+
+    TraceDriver::Encoder TraceDriver::begin(TraceEvent event, std::uint32_t start) {
+        Encoder encoder;
+        encoder.byte(std::uint8_t(event));
+        encoder.varint(start - mLast);
+        encoder.varint(now() - start);
+        return encoder;
+    }
+
+    void TraceDriver::record(TraceEvent event, std::uint32_t start, std::uint64_t value) {
+        Encoder encoder = begin(event, start);
+        encoder.value(value, LAYOUTS[std::size_t(event)].size);
+        push(encoder, start);
+    }
+
+    void TraceDriver::push(const Encoder &encoder, std::uint32_t start) {
+        ++mEvents;
+        if (encoder.length > mCapacity) {
+            ++mDropped;
+            return;
+        }
+        while (mCapacity - mUsed < encoder.length) {
+            dropOldest();
+        }
+        std::size_t first = mCapacity - mHead < encoder.length ? mCapacity - mHead : encoder.length;
+        std::memcpy(mBuffer + mHead, encoder.bytes, first);
+        std::memcpy(mBuffer, encoder.bytes + first, encoder.length - first);
+        mHead = (mHead + encoder.length) % mCapacity;
+        mUsed += encoder.length;
+        mLast = start;
+    }
+
+    void TraceDriver::dropOldest() {
+        // The oldest event may wrap around the end of the buffer, so decode it
+        // from a linear copy.
+        std::uint8_t bytes[MAX_EVENT];
+        std::size_t count = mUsed < MAX_EVENT ? mUsed : MAX_EVENT;
+        std::size_t first = mCapacity - mTail < count ? mCapacity - mTail : count;
+        std::memcpy(bytes, mBuffer + mTail, first);
+        std::memcpy(bytes + first, mBuffer, count - first);
+        TraceRecord record;
+        std::size_t size = decode(count, bytes, record);
+        mBase += record.delta;
+        mTail = (mTail + size) % mCapacity;
+        mUsed -= size;
+        ++mDropped;
+    }
+}
@@ -0,0 +1,330 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_TraceDriver_h__
+#define __Kempozer_Screen_TraceDriver_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * The kinds of event in a bus trace, one per {@link Driver} call that
+     * reaches the bus. Asynchronous pixel writes are recorded as
+     * {@link WritePixels}, and the wait for them as {@link Wait}.
+     */
+    enum class TraceEvent : std::uint8_t {
+        Initialize,
+        Select,
+        Deselect,
+        AssertCommand,
+        DeassertCommand,
+        Write,
+        Write16,
+        Write32,
+        Write64,
+        WriteArray,
+        WriteArray16,
+        Submit,
+        WritePixel,
+        WritePixels,
+        WriteRepeatedPixel,
+        Wait,
+        BeginRead,
+        Read,
+        Read16,
+        Read32,
+        Read64,
+        ReadArray,
+        ReadArray16,
+        ReadPixel,
+        ReadPixels,
+        AddressWindow,
+        ScrollArea,
+        Scroll,
+        PartialArea,
+        PartialMode,
+        TearingEffectOutput,
+        Rotate,
+        Pause,
+        Count,
+    };
+
+    /**
+     * A decoded trace event. Times are in ticks of the trace clock:
+     * microseconds on Arduino, nanoseconds elsewhere.
+     *
+     * Which fields are meaningful depends on the event: value holds the
+     * value written or read, the pixel color, the boolean, result or
+     * rotation, or the milliseconds of a pause; count holds the length of
+     * an array or run; arguments holds the coordinates of address window,
+     * scroll and partial area events.
+     * Arrays keep at most KEMPOZER_SCREEN_TRACE_PAYLOAD bytes of their
+     * contents, stored bytes of which are at payload, little-endian for
+     * 16-bit arrays. bytes is the amount of data the call moved.
+     *
+     * delta is the time since the previous event started; start is filled
+     * in by {@link TraceReplayer} as the time since the first event of the
+     * trace started.
+     */
+    struct TraceRecord {
+        TraceEvent event;
+        std::uint32_t delta;
+        std::uint32_t duration;
+        std::uint64_t start;
+        std::uint64_t bytes;
+        std::uint64_t value;
+        std::uint32_t count;
+        std::uint16_t arguments[4];
+        std::size_t stored;
+        const std::uint8_t *payload;
+    };
+
+    /**
+     * A driver that wraps another and records every call that reaches the
+     * bus into a ring buffer, for later analysis or replay on a host with
+     * {@link TraceReplayer}.
+     *
+     * Each event is a type byte, the ticks since the previous event and the
+     * ticks the call took as LEB128 varints, then the event's arguments;
+     * most events take two to four bytes. When the buffer is full the oldest
+     * events are dropped. {@link save(std::uint8_t *, std::size_t)} writes
+     * the retained events out behind a small header, in the format that
+     * TraceReplayer reads.
+     *
+     * The trace records RGB565 pixels: this driver keeps the default
+     * {@link pixelFormat()}, so pixels of other formats are converted before
+     * they are recorded.
+     *
+     * Like {@link InstrumentedDriver}, it leaves asynchronous completions
+     * and byte order to the wrapped driver.
+     */
+    class TraceDriver : public Driver {
+    public:
+        static constexpr std::uint8_t VERSION = 1;
+        static constexpr std::size_t HEADER_SIZE = 24;
+
+        /**
+         * Decodes the event at the start of data.
+         *
+         * @param count
+         * @param data
+         * @param record
+         * @return The number of bytes occupied by the event, or 0 if data
+         *         does not start with a complete event.
+         */
+        [[gnu::nonnull]]
+        static std::size_t decode(std::size_t count, const std::uint8_t *data, TraceRecord &record);
+
+        /**
+         * Wraps driver, recording into storage. Both must outlive this
+         * driver.
+         *
+         * @param driver
+         * @param storage
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        TraceDriver(Driver &driver, std::uint8_t *storage, std::size_t capacity);
+
+        /**
+         * Gets the number of events recorded since construction or the last
+         * call to {@link clear()}, including dropped ones.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t events() const {
+            return mEvents;
+        }
+
+        /**
+         * Gets the number of events dropped to make room for newer ones.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t dropped() const {
+            return mDropped;
+        }
+
+        /**
+         * Gets the number of bytes of the ring buffer in use.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t size() const {
+            return mUsed;
+        }
+
+        /**
+         * Forgets every recorded event.
+         */
+        TraceDriver *clear();
+
+        /**
+         * Writes the header and the retained events, oldest first, into out.
+         * Nothing is written if they do not fit, so out may be null when
+         * capacity is 0.
+         *
+         * @param out
+         * @param capacity
+         * @return The size of the saved trace.
+         */
+        std::size_t save(std::uint8_t *out, std::size_t capacity) const;
+
+        bool initialize() override;
+
+        Driver *select() override;
+
+        Driver *deselect() override;
+
+        Driver *assertCommand() override;
+
+        Driver *deassertCommand() override;
+
+        Driver *writePixel(std::uint16_t color) override;
+
+        Driver *writePixels(std::size_t count, const std::uint16_t *data) override;
+
+        Driver *writeRepeatedPixel(std::size_t count, const std::uint16_t color) override;
+
+        [[gnu::nonnull(3)]]
+        Driver *writePixelsAsync(std::size_t count, const std::uint16_t *data,
+                                 TransferCallback callback = nullptr, void *context = nullptr) override;
+
+        bool poll() override;
+
+        Driver *wait() override;
+
+        Driver *write(std::uint8_t u8) override;
+
+        Driver *write16(std::uint16_t u16) override;
+
+        Driver *write32(std::uint32_t u32) override;
+
+        Driver *write64(std::uint64_t u64) override;
+
+        Driver *writeArray(std::size_t count, const std::uint8_t *data) override;
+
+        Driver *writeArray16(std::size_t count, const std::uint16_t *data) override;
+
+        Driver *submit(std::size_t count, const std::uint8_t *data) override;
+
+        std::uint16_t readPixel() override;
+
+        void readPixels(std::size_t count, std::uint16_t *data) override;
+
+        bool beginRead() override;
+
+        std::uint8_t read() override;
+
+        std::uint16_t read16() override;
+
+        std::uint32_t read32() override;
+
+        std::uint64_t read64() override;
+
+        void readArray(std::size_t count, std::uint8_t *data) override;
+
+        void readArray16(std::size_t count, std::uint16_t *data) override;
+
+        Driver *addressWindow(std::uint16_t &x1, std::uint16_t &y1,
+                              std::uint16_t &x2, std::uint16_t &y2) override;
+
+        Driver *setAddressWindow(std::uint16_t x1, std::uint16_t y1,
+                                 std::uint16_t x2, std::uint16_t y2) override;
+
+        Driver *scrollArea(std::uint16_t top, std::uint16_t height, std::uint16_t bottom) override;
+
+        Driver *scroll(std::uint16_t start) override;
+
+        bool scrollable() override;
+
+        Driver *partialArea(std::uint16_t start, std::uint16_t end) override;
+
+        Driver *partialMode(bool enabled) override;
+
+        Driver *tearingEffectOutput(bool enabled) override;
+
+        bool hasTearingEffect() override;
+
+        bool tearingEffect() override;
+
+        Driver *pause(std::uint16_t milliseconds) override;
+
+        using Driver::writePixels;
+        using Driver::writeArray;
+        using Driver::readPixels;
+        using Driver::readArray;
+        using Driver::addressWindow;
+    protected:
+        bool applyRotation(int rotation) override;
+    private:
+        struct Encoder;
+
+        Encoder begin(TraceEvent event, std::uint32_t start);
+
+        void record(TraceEvent event, std::uint32_t start, std::uint64_t value = 0);
+
+        void push(const Encoder &encoder, std::uint32_t start);
+
+        void dropOldest();
+
+        Driver &mDriver;
+        std::uint8_t *mBuffer;
+        std::size_t mCapacity,
+                    mHead,
+                    mTail,
+                    mUsed;
+        std::uint32_t mBase,
+                      mLast,
+                      mEvents,
+                      mDropped;
+    };
+
+    /**
+     * A {@link TraceDriver} that owns its ring buffer.
+     *
+     * @tparam Capacity
+     */
+    template<std::size_t Capacity>
+    class StaticTraceDriver : public TraceDriver {
+    public:
+        explicit StaticTraceDriver(Driver &driver)
+            : TraceDriver(driver, mStorage, Capacity) {}
+    private:
+        std::uint8_t mStorage[Capacity];
+    };
+}
+
+#endif//__Kempozer_Screen_TraceDriver_h__
@@ -0,0 +1,307 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/TraceReplayer.h"
+#include "Kempozer/Screen/CommandBuffer.h"
+
+namespace Kempozer::Screen {
+    namespace {
+        constexpr const char *EVENT_NAMES[] = {
+            "initialize",
+            "select",
+            "deselect",
+            "assert-command",
+            "deassert-command",
+            "write",
+            "write16",
+            "write32",
+            "write64",
+            "write-array",
+            "write-array16",
+            "submit",
+            "write-pixel",
+            "write-pixels",
+            "write-repeated-pixel",
+            "wait",
+            "begin-read",
+            "read",
+            "read16",
+            "read32",
+            "read64",
+            "read-array",
+            "read-array16",
+            "read-pixel",
+            "read-pixels",
+            "address-window",
+            "scroll-area",
+            "scroll",
+            "partial-area",
+            "partial-mode",
+            "tearing-effect-output",
+            "rotate",
+            "pause",
+        };
+
+        static_assert(sizeof(EVENT_NAMES) / sizeof(*EVENT_NAMES) == std::size_t(TraceEvent::Count),
+                      "every trace event needs a name");
+
+        constexpr std::size_t CHUNK = KEMPOZER_SCREEN_TRACE_PAYLOAD / 2;
+
+        std::uint32_t get32(const std::uint8_t *in) {
+            return std::uint32_t(in[0]) | std::uint32_t(in[1]) << 8
+                | std::uint32_t(in[2]) << 16 | std::uint32_t(in[3]) << 24;
+        }
+
+        /**
+         * Sends count elements of which the first stored are known, as runs
+         * of at most stored elements.
+         */
+        template<typename SendT>
+        void repeat(std::size_t count, std::size_t stored, SendT send) {
+            if (!stored) {
+                return;
+            }
+            for (std::size_t offset = 0; offset < count; offset += stored) {
+                send(count - offset < stored ? count - offset : stored);
+            }
+        }
+    }
+
+    const char *TraceReplayer::name(TraceEvent event) {
+        return event < TraceEvent::Count ? EVENT_NAMES[std::size_t(event)] : "unknown";
+    }
+
+    TraceReplayer::TraceReplayer(const std::uint8_t *trace, std::size_t size) {
+        mValid = size >= TraceDriver::HEADER_SIZE
+            && trace[0] == 'K' && trace[1] == 'S' && trace[2] == 'T' && trace[3] == 'R'
+            && trace[4] == TraceDriver::VERSION && trace[5] <= 1
+            && get32(trace + 12) <= size - TraceDriver::HEADER_SIZE;
+        mEvents = trace + TraceDriver::HEADER_SIZE;
+        mSize = mValid ? get32(trace + 12) : 0;
+        mNanoseconds = mValid && trace[5] == 1;
+        mRecorded = mValid ? get32(trace + 16) : 0;
+        mDropped = mValid ? get32(trace + 20) : 0;
+        rewind();
+    }
+
+    TraceReplayer *TraceReplayer::rewind() {
+        mOffset = 0;
+        mTime = 0;
+        mFirst = true;
+        return this;
+    }
+
+    bool TraceReplayer::next(TraceRecord &record) {
+        std::size_t size = TraceDriver::decode(mSize - mOffset, mEvents + mOffset, record);
+        if (!size) {
+            mOffset = mSize;
+            return false;
+        }
+        mOffset += size;
+        // The first event is the origin of the trace; the delta to whatever
+        // preceded it was lost when the trace was recorded or trimmed.
+        if (!mFirst) {
+            mTime += record.delta;
+        }
+        mFirst = false;
+        record.start = mTime;
+        return true;
+    }
+
+    void TraceReplayer::replay(const TraceRecord &record, Driver &driver) {
+        std::uint16_t words[CHUNK];
+        std::uint8_t bytes[KEMPOZER_SCREEN_TRACE_PAYLOAD];
+        switch (record.event) {
+            case TraceEvent::Initialize:
+                driver.initialize();
+                break;
+            case TraceEvent::Select:
+                driver.select();
+                break;
+            case TraceEvent::Deselect:
+                driver.deselect();
+                break;
+            case TraceEvent::AssertCommand:
+                driver.assertCommand();
+                break;
+            case TraceEvent::DeassertCommand:
+                driver.deassertCommand();
+                break;
+            case TraceEvent::Write:
+                driver.write(std::uint8_t(record.value));
+                break;
+            case TraceEvent::Write16:
+                driver.write16(std::uint16_t(record.value));
+                break;
+            case TraceEvent::Write32:
+                driver.write32(std::uint32_t(record.value));
+                break;
+            case TraceEvent::Write64:
+                driver.write64(record.value);
+                break;
+            case TraceEvent::WriteArray:
+                repeat(record.count, record.stored, [&](std::size_t count) {
+                    driver.writeArray(count, record.payload);
+                });
+                break;
+            case TraceEvent::Submit: {
+                if (record.stored == record.count) {
+                    driver.submit(record.count, record.payload);
+                    break;
+                }
+                // Only the whole records of the prefix are known; the rest of
+                // the batch goes out as raw bytes of the same length rather
+                // than as records decoded from a repeated prefix.
+                CommandBuffer::Record batch;
+                std::size_t known = 0;
+                while (std::size_t size = CommandBuffer::decode(record.stored - known, record.payload + known, batch)) {
+                    known += size;
+                }
+                if (known) {
+                    driver.submit(known, record.payload);
+                }
+                std::uint8_t filler[KEMPOZER_SCREEN_TRACE_PAYLOAD] = {};
+                repeat(record.count - known, sizeof(filler), [&](std::size_t count) {
+                    driver.writeArray(count, filler);
+                });
+                break;
+            }
+            case TraceEvent::WriteArray16:
+            case TraceEvent::WritePixels:
+                for (std::size_t i = 0; i < record.stored / 2; ++i) {
+                    words[i] = std::uint16_t(record.payload[2 * i] | record.payload[2 * i + 1] << 8);
+                }
+                repeat(record.count, record.stored / 2, [&](std::size_t count) {
+                    if (record.event == TraceEvent::WritePixels) {
+                        driver.writePixels(count, words);
+                    } else {
+                        driver.writeArray16(count, words);
+                    }
+                });
+                break;
+            case TraceEvent::WritePixel:
+                driver.writePixel(std::uint16_t(record.value));
+                break;
+            case TraceEvent::WriteRepeatedPixel:
+                driver.writeRepeatedPixel(record.count, std::uint16_t(record.value));
+                break;
+            case TraceEvent::Wait:
+                driver.wait();
+                break;
+            case TraceEvent::BeginRead:
+                driver.beginRead();
+                break;
+            case TraceEvent::Read:
+                driver.read();
+                break;
+            case TraceEvent::Read16:
+                driver.read16();
+                break;
+            case TraceEvent::Read32:
+                driver.read32();
+                break;
+            case TraceEvent::Read64:
+                driver.read64();
+                break;
+            case TraceEvent::ReadArray:
+                repeat(record.count, sizeof(bytes), [&](std::size_t count) {
+                    driver.readArray(count, bytes);
+                });
+                break;
+            case TraceEvent::ReadArray16:
+                repeat(record.count, CHUNK, [&](std::size_t count) {
+                    driver.readArray16(count, words);
+                });
+                break;
+            case TraceEvent::ReadPixel:
+                driver.readPixel();
+                break;
+            case TraceEvent::ReadPixels:
+                repeat(record.count, CHUNK, [&](std::size_t count) {
+                    driver.readPixels(count, words);
+                });
+                break;
+            case TraceEvent::AddressWindow:
+                driver.setAddressWindow(record.arguments[0], record.arguments[1],
+                                        record.arguments[2], record.arguments[3]);
+                break;
+            case TraceEvent::ScrollArea:
+                driver.scrollArea(record.arguments[0], record.arguments[1], record.arguments[2]);
+                break;
+            case TraceEvent::Scroll:
+                driver.scroll(record.arguments[0]);
+                break;
+            case TraceEvent::PartialArea:
+                driver.partialArea(record.arguments[0], record.arguments[1]);
+                break;
+            case TraceEvent::PartialMode:
+                driver.partialMode(record.value != 0);
+                break;
+            case TraceEvent::TearingEffectOutput:
+                driver.tearingEffectOutput(record.value != 0);
+                break;
+            case TraceEvent::Rotate:
+                driver.rotate(int(record.value));
+                break;
+            case TraceEvent::Pause:
+                driver.pause(std::uint16_t(record.value));
+                break;
+            case TraceEvent::Count:
+                break;
+        }
+    }
+
+    std::uint32_t TraceReplayer::replay(Driver &driver) {
+        std::uint32_t count = 0;
+        TraceRecord record;
+        while (next(record)) {
+            replay(record, driver);
+            ++count;
+        }
+        return count;
+    }
+
+    TraceReplayer::Summary TraceReplayer::summarize() const {
+        Summary summary{};
+        TraceReplayer reader(*this);
+        reader.rewind();
+        TraceRecord record;
+        while (reader.next(record)) {
+            std::size_t index = std::size_t(record.event);
+            ++summary.events;
+            ++summary.calls[index];
+            summary.ticks[index] += record.duration;
+            summary.busy += record.duration;
+            summary.bytes += record.bytes;
+            if (record.start + record.duration > summary.span) {
+                summary.span = record.start + record.duration;
+            }
+        }
+        return summary;
+    }
+}
@@ -0,0 +1,201 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __Kempozer_Screen_TraceReplayer_h__
+#define __Kempozer_Screen_TraceReplayer_h__
+
+#include <cstddef>
+#include <cstdint>
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/TraceDriver.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * Reads a trace saved by {@link TraceDriver::save(std::uint8_t *, std::size_t)}
+     * and replays it into any driver, so that a session recorded on a device
+     * can be reproduced and measured on a host.
+     *
+     * Replaying makes the same calls, with the same arguments, in the same
+     * order as the recorded session. Only the first
+     * KEMPOZER_SCREEN_TRACE_PAYLOAD bytes of an array are recorded, so the
+     * content replayed beyond that prefix is synthetic: writePixels,
+     * writeArray16 and writeArray calls are sent as several calls that
+     * repeat the prefix, and a submitted batch is submitted up to the last
+     * whole record of its prefix, with the rest sent as zero bytes through
+     * writeArray. The traffic is the same size either way, but the picture
+     * and the commands are only reproduced exactly when the trace was
+     * recorded with a KEMPOZER_SCREEN_TRACE_PAYLOAD large enough for every
+     * array. Reads are made in chunks of the same size, and the values they
+     * return are discarded.
+     */
+    class TraceReplayer {
+    public:
+        /**
+         * The totals of a trace, in ticks of its clock.
+         */
+        struct Summary {
+            std::uint32_t events;
+            /**
+             * The time from the start of the first event to the end of the
+             * last.
+             */
+            std::uint64_t span;
+            /**
+             * The time spent inside driver calls.
+             */
+            std::uint64_t busy;
+            std::uint64_t bytes;
+            std::uint32_t calls[std::size_t(TraceEvent::Count)];
+            std::uint64_t ticks[std::size_t(TraceEvent::Count)];
+        };
+
+        /**
+         * Gets the name of an event, as used in reports.
+         *
+         * @param event
+         * @return
+         */
+        static const char *name(TraceEvent event);
+
+        /**
+         * Reads the trace in the first size bytes of trace, which must
+         * outlive this replayer.
+         *
+         * @param trace
+         * @param size
+         */
+        [[gnu::nonnull]]
+        TraceReplayer(const std::uint8_t *trace, std::size_t size);
+
+        /**
+         * Gets whether or not the header of the trace is one this replayer
+         * understands.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool valid() const {
+            return mValid;
+        }
+
+        /**
+         * Gets whether the trace was timed in nanoseconds, rather than in
+         * microseconds.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool nanoseconds() const {
+            return mNanoseconds;
+        }
+
+        /**
+         * Gets the number of events recorded, including those the recorder
+         * dropped before the trace was saved.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t recorded() const {
+            return mRecorded;
+        }
+
+        /**
+         * Gets the number of events the recorder dropped.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::uint32_t dropped() const {
+            return mDropped;
+        }
+
+        /**
+         * Goes back to the first event.
+         */
+        TraceReplayer *rewind();
+
+        /**
+         * Decodes the next event.
+         *
+         * @param record
+         * @return false at the end of the trace, or if the rest of it is
+         *         malformed.
+         */
+        bool next(TraceRecord &record);
+
+        /**
+         * Makes the call an event records on driver.
+         *
+         * @param record
+         * @param driver
+         */
+        static void replay(const TraceRecord &record, Driver &driver);
+
+        /**
+         * Replays every remaining event on driver.
+         *
+         * @param driver
+         * @return The number of events replayed.
+         */
+        std::uint32_t replay(Driver &driver);
+
+        /**
+         * Totals every event of the trace, without disturbing the current
+         * position.
+         *
+         * @return
+         */
+        Summary summarize() const;
+
+        /**
+         * Gets the fraction of the span of a trace spent inside driver
+         * calls.
+         *
+         * @param summary
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline static float utilisation(const Summary &summary) {
+            return summary.span ? float(summary.busy) / float(summary.span) : 0.0f;
+        }
+    private:
+        const std::uint8_t *mEvents;
+        std::size_t mSize,
+                    mOffset;
+        std::uint64_t mTime;
+        std::uint32_t mRecorded,
+                      mDropped;
+        bool mValid,
+             mNanoseconds,
+             mFirst;
+    };
+}
+
+#endif//__Kempozer_Screen_TraceReplayer_h__
@@ -0,0 +1,74 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/TransferQueue.h"
+
+namespace Kempozer::Screen {
+    TransferQueue::TransferQueue(TransferJob *storage, std::size_t capacity) {
+        mJobs = storage;
+        // Keep only the highest set bit so the mask covers whole slots.
+        while (capacity & (capacity - 1)) {
+            capacity &= capacity - 1;
+        }
+        mCapacity = capacity;
+        mMask = capacity ? capacity - 1 : 0;
+        mHead.store(0, std::memory_order_relaxed);
+        mCachedTail = 0;
+        mTail.store(0, std::memory_order_relaxed);
+        mCachedHead = 0;
+    }
+
+    bool TransferQueue::push(const TransferJob &job) {
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mCachedTail >= mCapacity) {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head - mCachedTail >= mCapacity) {
+                return false;
+            }
+        }
+        mJobs[head & mMask] = job;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    const TransferJob *TransferQueue::front() {
+        std::size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mCachedHead) {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail == mCachedHead) {
+                return nullptr;
+            }
+        }
+        return &mJobs[tail & mMask];
+    }
+
+    TransferQueue *TransferQueue::pop() {
+        mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return this;
+    }
+}
@@ -0,0 +1,249 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __Kempozer_Screen_TransferQueue_h__
+#define __Kempozer_Screen_TransferQueue_h__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Types.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * A unit of work for the {@link Driver} owned by a {@link TransferWorker}.
+     *
+     * Jobs refer to their pixels and commands rather than copying them, so
+     * the memory a job points at must stay untouched until the job is done.
+     */
+    struct TransferJob {
+        /**
+         * Runs arbitrary drawing code on the driver, between its
+         * {@link Driver::select()} and {@link Driver::deselect()}.
+         */
+        using Function = void (*)(Driver &driver, void *context);
+
+        enum class Kind : std::uint8_t {
+            /**
+             * Sends rect.area() pixels from data into rect.
+             */
+            Pixels,
+            /**
+             * Fills rect with color.
+             */
+            Fill,
+            /**
+             * Hands count bytes of {@link CommandBuffer} records at data to
+             * {@link Driver::submit}.
+             */
+            Submit,
+            /**
+             * Calls function with the driver and context.
+             */
+            Call,
+        };
+
+        Kind kind;
+        Rect rect;
+        std::uint16_t color;
+        std::size_t count;
+        const void *data;
+        Function function;
+        void *context;
+
+        /**
+         * Creates a job that sends rect.area() pixels into rect.
+         *
+         * @param rect
+         * @param pixels
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline static TransferJob pixels(Rect rect, const std::uint16_t *pixels) {
+            return TransferJob{Kind::Pixels, rect, 0, rect.area(), pixels, nullptr, nullptr};
+        }
+
+        /**
+         * Creates a job that fills rect with color.
+         *
+         * @param rect
+         * @param color
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline static TransferJob fill(Rect rect, std::uint16_t color) {
+            return TransferJob{Kind::Fill, rect, color, rect.area(), nullptr, nullptr, nullptr};
+        }
+
+        /**
+         * Creates a job that submits count bytes of command buffer records.
+         *
+         * @param count
+         * @param data
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline static TransferJob submit(std::size_t count, const std::uint8_t *data) {
+            return TransferJob{Kind::Submit, Rect{}, 0, count, data, nullptr, nullptr};
+        }
+
+        /**
+         * Creates a job that calls function with the driver and context.
+         *
+         * @param function
+         * @param context
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline static TransferJob call(Function function, void *context) {
+            return TransferJob{Kind::Call, Rect{}, 0, 0, nullptr, function, context};
+        }
+    };
+
+    /**
+     * A lock-free, bounded, single-producer single-consumer queue of
+     * {@link TransferJob}s.
+     *
+     * One thread, core or interrupt handler may {@link push} while another
+     * takes jobs with {@link front()} and {@link pop()}. A job keeps its slot
+     * until it is popped, so the consumer pops a job only once it is done,
+     * and the count of {@link popped()} jobs tells the producer which of its
+     * buffers are free again.
+     *
+     * The read and write positions are free-running counters, each on its
+     * own KEMPOZER_SCREEN_CACHE_LINE, and each side keeps a private copy of
+     * the other side's position so that it only touches the shared one when
+     * the queue looks full or empty.
+     */
+    class TransferQueue {
+    public:
+        /**
+         * Creates a queue of capacity jobs in storage, which must outlive the
+         * queue. The ring is indexed with a mask, so capacity is rounded down
+         * to a power of two and the rest of storage goes unused; a capacity of
+         * 0 gives a queue that is always full.
+         *
+         * @param storage
+         * @param capacity
+         */
+        [[gnu::nonnull]]
+        TransferQueue(TransferJob *storage, std::size_t capacity);
+
+        TransferQueue(const TransferQueue &) = delete;
+
+        TransferQueue &operator=(const TransferQueue &) = delete;
+
+        /**
+         * Appends a job. Producer only.
+         *
+         * @param job
+         * @return Whether there was room for the job.
+         */
+        bool push(const TransferJob &job);
+
+        /**
+         * Gets the oldest job, or nullptr when the queue is empty. Consumer
+         * only.
+         *
+         * @return
+         */
+        const TransferJob *front();
+
+        /**
+         * Releases the job returned by {@link front()}. Consumer only.
+         */
+        TransferQueue *pop();
+
+        /**
+         * Gets the number of jobs pushed since construction, which is the
+         * ticket of the last pushed job.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t pushed() const {
+            return mHead.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Gets the number of jobs popped since construction.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t popped() const {
+            return mTail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Gets the number of jobs in the queue. The answer may be stale by
+         * the time it is used unless called from the producer or consumer
+         * while the other is idle.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline std::size_t size() const {
+            return pushed() - popped();
+        }
+
+        [[gnu::always_inline]]
+        inline std::size_t capacity() const {
+            return mCapacity;
+        }
+    private:
+        TransferJob *mJobs;
+        std::size_t mCapacity;
+        std::size_t mMask;
+        alignas(KEMPOZER_SCREEN_CACHE_LINE) std::atomic<std::size_t> mHead;
+        std::size_t mCachedTail;
+        alignas(KEMPOZER_SCREEN_CACHE_LINE) std::atomic<std::size_t> mTail;
+        std::size_t mCachedHead;
+    };
+
+    /**
+     * A {@link TransferQueue} that owns the storage of Capacity jobs.
+     *
+     * @tparam Capacity
+     */
+    template<std::size_t Capacity>
+    class StaticTransferQueue : public TransferQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    public:
+        StaticTransferQueue()
+            : TransferQueue(mStorage, Capacity) {}
+    private:
+        TransferJob mStorage[Capacity];
+    };
+}
+
+#endif//__Kempozer_Screen_TransferQueue_h__
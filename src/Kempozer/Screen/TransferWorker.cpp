@@ -0,0 +1,189 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "Kempozer/Screen/TransferWorker.h"
+
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+#include <chrono>
+#include <thread>
+#endif
+
+namespace Kempozer::Screen {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+    struct TransferWorker::Thread {
+        std::atomic<bool> stopping{false};
+        std::thread thread;
+    };
+
+    namespace {
+        void idle(unsigned &spins) {
+            if (spins < KEMPOZER_SCREEN_TRANSFER_SPINS) {
+                ++spins;
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+#else
+    struct TransferWorker::Thread {};
+
+    namespace {
+        [[gnu::always_inline]]
+        inline void idle(unsigned &) {}
+    }
+#endif
+
+    TransferWorker::TransferWorker(Driver &driver, TransferQueue &queue, Drain drain)
+        : mDriver(driver), mQueue(queue) {
+        mThread = nullptr;
+        mDrain = drain;
+        mBatches.store(0, std::memory_order_relaxed);
+        mStalls.store(0, std::memory_order_relaxed);
+    }
+
+    TransferWorker::~TransferWorker() {
+        stop();
+    }
+
+    std::size_t TransferWorker::tryPost(const TransferJob &job) {
+        return mQueue.push(job) ? mQueue.pushed() : 0;
+    }
+
+    std::size_t TransferWorker::post(const TransferJob &job) {
+        std::size_t ticket = tryPost(job);
+        if (ticket) {
+            return ticket;
+        }
+        mStalls.fetch_add(1, std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (!(ticket = tryPost(job))) {
+            wait(spins);
+        }
+        return ticket;
+    }
+
+    TransferWorker *TransferWorker::waitFor(std::size_t ticket) {
+        unsigned spins = 0;
+        while (!done(ticket)) {
+            wait(spins);
+        }
+        return this;
+    }
+
+    std::size_t TransferWorker::process(std::size_t limit) {
+        std::size_t count = 0;
+        const TransferJob *job;
+        while (count < limit && (job = mQueue.front())) {
+            if (count == 0) {
+                mDriver.select();
+            }
+            execute(*job);
+            mQueue.pop();
+            ++count;
+        }
+        if (count) {
+            mDriver.deselect();
+            mBatches.fetch_add(1, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    bool TransferWorker::start() {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (mThread) {
+            return false;
+        }
+        mThread = new Thread();
+        mThread->thread = std::thread([this] {
+            unsigned spins = 0;
+            while (!mThread->stopping.load(std::memory_order_acquire)) {
+                if (process()) {
+                    spins = 0;
+                } else {
+                    idle(spins);
+                }
+            }
+            process();
+        });
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    TransferWorker *TransferWorker::stop() {
+#if KEMPOZER_SCREEN_ENABLE_THREADS
+        if (mThread) {
+            mThread->stopping.store(true, std::memory_order_release);
+            mThread->thread.join();
+            delete mThread;
+            mThread = nullptr;
+        }
+#endif
+        return this;
+    }
+
+    TransferWorker::Statistics TransferWorker::statistics() const {
+        Statistics statistics;
+        statistics.posted = mQueue.pushed();
+        statistics.processed = mQueue.popped();
+        statistics.batches = mBatches.load(std::memory_order_relaxed);
+        statistics.stalls = mStalls.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    void TransferWorker::wait(unsigned &spins) {
+        // Only a producer that declared itself the consumer may pop the
+        // queue, and only while no worker thread is popping it.
+        if (mDrain == Drain::Producer && !mThread) {
+            process(1);
+        } else {
+            idle(spins);
+        }
+    }
+
+    void TransferWorker::execute(const TransferJob &job) {
+        switch (job.kind) {
+            case TransferJob::Kind::Pixels:
+                mDriver.setAddressWindow(job.rect.x1, job.rect.y1, job.rect.x2, job.rect.y2);
+                mDriver.writePixels(job.count, static_cast<const std::uint16_t *>(job.data));
+                break;
+            case TransferJob::Kind::Fill:
+                mDriver.setAddressWindow(job.rect.x1, job.rect.y1, job.rect.x2, job.rect.y2);
+                mDriver.writeRepeatedPixel(job.count, job.color);
+                break;
+            case TransferJob::Kind::Submit:
+                mDriver.submit(job.count, static_cast<const std::uint8_t *>(job.data));
+                break;
+            case TransferJob::Kind::Call:
+                job.function(mDriver, job.context);
+                break;
+        }
+    }
+}
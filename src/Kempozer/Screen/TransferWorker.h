@@ -0,0 +1,215 @@
+/*
+BSD 2-Clause License
+
+Copyright (c) 2024, Bryan
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef __Kempozer_Screen_TransferWorker_h__
+#define __Kempozer_Screen_TransferWorker_h__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "KempozerScreenConfig.h"
+#include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/TransferQueue.h"
+
+namespace Kempozer::Screen {
+
+    /**
+     * The sole owner of a {@link Driver}, which carries out the
+     * {@link TransferJob}s that a renderer posts to its
+     * {@link TransferQueue}.
+     *
+     * The renderer is the producer: it {@link post}s jobs and gets a ticket
+     * for each, which it can later check with {@link done} before reusing
+     * the job's buffer. The consumer calls {@link process}: with
+     * KEMPOZER_SCREEN_ENABLE_THREADS, a thread started by {@link start()};
+     * otherwise the other core's loop or a transfer-complete interrupt
+     * handler. Each call to process() takes every queued job within one
+     * {@link Driver::select()} and {@link Driver::deselect()}.
+     *
+     * When the queue is full, post() applies back-pressure by waiting for
+     * the consumer, and waitFor() waits the same way. By default only the
+     * consumer pops the queue, so a second core or an interrupt handler can
+     * safely call process(). A producer that is also the consumer, such as
+     * a single loop without a worker thread, must say so with
+     * {@link Drain::Producer}; post() and waitFor() then carry out queued
+     * jobs themselves whenever no worker thread is running.
+     */
+    class TransferWorker {
+    public:
+        /**
+         * Who carries out queued jobs when no worker thread is running.
+         */
+        enum class Drain : std::uint8_t {
+            /**
+             * Another core, an interrupt handler or a thread of the
+             * application calls {@link process}; the producer only waits.
+             */
+            External,
+            /**
+             * The producer is the only consumer, and post() and waitFor()
+             * carry out jobs themselves.
+             */
+            Producer,
+        };
+
+        /**
+         * Counts since construction. posted and processed are in jobs,
+         * batches counts the calls to process() that found work, and stalls
+         * counts the times post() found the queue full.
+         */
+        struct Statistics {
+            std::size_t posted;
+            std::size_t processed;
+            std::size_t batches;
+            std::size_t stalls;
+        };
+
+        /**
+         * Creates a worker that owns driver and takes jobs from queue. Both
+         * must outlive the worker, and nothing else may use the driver while
+         * the worker exists.
+         *
+         * @param driver
+         * @param queue
+         * @param drain
+         */
+        TransferWorker(Driver &driver, TransferQueue &queue, Drain drain = Drain::External);
+
+        /**
+         * Stops the worker thread, if any, once every queued job is done.
+         */
+        ~TransferWorker();
+
+        TransferWorker(const TransferWorker &) = delete;
+
+        TransferWorker &operator=(const TransferWorker &) = delete;
+
+        /**
+         * Queues a job if there is room for it. Producer only.
+         *
+         * @param job
+         * @return The job's ticket, or 0 when the queue is full.
+         */
+        std::size_t tryPost(const TransferJob &job);
+
+        /**
+         * Queues a job, waiting for room as described above. Producer only.
+         *
+         * @param job
+         * @return The job's ticket.
+         */
+        std::size_t post(const TransferJob &job);
+
+        /**
+         * Gets whether or not the job with the given ticket, and every job
+         * posted before it, is done.
+         *
+         * @param ticket
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool done(std::size_t ticket) const {
+            return std::ptrdiff_t(mQueue.popped() - ticket) >= 0;
+        }
+
+        /**
+         * Waits until the job with the given ticket is done, carrying out
+         * jobs itself with {@link Drain::Producer} when no worker thread is
+         * running. Producer only.
+         *
+         * @param ticket
+         */
+        TransferWorker *waitFor(std::size_t ticket);
+
+        /**
+         * Waits until every posted job is done. Producer only.
+         */
+        [[gnu::always_inline]]
+        inline TransferWorker *flush() {
+            return waitFor(mQueue.pushed());
+        }
+
+        /**
+         * Carries out at most limit queued jobs. Consumer only.
+         *
+         * @param limit
+         * @return The number of jobs carried out.
+         */
+        std::size_t process(std::size_t limit = SIZE_MAX);
+
+        /**
+         * Starts a thread that calls {@link process} whenever jobs are
+         * queued. The thread must then be the only consumer. When the queue
+         * stays empty for
+         * KEMPOZER_SCREEN_TRANSFER_SPINS polls, the thread sleeps briefly
+         * between polls.
+         *
+         * @return Whether a thread was started: false if one is already
+         *         running or threads are disabled.
+         */
+        bool start();
+
+        /**
+         * Stops the worker thread once every queued job is done.
+         */
+        TransferWorker *stop();
+
+        /**
+         * Gets whether or not a worker thread is running.
+         *
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool running() const {
+            return mThread != nullptr;
+        }
+
+        /**
+         * Gets a snapshot of the statistics of this worker.
+         *
+         * @return
+         */
+        Statistics statistics() const;
+    private:
+        struct Thread;
+
+        void execute(const TransferJob &job);
+
+        void wait(unsigned &spins);
+
+        Driver &mDriver;
+        TransferQueue &mQueue;
+        Thread *mThread;
+        Drain mDrain;
+        std::atomic<std::size_t> mBatches;
+        std::atomic<std::size_t> mStalls;
+    };
+}
+
+#endif//__Kempozer_Screen_TransferWorker_h__
@@ -28,6 +28,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __Kempozer_Screen_Types_h__
 #define __Kempozer_Screen_Types_h__
 
+#include <cstddef>
+#include <cstdint>
 #include "KempozerScreenConfig.h"
 
 #if defined(KEMPOZER_SCREEN_ENABLE_STRUCT_PACKING) && KEMPOZER_SCREEN_ENABLE_STRUCT_PACKING
@@ -40,4 +42,86 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #endif//defined(KEMPOZER_SCREEN_ENABLE_STRUCT_PACKING) && KEMPOZER_SCREEN_ENABLE_STRUCT_PACKING
 
+namespace Kempozer::Screen {
+
+    /**
+     * The order in which the bytes of multi-byte values travel over the bus.
+     */
+    enum class ByteOrder : std::uint8_t {
+        LittleEndian,
+        BigEndian,
+    };
+
+    /**
+     * A rectangle of screen coordinates. Both corners are inclusive, matching
+     * {@link Driver::setAddressWindow}.
+     */
+    ks_packed_struct Rect {
+        std::uint16_t x1, y1, x2, y2;
+
+        [[gnu::always_inline]]
+        inline std::uint16_t width() const {
+            return x2 - x1 + 1;
+        }
+
+        [[gnu::always_inline]]
+        inline std::uint16_t height() const {
+            return y2 - y1 + 1;
+        }
+
+        [[gnu::always_inline]]
+        inline std::size_t area() const {
+            return std::size_t(width()) * height();
+        }
+
+        /**
+         * Gets whether this rectangle shares at least one pixel with other.
+         *
+         * @param other
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline bool intersects(const Rect &other) const {
+            return x1 <= other.x2 && other.x1 <= x2 && y1 <= other.y2 && other.y1 <= y2;
+        }
+
+        /**
+         * Gets the smallest rectangle containing both this rectangle and other.
+         *
+         * @param other
+         * @return
+         */
+        [[gnu::always_inline]]
+        inline Rect united(const Rect &other) const {
+            return Rect{
+                x1 < other.x1 ? x1 : other.x1,
+                y1 < other.y1 ? y1 : other.y1,
+                x2 > other.x2 ? x2 : other.x2,
+                y2 > other.y2 ? y2 : other.y2,
+            };
+        }
+
+        /**
+         * Clips this rectangle to a width by height screen.
+         *
+         * @param width
+         * @param height
+         * @return Whether any of this rectangle remains on screen.
+         */
+        [[gnu::always_inline]]
+        inline bool clip(std::uint16_t width, std::uint16_t height) {
+            if (x1 > x2 || y1 > y2 || x1 >= width || y1 >= height) {
+                return false;
+            }
+            if (x2 >= width) {
+                x2 = width - 1;
+            }
+            if (y2 >= height) {
+                y2 = height - 1;
+            }
+            return true;
+        }
+    };
+}
+
 #endif//__Kempozer_Screen_Types_h__
@@ -29,5 +29,32 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __KempozerScreen_h__
 
 #include "Kempozer/Screen/Driver.h"
+#include "Kempozer/Screen/Blit.h"
+#include "Kempozer/Screen/Canvas.h"
+#include "Kempozer/Screen/ColorConversion.h"
+#include "Kempozer/Screen/CommandBuffer.h"
+#include "Kempozer/Screen/CompositeDriver.h"
+#include "Kempozer/Screen/CompressedImage.h"
+#include "Kempozer/Screen/DirtyRegionTracker.h"
+#include "Kempozer/Screen/DisplayList.h"
+#include "Kempozer/Screen/Font.h"
+#include "Kempozer/Screen/FramePlayer.h"
+#include "Kempozer/Screen/FrameStream.h"
+#include "Kempozer/Screen/GlyphCache.h"
+#include "Kempozer/Screen/InitSequence.h"
+#include "Kempozer/Screen/InstrumentedDriver.h"
+#include "Kempozer/Screen/MemoryDriver.h"
+#include "Kempozer/Screen/PixelDoubleBuffer.h"
+#include "Kempozer/Screen/PixelFormat.h"
+#include "Kempozer/Screen/PresentationScheduler.h"
+#include "Kempozer/Screen/RegionSet.h"
+#include "Kempozer/Screen/ScrollingTextArea.h"
+#include "Kempozer/Screen/StaticDriver.h"
+#include "Kempozer/Screen/TiledRenderer.h"
+#include "Kempozer/Screen/TraceDriver.h"
+#include "Kempozer/Screen/TraceReplayer.h"
+#include "Kempozer/Screen/TransferQueue.h"
+#include "Kempozer/Screen/TransferWorker.h"
+#include "Kempozer/Screen/Types.h"
 
 #endif//__KempozerScreen_h__
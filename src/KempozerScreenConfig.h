@@ -36,4 +36,96 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define KEMPOZER_SCREEN_HX8357_READ_DELAY (55)
 
+#ifndef KEMPOZER_SCREEN_WIRE_BYTE_ORDER
+
+#define KEMPOZER_SCREEN_WIRE_BYTE_ORDER (::Kempozer::Screen::ByteOrder::LittleEndian)
+
+#endif//KEMPOZER_SCREEN_WIRE_BYTE_ORDER
+
+#ifndef KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK
+
+#define KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK (32)
+
+#endif//KEMPOZER_SCREEN_REPEATED_PIXEL_CHUNK
+
+#ifndef KEMPOZER_SCREEN_CONVERSION_CHUNK
+
+#define KEMPOZER_SCREEN_CONVERSION_CHUNK (64)
+
+#endif//KEMPOZER_SCREEN_CONVERSION_CHUNK
+
+#ifndef KEMPOZER_SCREEN_ENABLE_SIMD
+
+#define KEMPOZER_SCREEN_ENABLE_SIMD (1)
+
+#endif//KEMPOZER_SCREEN_ENABLE_SIMD
+
+#ifndef KEMPOZER_SCREEN_MAX_DIRTY_REGIONS
+
+#define KEMPOZER_SCREEN_MAX_DIRTY_REGIONS (16)
+
+#endif//KEMPOZER_SCREEN_MAX_DIRTY_REGIONS
+
+#ifndef KEMPOZER_SCREEN_BLIT_BLOCK
+
+#define KEMPOZER_SCREEN_BLIT_BLOCK (32)
+
+#endif//KEMPOZER_SCREEN_BLIT_BLOCK
+
+#ifndef KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+
+#define KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION (1)
+
+#endif//KEMPOZER_SCREEN_ENABLE_INSTRUMENTATION
+
+#ifndef KEMPOZER_SCREEN_ENABLE_THREADS
+
+#if defined(ARDUINO)
+#define KEMPOZER_SCREEN_ENABLE_THREADS (0)
+#else
+#define KEMPOZER_SCREEN_ENABLE_THREADS (1)
+#endif//defined(ARDUINO)
+
+#endif//KEMPOZER_SCREEN_ENABLE_THREADS
+
+#ifndef KEMPOZER_SCREEN_COMPOSITE_PARALLEL_PIXELS
+
+#define KEMPOZER_SCREEN_COMPOSITE_PARALLEL_PIXELS (4096)
+
+#endif//KEMPOZER_SCREEN_COMPOSITE_PARALLEL_PIXELS
+
+#ifndef KEMPOZER_SCREEN_PRESENTATION_MIN_SAMPLE
+
+#define KEMPOZER_SCREEN_PRESENTATION_MIN_SAMPLE (256)
+
+#endif//KEMPOZER_SCREEN_PRESENTATION_MIN_SAMPLE
+
+#ifndef KEMPOZER_SCREEN_PRESENTATION_MARGIN
+
+#define KEMPOZER_SCREEN_PRESENTATION_MARGIN (10)
+
+#endif//KEMPOZER_SCREEN_PRESENTATION_MARGIN
+
+#ifndef KEMPOZER_SCREEN_TRACE_PAYLOAD
+
+#define KEMPOZER_SCREEN_TRACE_PAYLOAD (64)
+
+#endif//KEMPOZER_SCREEN_TRACE_PAYLOAD
+
+#ifndef KEMPOZER_SCREEN_CACHE_LINE
+
+#if defined(ARDUINO)
+#define KEMPOZER_SCREEN_CACHE_LINE (4)
+#else
+#define KEMPOZER_SCREEN_CACHE_LINE (64)
+#endif//defined(ARDUINO)
+
+#endif//KEMPOZER_SCREEN_CACHE_LINE
+
+#ifndef KEMPOZER_SCREEN_TRANSFER_SPINS
+
+#define KEMPOZER_SCREEN_TRANSFER_SPINS (64)
+
+#endif//KEMPOZER_SCREEN_TRANSFER_SPINS
+
 #endif//__KempozerScreenConfig_h__